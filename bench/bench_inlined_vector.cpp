@@ -2,6 +2,16 @@
 #include <vector>
 #include <string>
 #include <memory> // For std::unique_ptr
+#include <memory_resource>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <limits>
+#include <cstdlib>
+#include <new>
+#include <cstring>
 
 // The competitors
 #include "inlined_vector.hpp" // Your v5.7+
@@ -23,6 +33,58 @@ static TrivialType g_trivial_val = 42;
 static ComplexType g_complex_val = "hello world a longer string";
 static auto g_move_val = [] { return std::make_unique<int>(42); };
 
+// --- Allocation Accounting Scope ---
+// The counting operator new (see "Allocation Accounting" at the end) only
+// counts during the memory pass, and only inside the timed loop. Benchmarks
+// iterate with `for (auto _ : Measured(state))` and pause with
+// PauseMeasurement/ResumeMeasurement. Setup outside the loop, or done while
+// timing is paused, is excluded from allocs/op and bytes/op.
+namespace {
+std::atomic<bool> g_memory_pass{false};
+std::atomic<bool> g_count_allocs{false};
+
+class Measured {
+public:
+    explicit Measured(benchmark::State& state) noexcept : state_(state) {}
+
+    class iterator {
+    public:
+        explicit iterator(benchmark::State::StateIterator it) : it_(it) {}
+        auto operator*() const { return *it_; }
+        iterator& operator++() { ++it_; return *this; }
+        bool operator!=(const iterator& end) const {
+            if (it_ != end.it_) return true;
+            g_count_allocs.store(false, std::memory_order_relaxed);
+            return false;
+        }
+
+    private:
+        benchmark::State::StateIterator it_;
+    };
+
+    iterator begin() { return iterator(state_.begin()); }
+    // Range-for evaluates end() after begin(). State::end() starts the timer.
+    iterator end() {
+        iterator it(state_.end());
+        g_count_allocs.store(g_memory_pass.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return it;
+    }
+
+private:
+    benchmark::State& state_;
+};
+
+void PauseMeasurement(benchmark::State& state) {
+    g_count_allocs.store(false, std::memory_order_relaxed);
+    state.PauseTiming();
+}
+
+void ResumeMeasurement(benchmark::State& state) {
+    state.ResumeTiming();
+    g_count_allocs.store(g_memory_pass.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+} // namespace
+
 // --- Simple Benchmark Allocator ---
 // (Minimal overhead, no tracking, stateful via ID)
 template <typename T> struct BenchAllocator {
@@ -53,7 +115,7 @@ template <typename T> struct BenchAllocator {
 template <typename VecType>
 static void BM_Fill_Trivial(benchmark::State& state) {
     const size_t n = state.range(0);
-    for (auto _ : state) {
+    for (auto _ : Measured(state)) {
         VecType vec;
         for (size_t i = 0; i < n; ++i) {
             vec.push_back(g_trivial_val);
@@ -70,7 +132,7 @@ BENCHMARK_TEMPLATE(BM_Fill_Trivial, boost::container::small_vector<TrivialType,
 template <typename VecType>
 static void BM_Fill_Complex(benchmark::State& state) {
     const size_t n = state.range(0);
-    for (auto _ : state) {
+    for (auto _ : Measured(state)) {
         VecType vec;
         for (size_t i = 0; i < n; ++i) {
             vec.push_back(g_complex_val);
@@ -88,7 +150,7 @@ template <typename VecType>
 static void BM_Fill_Complex_Alloc(benchmark::State& state) {
     const size_t n = state.range(0);
     BenchAllocator<ComplexType> alloc(1); // Create allocator instance
-    for (auto _ : state) {
+    for (auto _ : Measured(state)) {
         VecType vec(alloc); // Construct with allocator
         for (size_t i = 0; i < n; ++i) {
             vec.push_back(g_complex_val);
@@ -108,7 +170,7 @@ BENCHMARK_TEMPLATE(BM_Fill_Complex_Alloc, lloyal::InlinedVector<ComplexType, kIn
 template <typename VecType>
 static void BM_Reserve(benchmark::State& state) {
     const size_t n = state.range(0);
-    for (auto _ : state) {
+    for (auto _ : Measured(state)) {
         VecType vec;
         benchmark::DoNotOptimize(vec.data());
         vec.reserve(n);
@@ -124,17 +186,15 @@ BENCHMARK_TEMPLATE(BM_Reserve, boost::container::small_vector<TrivialType, kInli
 // BENCHMARK 3: Copy Construction
 // =========================================================================
 
-// NOTE: Previous runs showed potential timer issues with this benchmark across all types.
-// Keeping it for comparison, but results may need scrutiny.
+// Setup outside the loop is untimed; PauseTiming() is only valid inside it
+// (calling it here tripped Google Benchmark's timer checks).
 template <typename VecType>
 static void BM_CopyConstruct(benchmark::State& state) {
     const size_t n = state.range(0);
-    state.PauseTiming();
     VecType source_vec;
     for(size_t i = 0; i < n; ++i) source_vec.push_back(g_complex_val);
-    state.ResumeTiming();
 
-    for (auto _ : state) {
+    for (auto _ : Measured(state)) {
         VecType copy_vec(source_vec);
         benchmark::ClobberMemory();
     }
@@ -143,6 +203,11 @@ BENCHMARK_TEMPLATE(BM_CopyConstruct, std::vector<ComplexType>)->Range(1, 128);
 BENCHMARK_TEMPLATE(BM_CopyConstruct, lloyal::InlinedVector<ComplexType, kInlineCapacity>)->Range(1, 128);
 BENCHMARK_TEMPLATE(BM_CopyConstruct, absl::InlinedVector<ComplexType, kInlineCapacity>)->Range(1, 128);
 BENCHMARK_TEMPLATE(BM_CopyConstruct, boost::container::small_vector<ComplexType, kInlineCapacity>)->Range(1, 128);
+BENCHMARK_TEMPLATE(BM_CopyConstruct, lloyal::CowInlinedVector<ComplexType, kInlineCapacity>)->Range(1, 128);
+// Large spilled sources (config/routing snapshots): deep copies are O(n), CowInlinedVector is O(1)
+BENCHMARK_TEMPLATE(BM_CopyConstruct, std::vector<ComplexType>)->Arg(1 << 10)->Arg(1 << 14);
+BENCHMARK_TEMPLATE(BM_CopyConstruct, lloyal::InlinedVector<ComplexType, kInlineCapacity>)->Arg(1 << 10)->Arg(1 << 14);
+BENCHMARK_TEMPLATE(BM_CopyConstruct, lloyal::CowInlinedVector<ComplexType, kInlineCapacity>)->Arg(1 << 10)->Arg(1 << 14);
 
 // =========================================================================
 // BENCHMARK 4: Move Construction
@@ -151,11 +216,11 @@ BENCHMARK_TEMPLATE(BM_CopyConstruct, boost::container::small_vector<ComplexType,
 template <typename VecType>
 static void BM_MoveConstruct(benchmark::State& state) {
     const size_t n = state.range(0);
-    for (auto _ : state) {
-        state.PauseTiming();
+    for (auto _ : Measured(state)) {
+        PauseMeasurement(state);
         VecType source_vec;
         for(size_t i = 0; i < n; ++i) source_vec.push_back(g_complex_val);
-        state.ResumeTiming();
+        ResumeMeasurement(state);
 
         VecType move_vec(std::move(source_vec));
         benchmark::ClobberMemory();
@@ -171,11 +236,11 @@ template <typename VecType>
 static void BM_MoveConstruct_Alloc(benchmark::State& state) {
     const size_t n = state.range(0);
     BenchAllocator<ComplexType> alloc(1);
-    for (auto _ : state) {
-        state.PauseTiming();
+    for (auto _ : Measured(state)) {
+        PauseMeasurement(state);
         VecType source_vec(alloc);
         for(size_t i = 0; i < n; ++i) source_vec.push_back(g_complex_val);
-        state.ResumeTiming();
+        ResumeMeasurement(state);
 
         VecType move_vec(std::move(source_vec)); // Allocator should propagate (POCMA=true)
         benchmark::ClobberMemory();
@@ -193,11 +258,11 @@ BENCHMARK_TEMPLATE(BM_MoveConstruct_Alloc, lloyal::InlinedVector<ComplexType, kI
 template <typename VecType>
 static void BM_InsertFront_Trivial(benchmark::State& state) {
     const size_t n = state.range(0);
-    for (auto _ : state) {
-        state.PauseTiming();
+    for (auto _ : Measured(state)) {
+        PauseMeasurement(state);
         VecType vec;
         for(size_t i = 0; i < n; ++i) vec.push_back(g_trivial_val);
-        state.ResumeTiming();
+        ResumeMeasurement(state);
         
         vec.insert(vec.begin(), g_trivial_val);
         benchmark::ClobberMemory();
@@ -212,11 +277,11 @@ BENCHMARK_TEMPLATE(BM_InsertFront_Trivial, boost::container::small_vector<Trivia
 template <typename VecType>
 static void BM_InsertFront_Complex(benchmark::State& state) {
     const size_t n = state.range(0);
-    for (auto _ : state) {
-        state.PauseTiming();
+    for (auto _ : Measured(state)) {
+        PauseMeasurement(state);
         VecType vec;
         for(size_t i = 0; i < n; ++i) vec.push_back(g_complex_val);
-        state.ResumeTiming();
+        ResumeMeasurement(state);
         
         vec.insert(vec.begin(), g_complex_val);
         benchmark::ClobberMemory();
@@ -232,11 +297,11 @@ template <typename VecType>
 static void BM_InsertFront_Complex_Alloc(benchmark::State& state) {
     const size_t n = state.range(0);
     BenchAllocator<ComplexType> alloc(1);
-    for (auto _ : state) {
-        state.PauseTiming();
+    for (auto _ : Measured(state)) {
+        PauseMeasurement(state);
         VecType vec(alloc);
         for(size_t i = 0; i < n; ++i) vec.push_back(g_complex_val);
-        state.ResumeTiming();
+        ResumeMeasurement(state);
 
         vec.insert(vec.begin(), g_complex_val);
         benchmark::ClobberMemory();
@@ -249,11 +314,11 @@ BENCHMARK_TEMPLATE(BM_InsertFront_Complex_Alloc, lloyal::InlinedVector<ComplexTy
 template <typename VecType>
 static void BM_InsertFront_MoveOnly(benchmark::State& state) {
     const size_t n = state.range(0);
-    for (auto _ : state) {
-        state.PauseTiming();
+    for (auto _ : Measured(state)) {
+        PauseMeasurement(state);
         VecType vec;
         for(size_t i = 0; i < n; ++i) vec.push_back(g_move_val());
-        state.ResumeTiming();
+        ResumeMeasurement(state);
         
         vec.insert(vec.begin(), g_move_val());
         benchmark::ClobberMemory();
@@ -272,11 +337,11 @@ BENCHMARK_TEMPLATE(BM_InsertFront_MoveOnly, boost::container::small_vector<MoveO
 template <typename VecType>
 static void BM_EraseFront_Trivial(benchmark::State& state) {
     const size_t n = state.range(0);
-    for (auto _ : state) {
-        state.PauseTiming();
+    for (auto _ : Measured(state)) {
+        PauseMeasurement(state);
         VecType vec;
         for(size_t i = 0; i < n; ++i) vec.push_back(g_trivial_val);
-        state.ResumeTiming();
+        ResumeMeasurement(state);
         
         if (!vec.empty()) {
             vec.erase(vec.begin());
@@ -293,11 +358,11 @@ BENCHMARK_TEMPLATE(BM_EraseFront_Trivial, boost::container::small_vector<Trivial
 template <typename VecType>
 static void BM_EraseFront_Complex(benchmark::State& state) {
     const size_t n = state.range(0);
-    for (auto _ : state) {
-        state.PauseTiming();
+    for (auto _ : Measured(state)) {
+        PauseMeasurement(state);
         VecType vec;
         for(size_t i = 0; i < n; ++i) vec.push_back(g_complex_val);
-        state.ResumeTiming();
+        ResumeMeasurement(state);
         
         if (!vec.empty()) {
             vec.erase(vec.begin());
@@ -326,20 +391,36 @@ struct NonAssignable {
 template <typename VecType>
 static void BM_InsertFront_NonAssignable(benchmark::State& state) {
     const size_t n = state.range(0); // Test both inline and heap
-    for (auto _ : state) {
-        state.PauseTiming();
+    for (auto _ : Measured(state)) {
+        PauseMeasurement(state);
         VecType vec;
         for(size_t i = 0; i < n; ++i) vec.emplace_back(i); // Use emplace_back
-        state.ResumeTiming();
+        ResumeMeasurement(state);
         
         vec.insert(vec.begin(), NonAssignable(42));
         benchmark::ClobberMemory();
     }
 }
 
-// ** FIX: Run for both inline (N/2) and heap (N+1) sizes **
+// Run for both inline (N/2) and heap (N+1, N*8) sizes
 BENCHMARK_TEMPLATE(BM_InsertFront_NonAssignable, lloyal::InlinedVector<NonAssignable, kInlineCapacity>)
-    ->Ranges({{kInlineCapacity / 2, kInlineCapacity / 2}, {kInlineCapacity + 1, kInlineCapacity + 1}});
+    ->Arg(kInlineCapacity / 2)->Arg(kInlineCapacity + 1)->Arg(kInlineCapacity * 8);
+
+template <typename VecType>
+static void BM_EraseFront_NonAssignable(benchmark::State& state) {
+    const size_t n = state.range(0);
+    for (auto _ : Measured(state)) {
+        PauseMeasurement(state);
+        VecType vec;
+        for(size_t i = 0; i < n; ++i) vec.emplace_back(i);
+        ResumeMeasurement(state);
+
+        vec.erase(vec.begin());
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK_TEMPLATE(BM_EraseFront_NonAssignable, lloyal::InlinedVector<NonAssignable, kInlineCapacity>)
+    ->Arg(kInlineCapacity / 2)->Arg(kInlineCapacity + 1)->Arg(kInlineCapacity * 8);
 
 // (Other implementations still commented out as they won't compile)
 
@@ -353,12 +434,12 @@ static void BM_ShrinkToFit(benchmark::State& state) {
     const size_t start_size = kInlineCapacity + 5;
     const size_t end_size = kInlineCapacity / 2;
 
-    for (auto _ : state) {
-        state.PauseTiming();
+    for (auto _ : Measured(state)) {
+        PauseMeasurement(state);
         VecType vec;
         for(size_t i = 0; i < start_size; ++i) vec.push_back(g_complex_val);
         vec.resize(end_size); // Resize down while still on heap
-        state.ResumeTiming();
+        ResumeMeasurement(state);
 
         vec.shrink_to_fit(); // The operation to measure
         benchmark::ClobberMemory();
@@ -369,6 +450,1309 @@ BENCHMARK_TEMPLATE(BM_ShrinkToFit, std::vector<ComplexType>);
 BENCHMARK_TEMPLATE(BM_ShrinkToFit, lloyal::InlinedVector<ComplexType, kInlineCapacity>);
 // Note: absl/boost do not transition back to inline, so their shrink_to_fit is different
 
+// =========================================================================
+// BENCHMARK 9: Multi-Threaded Churn (Allocator Contention)
+// =========================================================================
+
+// Sizes straddle the inline capacity: half stay inline, half spill
+constexpr std::array<size_t, 6> kChurnSizes = {
+    kInlineCapacity / 4, kInlineCapacity / 2, kInlineCapacity - 1,
+    kInlineCapacity, kInlineCapacity + 1, kInlineCapacity * 2};
+
+static const int kMaxThreads =
+    static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+// items_per_second is the aggregate rate across threads (UseRealTime).
+// "efficiency" is the per-thread rate relative to the 1-thread run of the
+// same benchmark: 1.0 is perfect scaling, lower means threads serialize.
+static void ReportScaling(benchmark::State& state, std::atomic<double>& single_thread_rate,
+                          std::chrono::steady_clock::time_point start) {
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const double rate = static_cast<double>(state.iterations()) / elapsed.count();
+    if (state.threads() == 1) single_thread_rate.store(rate);
+    const double baseline = single_thread_rate.load();
+    state.SetItemsProcessed(state.iterations());
+    state.counters["efficiency"] =
+        benchmark::Counter(baseline > 0 ? rate / baseline : 0.0, benchmark::Counter::kAvgThreads);
+}
+
+template <typename VecType>
+static void BM_Churn_MT(benchmark::State& state) {
+    static std::atomic<double> single_thread_rate{0.0};
+    size_t k = state.thread_index();
+    const auto start = std::chrono::steady_clock::now();
+    for (auto _ : Measured(state)) {
+        VecType vec;
+        const size_t n = kChurnSizes[k++ % kChurnSizes.size()];
+        for (size_t i = 0; i < n; ++i) vec.push_back(g_trivial_val);
+        benchmark::DoNotOptimize(vec.data());
+    }
+    ReportScaling(state, single_thread_rate, start);
+}
+BENCHMARK_TEMPLATE(BM_Churn_MT, std::vector<TrivialType>)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Churn_MT, lloyal::InlinedVector<TrivialType, kInlineCapacity>)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Churn_MT, absl::InlinedVector<TrivialType, kInlineCapacity>)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Churn_MT, boost::container::small_vector<TrivialType, kInlineCapacity>)->ThreadRange(1, kMaxThreads)->UseRealTime();
+
+// --- Per-thread pmr pool: spills never reach the global allocator ---
+using PmrAlloc = std::pmr::polymorphic_allocator<TrivialType>;
+
+template <typename VecType>
+static void BM_Churn_MT_Pmr(benchmark::State& state) {
+    static std::atomic<double> single_thread_rate{0.0};
+    std::pmr::unsynchronized_pool_resource pool; // One per benchmark thread
+    size_t k = state.thread_index();
+    const auto start = std::chrono::steady_clock::now();
+    for (auto _ : Measured(state)) {
+        VecType vec{typename VecType::allocator_type(PmrAlloc(&pool))};
+        const size_t n = kChurnSizes[k++ % kChurnSizes.size()];
+        for (size_t i = 0; i < n; ++i) vec.push_back(g_trivial_val);
+        benchmark::DoNotOptimize(vec.data());
+    }
+    ReportScaling(state, single_thread_rate, start);
+}
+BENCHMARK_TEMPLATE(BM_Churn_MT_Pmr, std::pmr::vector<TrivialType>)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Churn_MT_Pmr, lloyal::InlinedVector<TrivialType, kInlineCapacity, PmrAlloc>)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Churn_MT_Pmr, absl::InlinedVector<TrivialType, kInlineCapacity, PmrAlloc>)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Churn_MT_Pmr, boost::container::small_vector<TrivialType, kInlineCapacity, PmrAlloc>)->ThreadRange(1, kMaxThreads)->UseRealTime();
+
+// =========================================================================
+// BENCHMARK 10: Tail Latency (Spill and Growth Events)
+// =========================================================================
+
+// Each operation in a sequence is timed individually; the counters report
+// the distribution across all iterations in nanoseconds (timer overhead
+// subtracted). Averages hide the one push_back that crosses N or triggers a
+// reallocation; p99/p99.9/max do not.
+class LatencyRecorder {
+public:
+    explicit LatencyRecorder(size_t expected) { samples_.reserve(expected); }
+
+    template <typename F>
+    void time(F&& op) {
+        const auto t0 = std::chrono::steady_clock::now();
+        op();
+        const auto t1 = std::chrono::steady_clock::now();
+        samples_.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    }
+
+    void report(benchmark::State& state) {
+        if (samples_.empty()) return;
+        const int64_t overhead = timer_overhead();
+        for (auto& s : samples_) s = std::max<int64_t>(0, s - overhead);
+        state.counters["p50"] = percentile(0.50);
+        state.counters["p99"] = percentile(0.99);
+        state.counters["p99.9"] = percentile(0.999);
+        state.counters["max"] = static_cast<double>(*std::max_element(samples_.begin(), samples_.end()));
+    }
+
+private:
+    double percentile(double p) {
+        const size_t k = std::min(samples_.size() - 1, static_cast<size_t>(p * samples_.size()));
+        std::nth_element(samples_.begin(), samples_.begin() + k, samples_.end());
+        return static_cast<double>(samples_[k]);
+    }
+
+    static int64_t timer_overhead() {
+        static const int64_t overhead = [] {
+            int64_t best = std::numeric_limits<int64_t>::max();
+            for (int i = 0; i < 1000; ++i) {
+                const auto t0 = std::chrono::steady_clock::now();
+                const auto t1 = std::chrono::steady_clock::now();
+                best = std::min<int64_t>(best, std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+            }
+            return best;
+        }();
+        return overhead;
+    }
+
+    std::vector<int64_t> samples_;
+};
+
+// Fixed repetition count so every container is measured on the same sample set
+constexpr int kLatencyRepeats = 20;
+
+// push_back from empty to n: crosses N once, then every heap reallocation
+template <typename VecType>
+static void BM_Latency_PushBack(benchmark::State& state) {
+    const size_t n = state.range(0);
+    LatencyRecorder rec(n * kLatencyRepeats);
+    for (auto _ : Measured(state)) {
+        VecType vec;
+        for (size_t i = 0; i < n; ++i) rec.time([&] { vec.push_back(g_trivial_val); });
+        benchmark::DoNotOptimize(vec.data());
+    }
+    rec.report(state);
+}
+BENCHMARK_TEMPLATE(BM_Latency_PushBack, std::vector<TrivialType>)->Arg(kInlineCapacity * 4)->Arg(100000)->Iterations(kLatencyRepeats);
+BENCHMARK_TEMPLATE(BM_Latency_PushBack, lloyal::InlinedVector<TrivialType, kInlineCapacity>)->Arg(kInlineCapacity * 4)->Arg(100000)->Iterations(kLatencyRepeats);
+BENCHMARK_TEMPLATE(BM_Latency_PushBack, absl::InlinedVector<TrivialType, kInlineCapacity>)->Arg(kInlineCapacity * 4)->Arg(100000)->Iterations(kLatencyRepeats);
+BENCHMARK_TEMPLATE(BM_Latency_PushBack, boost::container::small_vector<TrivialType, kInlineCapacity>)->Arg(kInlineCapacity * 4)->Arg(100000)->Iterations(kLatencyRepeats);
+
+// insert at the front from empty to n (complex type: shifts are not memmove)
+template <typename VecType>
+static void BM_Latency_InsertFront(benchmark::State& state) {
+    const size_t n = state.range(0);
+    LatencyRecorder rec(n * kLatencyRepeats);
+    for (auto _ : Measured(state)) {
+        VecType vec;
+        for (size_t i = 0; i < n; ++i) rec.time([&] { vec.insert(vec.begin(), g_complex_val); });
+        benchmark::DoNotOptimize(vec.data());
+    }
+    rec.report(state);
+}
+BENCHMARK_TEMPLATE(BM_Latency_InsertFront, std::vector<ComplexType>)->Arg(kInlineCapacity * 4)->Iterations(kLatencyRepeats);
+BENCHMARK_TEMPLATE(BM_Latency_InsertFront, lloyal::InlinedVector<ComplexType, kInlineCapacity>)->Arg(kInlineCapacity * 4)->Iterations(kLatencyRepeats);
+BENCHMARK_TEMPLATE(BM_Latency_InsertFront, absl::InlinedVector<ComplexType, kInlineCapacity>)->Arg(kInlineCapacity * 4)->Iterations(kLatencyRepeats);
+BENCHMARK_TEMPLATE(BM_Latency_InsertFront, boost::container::small_vector<ComplexType, kInlineCapacity>)->Arg(kInlineCapacity * 4)->Iterations(kLatencyRepeats);
+
+// shrink_to_fit after trimming a heap vector to every size in [1, n)
+template <typename VecType>
+static void BM_Latency_ShrinkToFit(benchmark::State& state) {
+    const size_t n = state.range(0);
+    LatencyRecorder rec(n * kLatencyRepeats);
+    for (auto _ : Measured(state)) {
+        for (size_t size = 1; size < n; ++size) {
+            VecType vec;
+            for (size_t i = 0; i < n; ++i) vec.push_back(g_complex_val);
+            vec.erase(vec.begin() + size, vec.end());
+            rec.time([&] { vec.shrink_to_fit(); });
+            benchmark::DoNotOptimize(vec.data());
+        }
+    }
+    rec.report(state);
+}
+BENCHMARK_TEMPLATE(BM_Latency_ShrinkToFit, std::vector<ComplexType>)->Arg(kInlineCapacity * 2)->Iterations(kLatencyRepeats);
+BENCHMARK_TEMPLATE(BM_Latency_ShrinkToFit, lloyal::InlinedVector<ComplexType, kInlineCapacity>)->Arg(kInlineCapacity * 2)->Iterations(kLatencyRepeats);
+BENCHMARK_TEMPLATE(BM_Latency_ShrinkToFit, absl::InlinedVector<ComplexType, kInlineCapacity>)->Arg(kInlineCapacity * 2)->Iterations(kLatencyRepeats);
+BENCHMARK_TEMPLATE(BM_Latency_ShrinkToFit, boost::container::small_vector<ComplexType, kInlineCapacity>)->Arg(kInlineCapacity * 2)->Iterations(kLatencyRepeats);
+
+// reserve(i) for i in [1, n] on a full vector: every call past N reallocates
+template <typename VecType>
+static void BM_Latency_Reserve(benchmark::State& state) {
+    const size_t n = state.range(0);
+    LatencyRecorder rec(n * kLatencyRepeats);
+    for (auto _ : Measured(state)) {
+        VecType vec;
+        for (size_t i = 1; i <= n; ++i) {
+            vec.push_back(g_complex_val);
+            rec.time([&] { vec.reserve(i + 1); });
+        }
+        benchmark::DoNotOptimize(vec.data());
+    }
+    rec.report(state);
+}
+BENCHMARK_TEMPLATE(BM_Latency_Reserve, std::vector<ComplexType>)->Arg(kInlineCapacity * 4)->Iterations(kLatencyRepeats);
+BENCHMARK_TEMPLATE(BM_Latency_Reserve, lloyal::InlinedVector<ComplexType, kInlineCapacity>)->Arg(kInlineCapacity * 4)->Iterations(kLatencyRepeats);
+BENCHMARK_TEMPLATE(BM_Latency_Reserve, absl::InlinedVector<ComplexType, kInlineCapacity>)->Arg(kInlineCapacity * 4)->Iterations(kLatencyRepeats);
+BENCHMARK_TEMPLATE(BM_Latency_Reserve, boost::container::small_vector<ComplexType, kInlineCapacity>)->Arg(kInlineCapacity * 4)->Iterations(kLatencyRepeats);
+
+// =========================================================================
+// BENCHMARK 11: Small Sorts (Sorting Network vs std::sort)
+// =========================================================================
+
+constexpr size_t kSortCapacity = 64;
+
+// A fixed pool of random inputs, cycled so the branch predictor cannot learn one
+template <typename T>
+static const std::vector<T>& SortInputs() {
+    static const std::vector<T> inputs = [] {
+        std::vector<T> v(kSortCapacity * 1024);
+        uint32_t x = 0x9e3779b9u;
+        for (auto& e : v) { x ^= x << 13; x ^= x >> 17; x ^= x << 5; e = static_cast<T>(x % 100000); }
+        return v;
+    }();
+    return inputs;
+}
+
+template <typename T, bool UseNetwork>
+static void BM_Sort(benchmark::State& state) {
+    const size_t n = state.range(0);
+    const auto& inputs = SortInputs<T>();
+    lloyal::InlinedVector<T, kSortCapacity> vec(n, T{});
+    size_t offset = 0;
+    for (auto _ : Measured(state)) {
+        std::copy_n(inputs.begin() + offset, n, vec.begin());
+        offset = (offset + n) % (inputs.size() - n);
+        if constexpr (UseNetwork) lloyal::sort(vec);
+        else std::sort(vec.begin(), vec.end());
+        benchmark::DoNotOptimize(vec.data());
+    }
+}
+BENCHMARK_TEMPLATE(BM_Sort, int, false)->DenseRange(2, 16, 2)->Arg(24)->Arg(32)->Arg(48)->Arg(64)->Arg(128);
+BENCHMARK_TEMPLATE(BM_Sort, int, true)->DenseRange(2, 16, 2)->Arg(24)->Arg(32)->Arg(48)->Arg(64)->Arg(128);
+BENCHMARK_TEMPLATE(BM_Sort, float, false)->DenseRange(2, 16, 2)->Arg(24)->Arg(32)->Arg(48)->Arg(64)->Arg(128);
+BENCHMARK_TEMPLATE(BM_Sort, float, true)->DenseRange(2, 16, 2)->Arg(24)->Arg(32)->Arg(48)->Arg(64)->Arg(128);
+
+// =========================================================================
+// BENCHMARK 12: Sorting Non-Assignable Types (Relocation vs Rebuild)
+// =========================================================================
+
+// The pre-existing workaround: sort (key, index) pairs, copy into a new
+// container in order, then swap it in
+template <typename VecType>
+static void SortByRebuild(VecType& vec) {
+    std::vector<std::pair<int, size_t>> keyed;
+    keyed.reserve(vec.size());
+    for (size_t i = 0; i < vec.size(); ++i) keyed.emplace_back(vec[i].val, i);
+    std::sort(keyed.begin(), keyed.end());
+    VecType rebuilt;
+    rebuilt.reserve(vec.size());
+    for (const auto& [key, idx] : keyed) rebuilt.emplace_back(vec[idx]);
+    vec.swap(rebuilt);
+}
+
+template <typename VecType, bool UseRelocation>
+static void BM_Sort_NonAssignable(benchmark::State& state) {
+    const size_t n = state.range(0);
+    // Unsorted sources, copied in the timed region (cheaper and less noisy
+    // than PauseTiming); the copy costs the same for both variants
+    const auto& keys = SortInputs<int>();
+    std::vector<VecType> sources(64);
+    for (size_t s = 0; s < sources.size(); ++s)
+        for (size_t i = 0; i < n; ++i) sources[s].emplace_back(keys[(s * n + i) % keys.size()]);
+    size_t next = 0;
+    for (auto _ : Measured(state)) {
+        VecType vec(sources[next++ % sources.size()]);
+        if constexpr (UseRelocation) {
+            lloyal::sort(vec, [](const NonAssignable& a, const NonAssignable& b) { return a.val < b.val; });
+        } else {
+            SortByRebuild(vec);
+        }
+        benchmark::DoNotOptimize(vec.data());
+    }
+}
+BENCHMARK_TEMPLATE(BM_Sort_NonAssignable, lloyal::InlinedVector<NonAssignable, kInlineCapacity>, false)
+    ->Arg(kInlineCapacity / 2)->Arg(kInlineCapacity + 1)->Arg(kInlineCapacity * 8);
+BENCHMARK_TEMPLATE(BM_Sort_NonAssignable, lloyal::InlinedVector<NonAssignable, kInlineCapacity>, true)
+    ->Arg(kInlineCapacity / 2)->Arg(kInlineCapacity + 1)->Arg(kInlineCapacity * 8);
+
+// =========================================================================
+// BENCHMARK 13: Compressed Integers (Footprint and Scan)
+// =========================================================================
+// Both containers hold 64 inline bytes: 16 plain uint32_t, or packed/varint
+// bits. Small IDs (< 200) use packed mode; sorted posting lists (gaps 1-8)
+// use sorted_delta.
+
+using PlainIds = lloyal::InlinedVector<uint32_t, 16>;
+using CompressedIds = lloyal::CompressedInlinedVector<uint32_t, 64>;
+
+template <typename VecType>
+static VecType MakeIds(size_t n, bool sorted) {
+    VecType vec = [&] {
+        if constexpr (std::is_same_v<VecType, CompressedIds>) {
+            return VecType(sorted ? lloyal::compression::sorted_delta : lloyal::compression::packed);
+        } else {
+            return VecType();
+        }
+    }();
+    uint32_t id = 100000;
+    for (size_t i = 0; i < n; ++i) {
+        id += 1 + static_cast<uint32_t>((i * 7919) % 8);
+        vec.push_back(sorted ? id : static_cast<uint32_t>((i * 7919) % 200));
+    }
+    return vec;
+}
+
+template <typename VecType, bool Sorted>
+static void BM_Compressed_Build(benchmark::State& state) {
+    const size_t n = state.range(0);
+    size_t bytes = 0;
+    for (auto _ : Measured(state)) {
+        VecType vec = MakeIds<VecType>(n, Sorted);
+        bytes = vec.memory_usage();
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.counters["bytes"] = static_cast<double>(bytes);
+    state.counters["heap_bytes"] = static_cast<double>(bytes - sizeof(VecType));
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Bulk: decode with unpack() into a scratch buffer, then sum
+template <typename VecType, bool Sorted, bool Bulk = false>
+static void BM_Compressed_Scan(benchmark::State& state) {
+    const size_t n = state.range(0);
+    const VecType vec = MakeIds<VecType>(n, Sorted);
+    std::vector<uint32_t> scratch(n);
+    for (auto _ : Measured(state)) {
+        uint64_t sum = 0;
+        if constexpr (Bulk) {
+            vec.unpack(scratch.data());
+            for (uint32_t v : scratch) sum += v;
+        } else {
+            for (uint32_t v : vec) sum += v;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(BM_Compressed_Build, PlainIds, false)->Arg(16)->Arg(48)->Arg(128);
+BENCHMARK_TEMPLATE(BM_Compressed_Build, CompressedIds, false)->Arg(16)->Arg(48)->Arg(128);
+BENCHMARK_TEMPLATE(BM_Compressed_Build, PlainIds, true)->Arg(16)->Arg(48)->Arg(128);
+BENCHMARK_TEMPLATE(BM_Compressed_Build, CompressedIds, true)->Arg(16)->Arg(48)->Arg(128);
+BENCHMARK_TEMPLATE(BM_Compressed_Scan, PlainIds, false)->Arg(16)->Arg(48)->Arg(128);
+BENCHMARK_TEMPLATE(BM_Compressed_Scan, CompressedIds, false)->Arg(16)->Arg(48)->Arg(128);
+BENCHMARK_TEMPLATE(BM_Compressed_Scan, CompressedIds, false, true)->Arg(16)->Arg(48)->Arg(128);
+BENCHMARK_TEMPLATE(BM_Compressed_Scan, PlainIds, true)->Arg(16)->Arg(48)->Arg(128);
+BENCHMARK_TEMPLATE(BM_Compressed_Scan, CompressedIds, true)->Arg(16)->Arg(48)->Arg(128);
+BENCHMARK_TEMPLATE(BM_Compressed_Scan, CompressedIds, true, true)->Arg(16)->Arg(48)->Arg(128);
+
+// =========================================================================
+// BENCHMARK 14: Runtime-Bounded Scratch (Borrowed Buffer)
+// =========================================================================
+// A function needs n scratch elements, n known only at runtime. Compares a
+// heap vector, an InlinedVector sized for the worst case, and an
+// InlinedVectorRef over a thread-local arena slice of exactly n elements.
+
+template <typename Scratch>
+static TrivialType FillScratch(Scratch& scratch, size_t n) {
+    for (size_t i = 0; i < n; ++i) scratch.push_back(static_cast<TrivialType>(i * 3));
+    TrivialType sum = 0;
+    for (TrivialType v : scratch) sum += v;
+    return sum;
+}
+
+template <int Kind>
+static void BM_Scratch_RuntimeBound(benchmark::State& state) {
+    const size_t n = state.range(0);
+    thread_local std::vector<TrivialType> arena(4096);
+    for (auto _ : Measured(state)) {
+        TrivialType sum;
+        if constexpr (Kind == 0) {
+            std::vector<TrivialType> scratch;
+            sum = FillScratch(scratch, n);
+        } else if constexpr (Kind == 1) {
+            lloyal::InlinedVector<TrivialType, 1024> scratch; // Worst-case N
+            sum = FillScratch(scratch, n);
+        } else {
+            lloyal::InlinedVectorRef<TrivialType> scratch(arena.data(), n);
+            sum = FillScratch(scratch, n);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetLabel(Kind == 0 ? "std::vector" : Kind == 1 ? "InlinedVector<1024>" : "InlinedVectorRef(arena)");
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(BM_Scratch_RuntimeBound, 0)->Arg(8)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_Scratch_RuntimeBound, 1)->Arg(8)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_Scratch_RuntimeBound, 2)->Arg(8)->Arg(100)->Arg(1000);
+
+// =========================================================================
+// BENCHMARK 15: Arena Teardown (Wink-Out Allocators)
+// =========================================================================
+// A request-scoped arena holds many small vectors, about a quarter of them
+// spilled. Only the teardown is timed. The pmr allocator still destroys
+// elements and calls deallocate (a virtual no-op on a monotonic resource).
+// The wink-out allocator skips both.
+
+template <typename T>
+struct WinkOutPmrAlloc : std::pmr::polymorphic_allocator<T> {
+    using is_wink_out = std::true_type;
+    WinkOutPmrAlloc(std::pmr::memory_resource* r) noexcept : std::pmr::polymorphic_allocator<T>(r) {}
+    template <typename U>
+    WinkOutPmrAlloc(const WinkOutPmrAlloc<U>& o) noexcept : std::pmr::polymorphic_allocator<T>(o.resource()) {}
+    WinkOutPmrAlloc select_on_container_copy_construction() const { return *this; }
+};
+
+template <typename VecType>
+static void BM_ArenaTeardown(benchmark::State& state) {
+    const size_t count = state.range(0);
+    using Alloc = typename VecType::allocator_type;
+    for (auto _ : Measured(state)) {
+        PauseMeasurement(state);
+        {
+            std::pmr::monotonic_buffer_resource arena;
+            auto* pool = static_cast<VecType*>(arena.allocate(count * sizeof(VecType), alignof(VecType)));
+            for (size_t i = 0; i < count; ++i) {
+                VecType* v = new (pool + i) VecType(Alloc(&arena));
+                const size_t n = (i % 4 == 0) ? kInlineCapacity * 2 : i % kInlineCapacity;
+                for (size_t j = 0; j < n; ++j) v->push_back(static_cast<TrivialType>(j));
+            }
+            ResumeMeasurement(state);
+            for (size_t i = 0; i < count; ++i) pool[i].~VecType();
+            benchmark::ClobberMemory();
+            PauseMeasurement(state);
+        }
+        ResumeMeasurement(state);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(BM_ArenaTeardown, lloyal::InlinedVector<TrivialType, kInlineCapacity, PmrAlloc>)->Arg(100000)->Iterations(20);
+BENCHMARK_TEMPLATE(BM_ArenaTeardown, lloyal::InlinedVector<TrivialType, kInlineCapacity, WinkOutPmrAlloc<TrivialType>>)->Arg(100000)->Iterations(20);
+
+// =========================================================================
+// BENCHMARK 16: Small Polymorphic Handler Chains
+// =========================================================================
+// Builds a chain of mixed-size handlers and dispatches through it once.
+// unique_ptr storage allocates once per handler. PolyInlinedVector puts the
+// objects themselves in its inline region.
+
+struct BenchHandler {
+    virtual ~BenchHandler() = default;
+    virtual uint64_t run(uint64_t x) const noexcept = 0;
+};
+struct BenchAdd : BenchHandler {
+    uint64_t k;
+    explicit BenchAdd(uint64_t k_) : k(k_) {}
+    uint64_t run(uint64_t x) const noexcept override { return x + k; }
+};
+struct BenchMix : BenchHandler {
+    uint64_t a, b, c;
+    explicit BenchMix(uint64_t k) : a(k), b(k * 3), c(k ^ 5) {}
+    uint64_t run(uint64_t x) const noexcept override { return (x * a + b) ^ c; }
+};
+
+template <bool Poly>
+static void BM_PolyHandlers(benchmark::State& state) {
+    const size_t n = state.range(0);
+    for (auto _ : Measured(state)) {
+        uint64_t x = 1;
+        if constexpr (Poly) {
+            lloyal::PolyInlinedVector<BenchHandler, 256> chain;
+            for (size_t i = 0; i < n; ++i) {
+                if (i % 2) chain.emplace_back<BenchMix>(i);
+                else chain.emplace_back<BenchAdd>(i);
+            }
+            for (const BenchHandler& h : chain) x = h.run(x);
+        } else {
+            lloyal::InlinedVector<std::unique_ptr<BenchHandler>, 8> chain;
+            for (size_t i = 0; i < n; ++i) {
+                if (i % 2) chain.push_back(std::make_unique<BenchMix>(i));
+                else chain.push_back(std::make_unique<BenchAdd>(i));
+            }
+            for (const auto& h : chain) x = h->run(x);
+        }
+        benchmark::DoNotOptimize(x);
+    }
+    state.SetLabel(Poly ? "PolyInlinedVector<256>" : "InlinedVector<unique_ptr, 8>");
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(BM_PolyHandlers, false)->Arg(4)->Arg(8)->Arg(32);
+BENCHMARK_TEMPLATE(BM_PolyHandlers, true)->Arg(4)->Arg(8)->Arg(32);
+
+// =========================================================================
+// BENCHMARK 17: Socket Framing (Byte Buffer vs std::vector<char>)
+// =========================================================================
+// Round-trips length-prefixed frames through a socketpair. Each iteration
+// gathers the frames with writev, then reads them back in 1 KiB chunks and
+// parses every complete frame. std::vector<char> grows with resize and drops
+// parsed bytes with erase(begin), which shifts the remainder.
+// InlinedByteBuffer reads into prepare()d spare capacity and drops parsed bytes
+// by advancing a cursor.
+
+#if __has_include(<sys/socket.h>) && __has_include(<sys/uio.h>) && __has_include(<unistd.h>)
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+constexpr size_t kFramePayload = 96;
+constexpr size_t kReadChunk = 1024;
+
+struct SocketPair {
+    int fd[2] = {-1, -1};
+    SocketPair() { if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fd) != 0) fd[0] = fd[1] = -1; }
+    ~SocketPair() { if (fd[0] >= 0) { ::close(fd[0]); ::close(fd[1]); } }
+};
+
+// Parses complete [uint32 length][payload] frames from the front of `p`.
+// Returns the bytes consumed; adds each payload's first byte to `sum`.
+static size_t ParseFrames(const char* p, size_t n, uint64_t& sum) {
+    size_t off = 0;
+    while (n - off >= sizeof(uint32_t)) {
+        uint32_t len;
+        std::memcpy(&len, p + off, sizeof(len));
+        if (n - off - sizeof(len) < len) break;
+        sum += static_cast<unsigned char>(p[off + sizeof(len)]);
+        off += sizeof(len) + len;
+    }
+    return off;
+}
+
+template <bool ByteBuffer>
+static void BM_SocketFraming(benchmark::State& state) {
+    SocketPair sp;
+    if (sp.fd[0] < 0) { state.SkipWithError("socketpair failed"); return; }
+    const size_t frames = state.range(0);
+    const uint32_t len = kFramePayload;
+    std::array<char, kFramePayload> payload;
+    payload.fill('p');
+    const size_t total = frames * (sizeof(len) + len);
+    std::vector<iovec> out(frames * 2);
+    for (size_t i = 0; i < frames; ++i) {
+        out[2 * i] = {const_cast<uint32_t*>(&len), sizeof(len)};
+        out[2 * i + 1] = {payload.data(), payload.size()};
+    }
+
+    for (auto _ : Measured(state)) {
+        if (::writev(sp.fd[0], out.data(), static_cast<int>(out.size())) != static_cast<ssize_t>(total)) {
+            state.SkipWithError("short writev"); break;
+        }
+        uint64_t sum = 0;
+        size_t received = 0;
+        if constexpr (ByteBuffer) {
+            lloyal::InlinedByteBuffer<2048> in;
+            while (received < total) {
+                iovec iov;
+                in.prepare_iovecs(&iov, kReadChunk);
+                const ssize_t got = ::readv(sp.fd[1], &iov, 1);
+                if (got <= 0) break;
+                in.commit(static_cast<size_t>(got));
+                received += static_cast<size_t>(got);
+                in.consume(ParseFrames(reinterpret_cast<const char*>(in.data()), in.size(), sum));
+            }
+        } else {
+            std::vector<char> in;
+            while (received < total) {
+                const size_t old = in.size();
+                in.resize(old + kReadChunk);
+                const ssize_t got = ::read(sp.fd[1], in.data() + old, kReadChunk);
+                if (got <= 0) break;
+                in.resize(old + static_cast<size_t>(got));
+                received += static_cast<size_t>(got);
+                in.erase(in.begin(), in.begin() + ParseFrames(in.data(), in.size(), sum));
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetLabel(ByteBuffer ? "InlinedByteBuffer<2048>" : "std::vector<char>");
+    state.SetBytesProcessed(state.iterations() * total);
+}
+BENCHMARK_TEMPLATE(BM_SocketFraming, false)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_SocketFraming, true)->Arg(4)->Arg(16)->Arg(64);
+#endif
+
+// =========================================================================
+// BENCHMARK 18: SPSC Handoff (Lock-Free Ring vs Mutex + InlinedVector)
+// =========================================================================
+// A producer thread and the benchmark thread are pinned to different cores
+// where the platform allows it. Throughput: each iteration moves
+// kHandoffItems in batches of 16. The baseline is the mutex-guarded
+// InlinedVector our pipeline uses, and the consumer swaps out the whole batch
+// under the lock. Latency: each iteration is one ping/pong round trip through
+// two queues.
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include <mutex>
+
+static void PinThisThread(unsigned core) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % std::max(1u, std::thread::hardware_concurrency()), &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)core;
+#endif
+}
+
+constexpr size_t kHandoffItems = 4096;
+constexpr size_t kHandoffBatch = 16;
+
+// Kind 0: mutex + InlinedVector; 1: InlinedSpscRing (reject); 2: InlinedSpscRing (heap overflow)
+template <int Kind>
+struct HandoffQueue {
+    static constexpr size_t kBound = 256;
+    std::mutex mu;
+    lloyal::InlinedVector<TrivialType, kBound> items;
+
+    size_t push_n(const TrivialType* src, size_t n) {
+        std::lock_guard<std::mutex> lock(mu);
+        n = std::min(n, kBound - std::min(kBound, items.size()));
+        for (size_t i = 0; i < n; ++i) items.push_back(src[i]);
+        return n;
+    }
+    template <typename OutputIt>
+    size_t pop_n(OutputIt out, size_t) {
+        lloyal::InlinedVector<TrivialType, kBound> batch;
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            batch.swap(items);
+        }
+        std::copy(batch.begin(), batch.end(), out);
+        return batch.size();
+    }
+};
+template <>
+struct HandoffQueue<1> : lloyal::InlinedSpscRing<TrivialType, 256> {};
+template <>
+struct HandoffQueue<2> : lloyal::InlinedSpscRing<TrivialType, 256, lloyal::ring_overflow::heap> {};
+
+static const char* HandoffLabel(int kind) {
+    return kind == 0 ? "mutex + InlinedVector<256>" : kind == 1 ? "InlinedSpscRing<256>" : "InlinedSpscRing<256, heap>";
+}
+
+template <int Kind>
+static void BM_Spsc_Throughput(benchmark::State& state) {
+    HandoffQueue<Kind> q;
+    std::atomic<bool> stop{false};
+    std::thread producer([&] {
+        PinThisThread(1);
+        std::array<TrivialType, kHandoffBatch> batch{};
+        TrivialType next = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            for (auto& v : batch) v = next++;
+            size_t sent = 0;
+            while (sent < batch.size() && !stop.load(std::memory_order_relaxed)) {
+                const size_t n = q.push_n(batch.data() + sent, batch.size() - sent);
+                sent += n;
+                if (n == 0) std::this_thread::yield();
+            }
+        }
+    });
+    PinThisThread(0);
+    std::array<TrivialType, 256> sink;
+    TrivialType sum = 0;
+    for (auto _ : Measured(state)) {
+        for (size_t got = 0; got < kHandoffItems;) {
+            const size_t n = q.pop_n(sink.data(), sink.size());
+            for (size_t i = 0; i < n; ++i) sum += sink[i];
+            got += n;
+            if (n == 0) std::this_thread::yield();
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    stop.store(true);
+    producer.join();
+    state.SetLabel(HandoffLabel(Kind));
+    state.SetItemsProcessed(state.iterations() * kHandoffItems);
+}
+BENCHMARK_TEMPLATE(BM_Spsc_Throughput, 0)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Spsc_Throughput, 1)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Spsc_Throughput, 2)->UseRealTime();
+
+template <int Kind>
+static void BM_Spsc_RoundTrip(benchmark::State& state) {
+    HandoffQueue<Kind> ping, pong;
+    std::atomic<bool> stop{false};
+    std::thread echo([&] {
+        PinThisThread(1);
+        TrivialType v;
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (ping.pop_n(&v, 1) == 1) { while (pong.push_n(&v, 1) == 0) {} }
+            else std::this_thread::yield();
+        }
+    });
+    PinThisThread(0);
+    TrivialType v = 0;
+    for (auto _ : Measured(state)) {
+        while (ping.push_n(&v, 1) == 0) {}
+        while (pong.pop_n(&v, 1) == 0) std::this_thread::yield();
+        ++v;
+    }
+    stop.store(true);
+    echo.join();
+    state.SetLabel(HandoffLabel(Kind));
+}
+BENCHMARK_TEMPLATE(BM_Spsc_RoundTrip, 0)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Spsc_RoundTrip, 1)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Spsc_RoundTrip, 2)->UseRealTime();
+
+// =========================================================================
+// BENCHMARK 19: De-Amortized Growth (Worst-Case push_back)
+// =========================================================================
+// BM_Latency_PushBack (BENCHMARK 10) at a million elements. Doubling growth
+// moves every element on the push that crosses a power of two, so max tracks
+// n. IncrementalInlinedVector moves at most Step elements per push. Its max
+// is then set by the allocator: mapping the new block, and unmapping the
+// drained one on the push that finishes a migration. Its p50 pays for the
+// index check and the per-push migration.
+
+constexpr int kDeamortizedRepeats = 5;
+BENCHMARK_TEMPLATE(BM_Latency_PushBack, std::vector<TrivialType>)->Arg(1 << 20)->Iterations(kDeamortizedRepeats);
+BENCHMARK_TEMPLATE(BM_Latency_PushBack, lloyal::InlinedVector<TrivialType, kInlineCapacity>)->Arg(1 << 20)->Iterations(kDeamortizedRepeats);
+BENCHMARK_TEMPLATE(BM_Latency_PushBack, lloyal::IncrementalInlinedVector<TrivialType, kInlineCapacity>)->Arg(kInlineCapacity * 4)->Arg(100000)->Arg(1 << 20)->Iterations(kDeamortizedRepeats);
+
+// =========================================================================
+// BENCHMARK 20: Skewed Final Sizes (Adaptive First Spill)
+// =========================================================================
+// Each iteration replays a trace of 8192 final sizes, building and destroying
+// one vector per entry. 10% of the vectors stay inline. The rest end near 450
+// ("Large") or just past N ("JustOver"). "Shift" alternates between the two
+// every 2048 vectors, so the adaptive sites must decay and relearn. allocs/op
+// (per replay) shows the reallocations that the learned first spill removes.
+
+enum SkewDist { kSkewLarge, kSkewJustOver, kSkewShift };
+
+static const std::vector<size_t>& SkewTrace(int dist) {
+    static std::array<std::vector<size_t>, 3> traces;
+    auto& trace = traces[dist];
+    if (trace.empty()) {
+        uint64_t x = 0x2545F4914F6CDD1Dull;
+        auto next = [&] { x ^= x << 13; x ^= x >> 7; x ^= x << 17; return x; };
+        for (size_t i = 0; i < 8192; ++i) {
+            const bool large = dist == kSkewLarge || (dist == kSkewShift && (i / 2048) % 2 == 0);
+            if (next() % 10 == 0) trace.push_back(1 + next() % kInlineCapacity);
+            else if (large) trace.push_back(300 + next() % 300);
+            else trace.push_back(kInlineCapacity + 1 + next() % 4);
+        }
+    }
+    return trace;
+}
+
+template <int Dist> struct SkewSite {};
+
+// Kind 0: InlinedVector; 1: AdaptiveInlinedVector keyed by tag; 2: keyed by std::source_location
+template <int Kind, int Dist, typename T = TrivialType>
+static void BM_AdaptiveSpill(benchmark::State& state) {
+    const auto& trace = SkewTrace(Dist);
+    const T value = [] { if constexpr (std::is_same_v<T, TrivialType>) return g_trivial_val; else return g_complex_val; }();
+    size_t items = 0;
+    for (auto _ : Measured(state)) {
+        for (const size_t n : trace) {
+            if constexpr (Kind == 0) {
+                lloyal::InlinedVector<T, kInlineCapacity> vec;
+                for (size_t i = 0; i < n; ++i) vec.push_back(value);
+                benchmark::DoNotOptimize(vec.data());
+            } else if constexpr (Kind == 1) {
+                lloyal::AdaptiveInlinedVector<T, kInlineCapacity, SkewSite<Dist>> vec;
+                for (size_t i = 0; i < n; ++i) vec.push_back(value);
+                benchmark::DoNotOptimize(vec.data());
+            } else {
+#if LLOYAL_HAS_SOURCE_LOCATION
+                lloyal::AdaptiveInlinedVector<T, kInlineCapacity> vec;
+                for (size_t i = 0; i < n; ++i) vec.push_back(value);
+                benchmark::DoNotOptimize(vec.data());
+#endif
+            }
+            items += n;
+        }
+    }
+    static const char* const kDist[] = {"Large", "JustOver", "Shift"};
+    static const char* const kKind[] = {"InlinedVector", "Adaptive<tag>", "Adaptive<source_location>"};
+    state.SetLabel(std::string(kKind[Kind]) + " " + kDist[Dist] + (std::is_same_v<T, TrivialType> ? "" : " (string)"));
+    state.SetItemsProcessed(items);
+}
+BENCHMARK_TEMPLATE(BM_AdaptiveSpill, 0, kSkewLarge);
+BENCHMARK_TEMPLATE(BM_AdaptiveSpill, 1, kSkewLarge);
+BENCHMARK_TEMPLATE(BM_AdaptiveSpill, 0, kSkewJustOver);
+BENCHMARK_TEMPLATE(BM_AdaptiveSpill, 1, kSkewJustOver);
+BENCHMARK_TEMPLATE(BM_AdaptiveSpill, 0, kSkewShift);
+BENCHMARK_TEMPLATE(BM_AdaptiveSpill, 1, kSkewShift);
+#if LLOYAL_HAS_SOURCE_LOCATION
+BENCHMARK_TEMPLATE(BM_AdaptiveSpill, 2, kSkewShift);
+#endif
+BENCHMARK_TEMPLATE(BM_AdaptiveSpill, 0, kSkewLarge, ComplexType);
+BENCHMARK_TEMPLATE(BM_AdaptiveSpill, 1, kSkewLarge, ComplexType);
+
+// =========================================================================
+// BENCHMARK 21: Read-Mostly Routing Lists (RCU Snapshot vs shared_mutex)
+// =========================================================================
+// Every thread picks an endpoint from a 6-entry InlinedVector<Endpoint, 8>
+// per iteration; thread 0 also rewrites one weight every 4096 reads. Threads
+// run from 1 to 64 whatever the core count, since oversubscribed readers are
+// what our request handlers look like. "efficiency" is from ReportScaling
+// (BENCHMARK 9): the shared_mutex readers all bump one reader count.
+
+#include <shared_mutex>
+
+struct Endpoint { uint32_t addr; uint16_t port; uint16_t weight; };
+using RouteList = lloyal::InlinedVector<Endpoint, 8>;
+
+static RouteList MakeRoutes() {
+    RouteList routes;
+    for (uint16_t i = 0; i < 6; ++i) routes.push_back({0x0A000001u + i, static_cast<uint16_t>(8080 + i), static_cast<uint16_t>(1 + i)});
+    return routes;
+}
+
+static uint32_t PickEndpoint(const RouteList& routes, uint64_t key) {
+    uint32_t total = 0;
+    for (const Endpoint& e : routes) total += e.weight;
+    uint32_t slot = static_cast<uint32_t>(key % total);
+    for (const Endpoint& e : routes) {
+        if (slot < e.weight) return e.addr ^ e.port;
+        slot -= e.weight;
+    }
+    return 0;
+}
+
+// Kind 0: shared_mutex + InlinedVector; 1: AtomicInlinedVectorSnapshot
+template <int Kind>
+static void BM_ReadMostly(benchmark::State& state) {
+    static std::atomic<double> single_thread_rate{0.0};
+    static std::shared_mutex mu;
+    static RouteList locked_routes = MakeRoutes();
+    static lloyal::AtomicInlinedVectorSnapshot<Endpoint, 8> snapshot(MakeRoutes());
+
+    uint64_t key = 0x9E3779B97F4A7C15ull * (state.thread_index() + 1);
+    uint64_t n = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (auto _ : Measured(state)) {
+        key = key * 6364136223846793005ull + 1442695040888963407ull;
+        uint32_t picked;
+        if constexpr (Kind == 0) {
+            std::shared_lock<std::shared_mutex> lock(mu);
+            picked = PickEndpoint(locked_routes, key >> 33);
+        } else {
+            picked = snapshot.read([&](const RouteList& routes) { return PickEndpoint(routes, key >> 33); });
+        }
+        benchmark::DoNotOptimize(picked);
+        if (state.thread_index() == 0 && (++n & 4095) == 0) {
+            const auto w = static_cast<uint16_t>(1 + (n >> 12) % 7);
+            if constexpr (Kind == 0) {
+                std::unique_lock<std::shared_mutex> lock(mu);
+                locked_routes[n % locked_routes.size()].weight = w;
+            } else {
+                snapshot.update([&](RouteList& routes) { routes[n % routes.size()].weight = w; });
+            }
+        }
+    }
+    ReportScaling(state, single_thread_rate, start);
+    state.SetLabel(Kind == 0 ? "shared_mutex" : "AtomicInlinedVectorSnapshot");
+}
+BENCHMARK_TEMPLATE(BM_ReadMostly, 0)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ReadMostly, 1)->ThreadRange(1, 64)->UseRealTime();
+
+// =========================================================================
+// BENCHMARK 22: Interning Skewed Label Sets
+// =========================================================================
+// 4096 distinct label sets (1-8 uint32 labels, so some spill past N = 6),
+// referenced 1 << 16 times with Zipf(1.1) frequencies: a few hundred sets
+// account for most references. Lookup throughput interns the whole stream
+// per iteration into a warmed interner, so nearly every call is a hit. The
+// baseline is an unsynchronized std::unordered_map keyed on the vectors. The
+// memory benchmark interns 1 << 20 references into a fresh interner. It
+// compares storing every InlinedVector with storing one handle each plus the
+// interner's stats().
+
+#include <cmath>
+#include <string_view>
+#include <unordered_map>
+
+using LabelSet = lloyal::InlinedVector<uint32_t, 6>;
+
+static const std::vector<LabelSet>& SkewedLabelStream(size_t refs) {
+    static std::unordered_map<size_t, std::vector<LabelSet>> streams;
+    auto& stream = streams[refs];
+    if (stream.empty()) {
+        uint64_t x = 0x2545F4914F6CDD1Dull;
+        auto next = [&] { x ^= x << 13; x ^= x >> 7; x ^= x << 17; return x; };
+        std::vector<LabelSet> distinct(4096);
+        for (auto& set : distinct) {
+            const size_t n = 1 + next() % 8;
+            for (size_t i = 0; i < n; ++i) set.push_back(static_cast<uint32_t>(next() % 100000));
+        }
+        std::vector<double> cdf(distinct.size());
+        double total = 0;
+        for (size_t i = 0; i < cdf.size(); ++i) cdf[i] = total += 1.0 / std::pow(static_cast<double>(i + 1), 1.1);
+        stream.reserve(refs);
+        for (size_t r = 0; r < refs; ++r) {
+            const double u = static_cast<double>(next() >> 11) / static_cast<double>(1ull << 53) * total;
+            stream.push_back(distinct[std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin()]);
+        }
+    }
+    return stream;
+}
+
+struct LabelSetHash {
+    size_t operator()(const LabelSet& v) const noexcept {
+        return std::hash<std::string_view>{}(std::string_view(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(uint32_t)));
+    }
+};
+
+// Kind 0: intern() per reference; 1: intern_batch; 2: std::unordered_map baseline
+template <int Kind>
+static void BM_Intern_Lookup(benchmark::State& state) {
+    const auto& stream = SkewedLabelStream(1 << 16);
+    lloyal::InlinedVectorInterner<uint32_t, 6> interner;
+    std::unordered_map<LabelSet, uint32_t, LabelSetHash> map;
+    std::vector<uint32_t> handles(stream.size());
+    for (const auto& set : stream) { interner.intern(set); map.emplace(set, static_cast<uint32_t>(map.size())); }
+    for (auto _ : Measured(state)) {
+        if constexpr (Kind == 0) {
+            for (size_t i = 0; i < stream.size(); ++i) handles[i] = interner.intern(stream[i]);
+        } else if constexpr (Kind == 1) {
+            interner.intern_batch(stream.begin(), stream.end(), handles.begin());
+        } else {
+            for (size_t i = 0; i < stream.size(); ++i) handles[i] = map.find(stream[i])->second;
+        }
+        benchmark::DoNotOptimize(handles.data());
+    }
+    static const char* const kLabel[] = {"intern", "intern_batch", "unordered_map"};
+    state.SetLabel(kLabel[Kind]);
+    state.SetItemsProcessed(state.iterations() * stream.size());
+}
+BENCHMARK_TEMPLATE(BM_Intern_Lookup, 0);
+BENCHMARK_TEMPLATE(BM_Intern_Lookup, 1);
+BENCHMARK_TEMPLATE(BM_Intern_Lookup, 2);
+
+// Hits take no lock, so concurrent lookups on a shared interner should scale
+static void BM_Intern_Lookup_MT(benchmark::State& state) {
+    static std::atomic<double> single_thread_rate{0.0};
+    static lloyal::InlinedVectorInterner<uint32_t, 6> interner;
+    const auto& stream = SkewedLabelStream(1 << 16);
+    if (state.thread_index() == 0) for (const auto& set : stream) interner.intern(set);
+    size_t i = state.thread_index() * 4099;
+    const auto start = std::chrono::steady_clock::now();
+    for (auto _ : Measured(state)) {
+        benchmark::DoNotOptimize(interner.intern(stream[i++ & (stream.size() - 1)]));
+    }
+    ReportScaling(state, single_thread_rate, start);
+}
+BENCHMARK(BM_Intern_Lookup_MT)->ThreadRange(1, kMaxThreads)->UseRealTime();
+
+static void BM_Intern_Memory(benchmark::State& state) {
+    const auto& stream = SkewedLabelStream(1 << 20);
+    size_t raw_bytes = 0;
+    for (const auto& set : stream) raw_bytes += set.memory_usage();
+    lloyal::interner_stats st;
+    for (auto _ : Measured(state)) {
+        lloyal::InlinedVectorInterner<uint32_t, 6> interner;
+        std::vector<uint32_t> handles(stream.size());
+        interner.intern_batch(stream.begin(), stream.end(), handles.begin());
+        benchmark::DoNotOptimize(handles.data());
+        st = interner.stats();
+    }
+    const size_t interned_bytes = stream.size() * sizeof(uint32_t) + st.value_bytes + st.index_bytes;
+    state.counters["raw_MB"] = static_cast<double>(raw_bytes) / (1 << 20);
+    state.counters["interned_MB"] = static_cast<double>(interned_bytes) / (1 << 20);
+    state.counters["saving"] = static_cast<double>(raw_bytes) / static_cast<double>(interned_bytes);
+    state.counters["distinct"] = static_cast<double>(st.distinct);
+    state.SetItemsProcessed(state.iterations() * stream.size());
+}
+BENCHMARK(BM_Intern_Memory)->Unit(benchmark::kMillisecond);
+
+// =========================================================================
+// BENCHMARK 23: Fused Numeric Expressions on Small Dense Vectors
+// =========================================================================
+// out = a + b * c and dot(a, b) over InlinedVector<float, 16> for sizes
+// 4-256. Size 16 equals N, so lloyal takes the compile-time trip-count path;
+// other sizes run the runtime lane loop, spilled above 16. The baselines are
+// a hand-written scalar loop over the same vectors (which the compiler is
+// free to auto-vectorize) and std::valarray, whose expression templates also
+// avoid temporaries.
+
+#include <valarray>
+
+using FeatureVec = lloyal::InlinedVector<float, kInlineCapacity>;
+
+static void FillFeatures(FeatureVec& v, size_t n, float seed) {
+    v.clear();
+    for (size_t i = 0; i < n; ++i) v.push_back(seed + 0.25f * static_cast<float>(i % 13));
+}
+
+static const char* const kNumericLabel[] = {"scalar_loop", "lloyal_num", "valarray"};
+
+// Kind 0: scalar loop; 1: lloyal::num expression; 2: std::valarray
+template <int Kind>
+static void BM_Numeric_Fma(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    FeatureVec a, b, c, out;
+    FillFeatures(a, n, 1.0f); FillFeatures(b, n, 2.0f); FillFeatures(c, n, 3.0f); FillFeatures(out, n, 0.0f);
+    std::valarray<float> va(a.data(), n), vb(b.data(), n), vc(c.data(), n), vout(n);
+    for (auto _ : Measured(state)) {
+        if constexpr (Kind == 0) {
+            for (size_t i = 0; i < out.size(); ++i) out[i] = a[i] + b[i] * c[i];
+            benchmark::DoNotOptimize(out);
+        } else if constexpr (Kind == 1) {
+            lloyal::num(out) = lloyal::num(a) + lloyal::num(b) * lloyal::num(c);
+            benchmark::DoNotOptimize(out);
+        } else {
+            vout = va + vb * vc;
+            benchmark::DoNotOptimize(vout);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(kNumericLabel[Kind]);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(BM_Numeric_Fma, 0)->RangeMultiplier(2)->Range(4, 256);
+BENCHMARK_TEMPLATE(BM_Numeric_Fma, 1)->RangeMultiplier(2)->Range(4, 256);
+BENCHMARK_TEMPLATE(BM_Numeric_Fma, 2)->RangeMultiplier(2)->Range(4, 256);
+
+template <int Kind>
+static void BM_Numeric_Dot(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    FeatureVec a, b;
+    FillFeatures(a, n, 1.0f); FillFeatures(b, n, 2.0f);
+    std::valarray<float> va(a.data(), n), vb(b.data(), n);
+    for (auto _ : Measured(state)) {
+        float d;
+        if constexpr (Kind == 0) {
+            d = 0.0f;
+            for (size_t i = 0; i < a.size(); ++i) d += a[i] * b[i];
+        } else if constexpr (Kind == 1) {
+            d = lloyal::dot(a, b);
+        } else {
+            d = (va * vb).sum();
+        }
+        benchmark::DoNotOptimize(d);
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(kNumericLabel[Kind]);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(BM_Numeric_Dot, 0)->RangeMultiplier(2)->Range(4, 256);
+BENCHMARK_TEMPLATE(BM_Numeric_Dot, 1)->RangeMultiplier(2)->Range(4, 256);
+BENCHMARK_TEMPLATE(BM_Numeric_Dot, 2)->RangeMultiplier(2)->Range(4, 256);
+
+// =========================================================================
+// BENCHMARK 24: Batch Sorted-Merge Insert
+// =========================================================================
+// Adds a sorted batch of k keys to a sorted vector of n elements. The loop
+// baseline calls insert(lower_bound(...)) per key, shifting the tail each time.
+// merge_insert_sorted grows once and merges in a single pass. Args are
+// {n, k}: inline (4+4), spilling (12+8), and heap (256+16, 4096+64,
+// 4096+1024). Each iteration starts from a copy of the base vector. Both
+// kinds pay for that copy, and "copy_only" measures it.
+
+template <typename T>
+static T MergeKey(uint64_t x) {
+    if constexpr (std::is_same_v<T, ComplexType>) {
+        std::string s = "key-padded-past-sso-";
+        s += std::to_string(100000000 + x); // Fixed width, so string order is numeric order
+        return s;
+    } else {
+        return static_cast<T>(x);
+    }
+}
+
+// Kind 0: insert(lower_bound) loop; 1: merge_insert_sorted; 2: copy only
+template <typename T, int Kind>
+static void BM_MergeInsertSorted(benchmark::State& state) {
+    using Vec = lloyal::InlinedVector<T, kInlineCapacity>;
+    const size_t n = static_cast<size_t>(state.range(0));
+    const size_t k = static_cast<size_t>(state.range(1));
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    auto next = [&] { x ^= x << 13; x ^= x >> 7; x ^= x << 17; return x; };
+    Vec base;
+    std::vector<uint64_t> raw(n);
+    for (auto& r : raw) r = (next() % (n * 8 + 8)) * 2; // Even keys
+    std::sort(raw.begin(), raw.end());
+    for (uint64_t r : raw) base.push_back(MergeKey<T>(r));
+    std::vector<uint64_t> raw_batch(k);
+    for (auto& r : raw_batch) r = (next() % (n * 8 + 8)) * 2 + 1; // Odd keys land between
+    std::sort(raw_batch.begin(), raw_batch.end());
+    std::vector<T> batch;
+    for (uint64_t r : raw_batch) batch.push_back(MergeKey<T>(r));
+    for (auto _ : Measured(state)) {
+        Vec v(base);
+        if constexpr (Kind == 0) {
+            for (const auto& key : batch) v.insert(std::lower_bound(v.begin(), v.end(), key), key);
+        } else if constexpr (Kind == 1) {
+            v.merge_insert_sorted(batch.begin(), batch.end());
+        }
+        benchmark::DoNotOptimize(v.data());
+        benchmark::ClobberMemory();
+    }
+    static const char* const kLabel[] = {"insert_loop", "merge_insert_sorted", "copy_only"};
+    state.SetLabel(kLabel[Kind]);
+    state.SetItemsProcessed(state.iterations() * k);
+}
+static void MergeInsertArgs(benchmark::internal::Benchmark* b) {
+    for (auto nk : {std::pair<int, int>{4, 4}, {12, 8}, {256, 16}, {4096, 64}, {4096, 1024}}) b->Args({nk.first, nk.second});
+}
+BENCHMARK_TEMPLATE(BM_MergeInsertSorted, TrivialType, 0)->Apply(MergeInsertArgs);
+BENCHMARK_TEMPLATE(BM_MergeInsertSorted, TrivialType, 1)->Apply(MergeInsertArgs);
+BENCHMARK_TEMPLATE(BM_MergeInsertSorted, TrivialType, 2)->Apply(MergeInsertArgs);
+BENCHMARK_TEMPLATE(BM_MergeInsertSorted, ComplexType, 0)->Apply(MergeInsertArgs);
+BENCHMARK_TEMPLATE(BM_MergeInsertSorted, ComplexType, 1)->Apply(MergeInsertArgs);
+BENCHMARK_TEMPLATE(BM_MergeInsertSorted, ComplexType, 2)->Apply(MergeInsertArgs);
+
+// =========================================================================
+// BENCHMARK 25: InlinedMatrix vs. Nested InlinedVector
+// =========================================================================
+// A small float matrix kept as InlinedVector<InlinedVector<float, 8>, 4> has
+// one header per row, rows scattered, and one allocation per spilled row.
+// InlinedMatrix<float, 4, 8> keeps a single row-major block. Args are
+// {rows, cols}: inline (4x8), spilled rows (16x16) and large (64x64). The
+// row scan sums every element row by row. The transpose builds a new matrix.
+
+using NestedMatrix = lloyal::InlinedVector<lloyal::InlinedVector<float, 8>, 4>;
+using FlatMatrix = lloyal::InlinedMatrix<float, 4, 8>;
+
+static NestedMatrix MakeNested(size_t rows, size_t cols) {
+    NestedMatrix m;
+    for (size_t i = 0; i < rows; ++i) {
+        m.emplace_back();
+        for (size_t j = 0; j < cols; ++j) m.back().push_back(static_cast<float>(i * cols + j) * 0.5f);
+    }
+    return m;
+}
+
+static FlatMatrix MakeFlat(size_t rows, size_t cols) {
+    FlatMatrix m(rows, cols);
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t j = 0; j < cols; ++j) m(i, j) = static_cast<float>(i * cols + j) * 0.5f;
+    return m;
+}
+
+// Kind 0: nested InlinedVector; 1: InlinedMatrix
+template <int Kind>
+static void BM_Matrix_RowScan(benchmark::State& state) {
+    const size_t rows = static_cast<size_t>(state.range(0)), cols = static_cast<size_t>(state.range(1));
+    [[maybe_unused]] const NestedMatrix nested = MakeNested(rows, cols);
+    [[maybe_unused]] const FlatMatrix flat = MakeFlat(rows, cols);
+    for (auto _ : Measured(state)) {
+        float acc = 0.0f;
+        if constexpr (Kind == 0) {
+            for (const auto& row : nested)
+                for (float x : row) acc += x;
+        } else {
+            for (size_t i = 0; i < flat.rows(); ++i)
+                for (float x : flat.row(i)) acc += x;
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetLabel(Kind == 0 ? "nested" : "inlined_matrix");
+    state.SetItemsProcessed(state.iterations() * rows * cols);
+}
+
+template <int Kind>
+static void BM_Matrix_Transpose(benchmark::State& state) {
+    const size_t rows = static_cast<size_t>(state.range(0)), cols = static_cast<size_t>(state.range(1));
+    [[maybe_unused]] const NestedMatrix nested = MakeNested(rows, cols);
+    [[maybe_unused]] const FlatMatrix flat = MakeFlat(rows, cols);
+    for (auto _ : Measured(state)) {
+        if constexpr (Kind == 0) {
+            NestedMatrix out;
+            out.reserve(cols);
+            for (size_t j = 0; j < cols; ++j) {
+                auto& row = out.emplace_back();
+                row.reserve(rows);
+                for (size_t i = 0; i < rows; ++i) row.push_back(nested[i][j]);
+            }
+            benchmark::DoNotOptimize(out.data());
+        } else {
+            auto out = lloyal::transpose(flat);
+            benchmark::DoNotOptimize(out.data());
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(Kind == 0 ? "nested" : "inlined_matrix");
+    state.SetItemsProcessed(state.iterations() * rows * cols);
+}
+
+static void MatrixArgs(benchmark::internal::Benchmark* b) {
+    for (auto rc : {std::pair<int, int>{4, 8}, {16, 16}, {64, 64}}) b->Args({rc.first, rc.second});
+}
+BENCHMARK_TEMPLATE(BM_Matrix_RowScan, 0)->Apply(MatrixArgs);
+BENCHMARK_TEMPLATE(BM_Matrix_RowScan, 1)->Apply(MatrixArgs);
+BENCHMARK_TEMPLATE(BM_Matrix_Transpose, 0)->Apply(MatrixArgs);
+BENCHMARK_TEMPLATE(BM_Matrix_Transpose, 1)->Apply(MatrixArgs);
+
+// =========================================================================
+// Allocation Accounting (allocs/op, bytes/op for every benchmark)
+// =========================================================================
+
+// Counting global allocator. MemoryManager::Start/Stop bracket the memory
+// pass, which Google Benchmark runs separately after timing. Within it,
+// Measured(state) limits counting to the timed loop, so harness and setup
+// allocations are excluded. Timed runs only pay for a relaxed load.
+namespace {
+std::atomic<int64_t> g_num_allocs{0};
+std::atomic<int64_t> g_alloc_bytes{0};
+
+void* counted_new(std::size_t n) {
+    if (g_count_allocs.load(std::memory_order_relaxed)) {
+        g_num_allocs.fetch_add(1, std::memory_order_relaxed);
+        g_alloc_bytes.fetch_add(static_cast<int64_t>(n), std::memory_order_relaxed);
+    }
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+class CountingMemoryManager : public benchmark::MemoryManager {
+public:
+    void Start() override {
+        g_num_allocs.store(0);
+        g_alloc_bytes.store(0);
+        g_memory_pass.store(true);
+    }
+    void Stop(Result& result) override {
+        g_memory_pass.store(false);
+        g_count_allocs.store(false);
+        allocs_ = g_num_allocs.load();
+        bytes_ = g_alloc_bytes.load();
+        result.num_allocs = allocs_;
+        result.total_allocated_bytes = bytes_;
+    }
+    // Google Benchmark < 1.8 declares the pointer overload pure virtual
+    void Stop(Result* result) { Stop(*result); }
+
+    int64_t allocs() const { return allocs_; }
+    int64_t bytes() const { return bytes_; }
+
+private:
+    int64_t allocs_ = 0;
+    int64_t bytes_ = 0;
+};
+
+CountingMemoryManager g_memory_manager;
+
+// Console output with allocs/op and bytes/op columns. The memory pass for a
+// benchmark completes before its runs are reported, so the manager's last
+// counts belong to the runs being printed.
+class FootprintReporter : public benchmark::ConsoleReporter {
+public:
+    void ReportRuns(const std::vector<Run>& runs) override {
+        std::vector<Run> annotated(runs);
+        for (Run& run : annotated) {
+            // allocs_per_iter = allocs / memory-pass iterations
+            const int64_t allocs = g_memory_manager.allocs();
+            const double iterations = run.allocs_per_iter > 0 ? static_cast<double>(allocs) / run.allocs_per_iter : 1.0;
+            run.counters["allocs/op"] = allocs / iterations;
+            run.counters["bytes/op"] = g_memory_manager.bytes() / iterations;
+        }
+        ConsoleReporter::ReportRuns(annotated);
+    }
+};
+
+// Allocation-free reference: should always report 0 allocs/op
+static void BM_AllocBaseline(benchmark::State& state) {
+    for (auto _ : Measured(state)) benchmark::ClobberMemory();
+}
+BENCHMARK(BM_AllocBaseline)->MinTime(0.001);
+} // namespace
+
+void* operator new(std::size_t n) { return counted_new(n); }
+void* operator new[](std::size_t n) { return counted_new(n); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
 
 // --- Main ---
-BENCHMARK_MAIN();
\ No newline at end of file
+
+// Hardware counters (reported per iteration) for every benchmark when Google
+// Benchmark was built with libpfm. An explicit --benchmark_perf_counters,
+// including an empty one, overrides the default set. If the kernel refuses a
+// counter (perf_event_paranoid, VMs), Google Benchmark drops it and the run
+// continues with wall time only.
+static char kDefaultPerfCounters[] =
+    "--benchmark_perf_counters=INSTRUCTIONS,BRANCH-INSTRUCTIONS,BRANCH-MISSES,L1-DCACHE-LOAD-MISSES";
+
+int main(int argc, char** argv) {
+    std::vector<char*> args(argv, argv + argc);
+#ifdef INLINED_VECTOR_BENCH_PERF_COUNTERS
+    const bool has_perf_flag = std::any_of(args.begin(), args.end(), [](const char* a) {
+        return std::string(a).rfind("--benchmark_perf_counters", 0) == 0;
+    });
+    if (!has_perf_flag) args.insert(args.begin() + 1, kDefaultPerfCounters);
+#else
+    (void)kDefaultPerfCounters;
+#endif
+    int args_count = static_cast<int>(args.size());
+    args.push_back(nullptr);
+    benchmark::Initialize(&args_count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(args_count, args.data())) return 1;
+
+    benchmark::RegisterMemoryManager(&g_memory_manager);
+    // Machine-readable formats already carry allocs_per_iter and
+    // total_allocated_bytes; only the console needs the extra columns.
+    const bool custom_format = std::any_of(args.begin(), args.end() - 1, [](const char* a) {
+        const std::string arg(a);
+        return arg.rfind("--benchmark_format=", 0) == 0 && arg != "--benchmark_format=console";
+    });
+    if (custom_format) {
+        benchmark::RunSpecifiedBenchmarks();
+    } else {
+        FootprintReporter reporter;
+        benchmark::RunSpecifiedBenchmarks(&reporter);
+    }
+    benchmark::Shutdown();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,302 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// The competitors
+#include "inlined_vector.hpp"
+#include "absl/container/inlined_vector.h"
+#include "boost/container/small_vector.hpp"
+
+// =========================================================================
+// Workload benchmark: replays size distributions and operation mixes
+// described by compact trace files (see bench/traces/*.trace).
+//
+// Trace format (one directive per line, '#' starts a comment):
+//
+//   name        <identifier>              benchmark name suffix
+//   seed        <uint>                    RNG seed for the generated plan
+//   containers  <count>                   live containers in the pool
+//   ops         <count>                   operations replayed after build
+//   sizes       <size>:<weight> ...       initial size distribution
+//   mix         <op>:<weight> ...         op mix: push iterate find erase copy
+//
+// Usage:
+//   bench_workload [benchmark flags] [trace files...]
+//
+// With no trace files, every *.trace in INLINED_VECTOR_TRACE_DIR is used.
+// Each iteration builds the pool to its initial sizes, replays the op
+// stream, then destroys the pool. Reported counters:
+//   items_per_second  elements pushed during build + replayed ops
+//   peak_bytes        peak live heap bytes (pool array + spills)
+//   bytes/container   peak_bytes / containers
+// =========================================================================
+
+#ifndef INLINED_VECTOR_TRACE_DIR
+#define INLINED_VECTOR_TRACE_DIR "bench/traces"
+#endif
+
+using ElemType = uint64_t;
+
+// --- Counting global allocator (live and peak heap bytes) ---
+namespace {
+std::atomic<std::size_t> g_live_bytes{0};
+std::atomic<std::size_t> g_peak_bytes{0};
+
+// Size header keeps unsized operator delete accurate
+constexpr std::size_t kHeader = alignof(std::max_align_t);
+
+void note_alloc(std::size_t n) noexcept {
+    const std::size_t live = g_live_bytes.fetch_add(n, std::memory_order_relaxed) + n;
+    std::size_t peak = g_peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak &&
+           !g_peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+}
+
+void* counted_alloc(std::size_t n) {
+    void* raw = std::malloc(n + kHeader);
+    if (!raw) throw std::bad_alloc();
+    *static_cast<std::size_t*>(raw) = n;
+    note_alloc(n);
+    return static_cast<std::byte*>(raw) + kHeader;
+}
+
+void counted_free(void* p) noexcept {
+    if (!p) return;
+    void* raw = static_cast<std::byte*>(p) - kHeader;
+    g_live_bytes.fetch_sub(*static_cast<std::size_t*>(raw), std::memory_order_relaxed);
+    std::free(raw);
+}
+} // namespace
+
+void* operator new(std::size_t n) { return counted_alloc(n); }
+void* operator new[](std::size_t n) { return counted_alloc(n); }
+void operator delete(void* p) noexcept { counted_free(p); }
+void operator delete[](void* p) noexcept { counted_free(p); }
+void operator delete(void* p, std::size_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::size_t) noexcept { counted_free(p); }
+
+// =========================================================================
+// Trace parsing and plan generation
+// =========================================================================
+
+enum class Op : uint8_t { Push, Iterate, Find, Erase, Copy };
+
+struct Step {
+    Op op;
+    uint32_t target;  // container index
+    uint32_t arg;     // value, position or copy source
+};
+
+struct Trace {
+    std::string name;
+    uint32_t seed = 1;
+    uint32_t containers = 1024;
+    uint32_t ops = 16384;
+    std::vector<std::pair<uint32_t, double>> sizes;
+    double mix[5] = {0, 0, 0, 0, 0};
+};
+
+struct Plan {
+    uint32_t containers = 0;
+    std::vector<uint32_t> initial_sizes;
+    std::vector<Step> steps;
+    int64_t items = 0;
+};
+
+// Values stay small so find() hits often, as in key lookups
+constexpr uint32_t kValueRange = 64;
+
+static bool parse_trace(const std::filesystem::path& path, Trace& out) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "bench_workload: cannot open " << path << "\n";
+        return false;
+    }
+    out.name = path.stem().string();
+    std::string line;
+    while (std::getline(in, line)) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream ss(line);
+        std::string key;
+        if (!(ss >> key)) continue;
+        if (key == "name") {
+            ss >> out.name;
+        } else if (key == "seed") {
+            ss >> out.seed;
+        } else if (key == "containers") {
+            ss >> out.containers;
+        } else if (key == "ops") {
+            ss >> out.ops;
+        } else if (key == "sizes" || key == "mix") {
+            std::string pair;
+            while (ss >> pair) {
+                const auto colon = pair.find(':');
+                if (colon == std::string::npos) {
+                    std::cerr << "bench_workload: " << path << ": bad entry '" << pair << "'\n";
+                    return false;
+                }
+                const std::string lhs = pair.substr(0, colon);
+                const double weight = std::stod(pair.substr(colon + 1));
+                if (key == "sizes") {
+                    out.sizes.emplace_back(static_cast<uint32_t>(std::stoul(lhs)), weight);
+                } else {
+                    static const char* names[] = {"push", "iterate", "find", "erase", "copy"};
+                    const auto it = std::find(std::begin(names), std::end(names), lhs);
+                    if (it == std::end(names)) {
+                        std::cerr << "bench_workload: " << path << ": unknown op '" << lhs << "'\n";
+                        return false;
+                    }
+                    out.mix[it - std::begin(names)] = weight;
+                }
+            }
+        } else {
+            std::cerr << "bench_workload: " << path << ": unknown directive '" << key << "'\n";
+            return false;
+        }
+    }
+    if (out.sizes.empty() || out.containers == 0 ||
+        std::accumulate(std::begin(out.mix), std::end(out.mix), 0.0) <= 0.0) {
+        std::cerr << "bench_workload: " << path << ": needs 'sizes', 'containers' and 'mix'\n";
+        return false;
+    }
+    return true;
+}
+
+static Plan make_plan(const Trace& t) {
+    Plan plan;
+    plan.containers = t.containers;
+    std::mt19937 rng(t.seed);
+
+    std::vector<double> size_weights;
+    for (const auto& [size, weight] : t.sizes) size_weights.push_back(weight);
+    std::discrete_distribution<std::size_t> size_dist(size_weights.begin(), size_weights.end());
+    std::discrete_distribution<int> op_dist(std::begin(t.mix), std::end(t.mix));
+    std::uniform_int_distribution<uint32_t> pick(0, t.containers - 1);
+
+    plan.initial_sizes.reserve(t.containers);
+    for (uint32_t i = 0; i < t.containers; ++i) {
+        plan.initial_sizes.push_back(t.sizes[size_dist(rng)].first);
+        plan.items += plan.initial_sizes.back();
+    }
+
+    plan.steps.reserve(t.ops);
+    for (uint32_t i = 0; i < t.ops; ++i) {
+        const Op op = static_cast<Op>(op_dist(rng));
+        const uint32_t target = pick(rng);
+        const uint32_t arg = (op == Op::Copy) ? pick(rng) : static_cast<uint32_t>(rng());
+        plan.steps.push_back({op, target, arg});
+    }
+    plan.items += t.ops;
+    return plan;
+}
+
+// =========================================================================
+// Replay
+// =========================================================================
+
+template <typename VecType>
+static void replay(const Plan& plan) {
+    std::vector<VecType> pool(plan.containers);
+    for (uint32_t i = 0; i < plan.containers; ++i) {
+        for (uint32_t j = 0; j < plan.initial_sizes[i]; ++j) {
+            pool[i].push_back(static_cast<ElemType>((i + j) % kValueRange));
+        }
+    }
+    for (const Step& s : plan.steps) {
+        VecType& v = pool[s.target];
+        switch (s.op) {
+            case Op::Push:
+                v.push_back(static_cast<ElemType>(s.arg % kValueRange));
+                break;
+            case Op::Iterate: {
+                ElemType sum = 0;
+                for (const ElemType& e : v) sum += e;
+                benchmark::DoNotOptimize(sum);
+                break;
+            }
+            case Op::Find:
+                benchmark::DoNotOptimize(
+                    std::find(v.begin(), v.end(), static_cast<ElemType>(s.arg % kValueRange)));
+                break;
+            case Op::Erase:
+                if (!v.empty()) v.erase(v.begin() + (s.arg % v.size()));
+                break;
+            case Op::Copy:
+                if (s.arg != s.target) v = pool[s.arg];
+                break;
+        }
+    }
+    benchmark::ClobberMemory();
+}
+
+template <typename VecType>
+static void BM_Workload(benchmark::State& state, std::shared_ptr<const Plan> plan) {
+    std::size_t peak = 0;
+    for (auto _ : state) {
+        const std::size_t base = g_live_bytes.load(std::memory_order_relaxed);
+        g_peak_bytes.store(base, std::memory_order_relaxed);
+        replay<VecType>(*plan);
+        peak = std::max(peak, g_peak_bytes.load(std::memory_order_relaxed) - base);
+    }
+    state.SetItemsProcessed(state.iterations() * plan->items);
+    state.counters["peak_bytes"] = static_cast<double>(peak);
+    state.counters["bytes/container"] = static_cast<double>(peak) / plan->containers;
+}
+
+template <typename VecType>
+static void register_workload(const std::string& container, const std::string& trace,
+                              const std::shared_ptr<const Plan>& plan) {
+    benchmark::RegisterBenchmark(("BM_Workload<" + container + ">/" + trace).c_str(),
+                                 BM_Workload<VecType>, plan);
+}
+
+static void register_trace(const Trace& t) {
+    const auto plan = std::make_shared<const Plan>(make_plan(t));
+    register_workload<std::vector<ElemType>>("std::vector", t.name, plan);
+    register_workload<lloyal::InlinedVector<ElemType, 4>>("lloyal::InlinedVector<4>", t.name, plan);
+    register_workload<lloyal::InlinedVector<ElemType, 16>>("lloyal::InlinedVector<16>", t.name, plan);
+    register_workload<absl::InlinedVector<ElemType, 4>>("absl::InlinedVector<4>", t.name, plan);
+    register_workload<absl::InlinedVector<ElemType, 16>>("absl::InlinedVector<16>", t.name, plan);
+    register_workload<boost::container::small_vector<ElemType, 4>>("boost::small_vector<4>", t.name, plan);
+    register_workload<boost::container::small_vector<ElemType, 16>>("boost::small_vector<16>", t.name, plan);
+}
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+
+    // Remaining arguments are trace files; default to the shipped traces
+    std::vector<std::filesystem::path> paths(argv + 1, argv + argc);
+    if (paths.empty()) {
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(INLINED_VECTOR_TRACE_DIR, ec)) {
+            if (entry.path().extension() == ".trace") paths.push_back(entry.path());
+        }
+        std::sort(paths.begin(), paths.end());
+        if (paths.empty()) {
+            std::cerr << "bench_workload: no traces found in " << INLINED_VECTOR_TRACE_DIR << "\n";
+            return 1;
+        }
+    }
+
+    for (const auto& path : paths) {
+        Trace t;
+        if (!parse_trace(path, t)) return 1;
+        register_trace(t);
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
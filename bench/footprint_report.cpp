@@ -0,0 +1,77 @@
+// Footprint report: sizeof() for every container configuration.
+//
+// Prints one row per (T, N, allocator) with the object size of std::vector,
+// lloyal::InlinedVector, absl::InlinedVector and boost::small_vector, plus the
+// overhead each SBO container carries beyond its N * sizeof(T) inline buffer.
+// Allocation counts and bytes per operation are reported by
+// bench_inlined_vector (allocs/op, bytes/op columns).
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "inlined_vector.hpp"
+#include "absl/container/inlined_vector.h"
+#include "boost/container/small_vector.hpp"
+
+// Stateful allocator (one int of state), as BenchAllocator in the benchmarks
+template <typename T> struct StatefulAllocator {
+    using value_type = T;
+    int id = 0;
+
+    StatefulAllocator(int i = 0) noexcept : id(i) {}
+    template <typename U> StatefulAllocator(const StatefulAllocator<U>& other) noexcept : id(other.id) {}
+
+    T* allocate(std::size_t n) { return std::allocator<T>{}.allocate(n); }
+    void deallocate(T* p, std::size_t n) { std::allocator<T>{}.deallocate(p, n); }
+
+    using is_always_equal = std::false_type;
+    friend bool operator==(const StatefulAllocator& a, const StatefulAllocator& b) { return a.id == b.id; }
+    friend bool operator!=(const StatefulAllocator& a, const StatefulAllocator& b) { return a.id != b.id; }
+};
+
+template <typename T> using StdAllocator = std::allocator<T>;
+template <typename T> using PmrAllocator = std::pmr::polymorphic_allocator<T>;
+
+template <typename T, std::size_t N, template <typename> class A>
+static void row(const char* type_name, const char* alloc_name) {
+    constexpr std::size_t inline_bytes = N * sizeof(T);
+    constexpr std::size_t vec = sizeof(std::vector<T, A<T>>);
+    constexpr std::size_t lloyal_sz = sizeof(lloyal::InlinedVector<T, N, A<T>>);
+    constexpr std::size_t absl_sz = sizeof(absl::InlinedVector<T, N, A<T>>);
+    constexpr std::size_t boost_sz = sizeof(boost::container::small_vector<T, N, A<T>>);
+    std::printf("%-18s %4zu  %-10s %7zu %7zu  %7zu (+%3zu)  %7zu (+%3zu)  %7zu (+%3zu)\n",
+                type_name, N, alloc_name, inline_bytes, vec,
+                lloyal_sz, lloyal_sz - inline_bytes,
+                absl_sz, absl_sz - inline_bytes,
+                boost_sz, boost_sz - inline_bytes);
+}
+
+template <typename T, template <typename> class A>
+static void rows_for_n(const char* type_name, const char* alloc_name) {
+    row<T, 1, A>(type_name, alloc_name);
+    row<T, 4, A>(type_name, alloc_name);
+    row<T, 16, A>(type_name, alloc_name);
+    row<T, 64, A>(type_name, alloc_name);
+}
+
+template <typename T>
+static void rows_for_type(const char* type_name) {
+    rows_for_n<T, StdAllocator>(type_name, "std");
+    rows_for_n<T, StatefulAllocator>(type_name, "stateful");
+    rows_for_n<T, PmrAllocator>(type_name, "pmr");
+}
+
+int main() {
+    std::printf("sizeof() in bytes; (+k) = overhead beyond the N * sizeof(T) inline buffer\n\n");
+    std::printf("%-18s %4s  %-10s %7s %7s  %13s  %13s  %13s\n",
+                "T", "N", "Allocator", "inline", "vector", "lloyal", "absl", "boost");
+    rows_for_type<uint8_t>("uint8_t");
+    rows_for_type<uint64_t>("uint64_t");
+    rows_for_type<std::string>("std::string");
+    rows_for_type<std::unique_ptr<int>>("std::unique_ptr");
+    return 0;
+}
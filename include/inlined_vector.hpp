@@ -10,15 +10,26 @@
 
 #pragma once
 
-#include <algorithm> // For std::min, std::equal, std::lexicographical_compare
+#include <algorithm> // For std::min, std::equal, std::lexicographical_compare, std::sort, std::rotate
+#include <functional> // For std::less
+#include <initializer_list>
+#include <array>     // For std::array (sorting networks)
+#include <atomic>    // For std::atomic (InlinedSpscRing, CowInlinedVector)
 #include <cassert>
+#include <climits>   // For CHAR_BIT (memory_usage_traits<std::vector<bool>>)
+#include <cmath>     // For std::sqrt (numeric norm)
 #include <cstddef>
+#include <cstdint>   // For std::uintptr_t
 #include <cstring>   // For std::memmove, std::memcpy
 #include <iterator>  // For std::reverse_iterator, std::distance, std::make_move_iterator
 #include <limits>    // For std::numeric_limits
 #include <memory>    // For std::allocator, std::allocator_traits, std::to_address
+#include <mutex>     // For std::mutex (AtomicInlinedVectorSnapshot writers)
 #include <new>       // For std::launder
+#include <optional>  // For std::optional (InlinedSpscRing::try_pop)
 #include <stdexcept> // For std::out_of_range
+#include <string>    // For std::basic_string (memory_usage_traits)
+#include <thread>    // For std::this_thread::yield (AtomicInlinedVectorSnapshot::synchronize)
 #include <type_traits> // For type traits used throughout
 #include <utility>   // For std::swap, std::move, std::forward
 #include <variant>   // For std::variant, std::get_if, std::holds_alternative
@@ -31,6 +42,37 @@
 #define LLOYAL_NO_UNIQUE_ADDRESS
 #endif
 
+// Numeric expression leaves must inline into the caller's loop nest
+#if defined(__GNUC__) || defined(__clang__)
+#define LLOYAL_ALWAYS_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define LLOYAL_ALWAYS_INLINE __forceinline
+#else
+#define LLOYAL_ALWAYS_INLINE inline
+#endif
+
+#if __cplusplus >= 202002L && __has_include(<bit>)
+#include <bit> // For std::bit_width
+#endif
+
+// std::source_location keys AdaptiveInlinedVector's statistics by call site (C++20)
+#if __cplusplus >= 202002L && __has_include(<source_location>)
+#include <source_location>
+#define LLOYAL_HAS_SOURCE_LOCATION 1
+#else
+#define LLOYAL_HAS_SOURCE_LOCATION 0
+#endif
+
+// std::mdspan interop for InlinedMatrix views (C++23)
+#if __cplusplus > 202002L && __has_include(<mdspan>)
+#include <mdspan>
+#endif
+#if defined(__cpp_lib_mdspan) && __cpp_lib_mdspan >= 202207L
+#define LLOYAL_HAS_MDSPAN 1
+#else
+#define LLOYAL_HAS_MDSPAN 0
+#endif
+
 
 namespace lloyal {
 
@@ -45,6 +87,246 @@ constexpr T* construct_at(T* p, Args&&... args) {
 #endif
 } // namespace detail
 
+/**
+ * @brief Customization point for `InlinedVector::memory_usage()`.
+ *
+ * Reports the heap bytes owned by a `T` beyond `sizeof(T)`. The primary template
+ * reports zero with `has_heap = false`, which lets `memory_usage()` answer in O(1)
+ * without visiting elements. Specialize it for element types that own heap storage.
+ */
+template<typename T, typename = void>
+struct memory_usage_traits {
+    static constexpr bool has_heap = false;
+    static std::size_t heap_bytes(const T&) noexcept { return 0; }
+};
+
+/** @brief Strings own heap storage only once they outgrow their SSO buffer. */
+template<typename CharT, typename Traits, typename A>
+struct memory_usage_traits<std::basic_string<CharT, Traits, A>> {
+    static constexpr bool has_heap = true;
+    static std::size_t heap_bytes(const std::basic_string<CharT, Traits, A>& s) noexcept {
+        const auto* obj = reinterpret_cast<const std::byte*>(std::addressof(s));
+        const auto* buf = reinterpret_cast<const std::byte*>(s.data());
+        if (buf >= obj && buf < obj + sizeof(s)) return 0; // SSO: characters live inside the object
+        return (s.capacity() + 1) * sizeof(CharT);
+    }
+};
+
+/** @brief `std::vector` owns its capacity plus whatever its elements own. */
+template<typename U, typename A>
+struct memory_usage_traits<std::vector<U, A>> {
+    static constexpr bool has_heap = true;
+    static std::size_t heap_bytes(const std::vector<U, A>& v) noexcept {
+        std::size_t bytes = v.capacity() * sizeof(U);
+        if constexpr (memory_usage_traits<U>::has_heap) {
+            for (const auto& e : v) bytes += memory_usage_traits<U>::heap_bytes(e);
+        }
+        return bytes;
+    }
+};
+
+/** @brief `std::vector<bool>` packs bits, so its `capacity()` counts bits, not bytes. */
+template<typename A>
+struct memory_usage_traits<std::vector<bool, A>> {
+    static constexpr bool has_heap = true;
+    static std::size_t heap_bytes(const std::vector<bool, A>& v) noexcept {
+        return (v.capacity() + CHAR_BIT - 1) / CHAR_BIT;
+    }
+};
+
+/**
+ * @brief Customization point marking "wink-out" allocators, whose memory is
+ * reclaimed all at once (a request-scoped monotonic arena, for example).
+ *
+ * For these allocators `InlinedVector` and `InlinedVectorRef` never call
+ * `deallocate`. Their destructors also skip trivially destructible elements
+ * entirely, so tearing down many vectors costs O(1) each. Opt in by declaring
+ * `using is_wink_out = std::true_type;` in the allocator or by specializing
+ * this trait.
+ */
+template<typename Alloc, typename = void>
+struct is_wink_out_allocator : std::false_type {};
+
+template<typename Alloc>
+struct is_wink_out_allocator<Alloc, std::void_t<typename Alloc::is_wink_out>> : Alloc::is_wink_out {};
+
+template<typename Alloc>
+inline constexpr bool is_wink_out_allocator_v = is_wink_out_allocator<Alloc>::value;
+
+/**
+ * @brief Customization point for allocators that size `InlinedVector`'s first
+ * spill from feedback.
+ *
+ * Such an allocator provides `spill_capacity_hint() const`, the capacity to
+ * reserve when the inline buffer overflows (0 keeps the default growth), and
+ * `record_spilled_size(std::size_t) const`, which a vector that spilled calls
+ * with its size when destroyed. Only the spill and destruction paths consult
+ * it; `AdaptiveInlinedVector` is built on it.
+ */
+template<typename Alloc, typename = void>
+struct has_spill_feedback : std::false_type {};
+
+template<typename Alloc>
+struct has_spill_feedback<Alloc, std::void_t<
+    decltype(std::size_t{std::declval<const Alloc&>().spill_capacity_hint()}),
+    decltype(std::declval<const Alloc&>().record_spilled_size(std::size_t{}))>> : std::true_type {};
+
+template<typename Alloc>
+inline constexpr bool has_spill_feedback_v = has_spill_feedback<Alloc>::value;
+
+/**
+ * @brief Allocator adaptor that over-aligns every allocation to `Align` bytes.
+ *
+ * Allocates `n * sizeof(T) + Align - 1 + sizeof(void*)` bytes from `Alloc`
+ * (rebound to `std::byte`), returns the first `Align`-aligned address past a
+ * stored back-pointer, and recovers the original block on deallocation. Works
+ * with any allocator, including `std::pmr::polymorphic_allocator`. Element
+ * construction and destruction are forwarded to `Alloc`, so uses-allocator
+ * construction is preserved.
+ *
+ * @tparam Alloc The underlying allocator.
+ * @tparam Align Required alignment in bytes; a power of two.
+ */
+template<typename Alloc, std::size_t Align>
+class aligned_allocator_adaptor {
+    static_assert(Align > 0 && (Align & (Align - 1)) == 0, "Align must be a power of two");
+
+    using BaseTraits = std::allocator_traits<Alloc>;
+    using ByteAlloc = typename BaseTraits::template rebind_alloc<std::byte>;
+    using ByteTraits = std::allocator_traits<ByteAlloc>;
+
+    template<typename, std::size_t> friend class aligned_allocator_adaptor;
+    LLOYAL_NO_UNIQUE_ADDRESS Alloc base_;
+
+public:
+    using value_type = typename BaseTraits::value_type;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_copy_assignment = typename BaseTraits::propagate_on_container_copy_assignment;
+    using propagate_on_container_move_assignment = typename BaseTraits::propagate_on_container_move_assignment;
+    using propagate_on_container_swap = typename BaseTraits::propagate_on_container_swap;
+    using is_always_equal = typename BaseTraits::is_always_equal;
+
+    template<typename U> struct rebind {
+        using other = aligned_allocator_adaptor<typename BaseTraits::template rebind_alloc<U>, Align>;
+    };
+
+    /** @brief The alignment every allocation is guaranteed to have. */
+    static constexpr std::size_t alignment = Align;
+    /** @brief Bytes added to every request: alignment slack plus the back-pointer. */
+    static constexpr std::size_t overhead = Align - 1 + sizeof(void*);
+
+    aligned_allocator_adaptor() noexcept(std::is_nothrow_default_constructible_v<Alloc>) = default;
+    /** @brief Implicit, so containers can be handed the underlying allocator directly. */
+    aligned_allocator_adaptor(const Alloc& base) noexcept : base_(base) {}
+    template<typename U>
+    aligned_allocator_adaptor(const aligned_allocator_adaptor<U, Align>& other) noexcept : base_(other.base_) {}
+
+    /** @brief Returns the underlying allocator. */
+    const Alloc& base() const noexcept { return base_; }
+
+    [[nodiscard]] value_type* allocate(size_type n) {
+        if (n > max_size()) throw std::bad_array_new_length();
+        ByteAlloc bytes_alloc(base_);
+        std::byte* raw = &*ByteTraits::allocate(bytes_alloc, n * sizeof(value_type) + overhead);
+        const auto base_addr = reinterpret_cast<std::uintptr_t>(raw);
+        const std::uintptr_t aligned_addr = (base_addr + sizeof(void*) + Align - 1) & ~std::uintptr_t(Align - 1);
+        std::byte* aligned = raw + (aligned_addr - base_addr);
+        std::memcpy(aligned - sizeof(void*), &raw, sizeof(void*));
+        return reinterpret_cast<value_type*>(aligned);
+    }
+
+    void deallocate(value_type* p, size_type n) noexcept {
+        std::byte* raw;
+        std::memcpy(&raw, reinterpret_cast<std::byte*>(p) - sizeof(void*), sizeof(void*));
+        ByteAlloc bytes_alloc(base_);
+        ByteTraits::deallocate(bytes_alloc, std::pointer_traits<typename ByteTraits::pointer>::pointer_to(*raw),
+                               n * sizeof(value_type) + overhead);
+    }
+
+    size_type max_size() const noexcept {
+        return (std::numeric_limits<size_type>::max() - overhead) / sizeof(value_type);
+    }
+
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args) { BaseTraits::construct(base_, p, std::forward<Args>(args)...); }
+    template<typename U>
+    void destroy(U* p) noexcept { BaseTraits::destroy(base_, p); }
+
+    aligned_allocator_adaptor select_on_container_copy_construction() const {
+        return aligned_allocator_adaptor(BaseTraits::select_on_container_copy_construction(base_));
+    }
+
+    template<typename U>
+    friend bool operator==(const aligned_allocator_adaptor& a, const aligned_allocator_adaptor<U, Align>& b) noexcept {
+        return a.base_ == b.base_;
+    }
+    template<typename U>
+    friend bool operator!=(const aligned_allocator_adaptor& a, const aligned_allocator_adaptor<U, Align>& b) noexcept {
+        return !(a == b);
+    }
+};
+
+namespace detail {
+/**
+ * @brief Heap allocator for wink-out `Base`: identical, except `deallocate` and
+ * trivial `destroy` are no-ops, so `std::vector` never returns storage to the
+ * arena or walks trivially destructible elements.
+ */
+template<typename Base>
+class wink_out_allocator_adaptor : public Base {
+    using BaseTraits = std::allocator_traits<Base>;
+
+public:
+    template<typename U>
+    struct rebind { using other = wink_out_allocator_adaptor<typename BaseTraits::template rebind_alloc<U>>; };
+
+    template<typename A, std::enable_if_t<std::is_constructible_v<Base, const A&>, int> = 0>
+    wink_out_allocator_adaptor(const A& a) noexcept : Base(a) {} // Implicit: HeapVec(alloc_)
+
+    void deallocate(typename BaseTraits::pointer, std::size_t) noexcept {}
+
+    /** @brief Skips trivial destruction, so `~vector` has no per-element loop. */
+    template<typename U>
+    void destroy(U* p) {
+        if constexpr (!std::is_trivially_destructible_v<U>) BaseTraits::destroy(static_cast<Base&>(*this), p);
+    }
+
+    wink_out_allocator_adaptor select_on_container_copy_construction() const {
+        return wink_out_allocator_adaptor(BaseTraits::select_on_container_copy_construction(*this));
+    }
+};
+
+/**
+ * @brief One `T` built through `Alloc` in local storage and destroyed through it,
+ * for inserts whose arguments may alias the container. Unlike a plain local `T`,
+ * it keeps uses-allocator construction (pmr, scoped allocators).
+ */
+template<typename T, typename Alloc>
+class temporary_value {
+    using Traits = std::allocator_traits<Alloc>;
+    Alloc& alloc_;
+    alignas(T) std::byte bytes_[sizeof(T)];
+
+public:
+    template<typename... Args>
+    explicit temporary_value(Alloc& alloc, Args&&... args) : alloc_(alloc) {
+        Traits::construct(alloc_, reinterpret_cast<T*>(bytes_), std::forward<Args>(args)...);
+    }
+    temporary_value(const temporary_value&) = delete;
+    temporary_value& operator=(const temporary_value&) = delete;
+    ~temporary_value() { Traits::destroy(alloc_, get()); }
+
+    T* get() noexcept { return std::launder(reinterpret_cast<T*>(bytes_)); }
+};
+} // namespace detail
+
+/** @brief How `InlinedVector::merge_insert_sorted` treats keys equivalent to ones already present. */
+enum class merge_duplicates {
+    keep, ///< Insert every key. A new key goes before existing equivalents, as with `insert(lower_bound(...))`.
+    skip  ///< Insert a key only if no equivalent is present. Runs of equivalent keys insert once.
+};
+
 /**
  * @brief A std::vector-like container optimized for small sizes using
  * Small Buffer Optimization (SBO).
@@ -65,6 +347,10 @@ constexpr T* construct_at(T* p, Args&&... args) {
  * @tparam N The number of elements to store inline. Must be greater than 0.
  * This defines the threshold for switching to heap allocation.
  * @tparam Alloc The allocator type. Defaults to `std::allocator<T>`.
+ * @tparam Align Alignment of the inline buffer and of heap allocations, in bytes.
+ * Defaults to `alignof(T)`. Larger values (e.g. 32 or 64 for AVX/AVX-512 loads)
+ * route heap storage through `aligned_allocator_adaptor<Alloc, Align>`; see the
+ * `alignment` static member.
  *
  * @note Exception Safety: Provides the strong exception safety guarantee for most
  * operations if `T`'s move/swap operations are `noexcept` or if copy operations
@@ -79,10 +365,12 @@ constexpr T* construct_at(T* p, Args&&... args) {
  * `reserve`, `shrink_to_fit`, or a `push_back`/`insert` that crosses capacity `N`).
  *
  * @note Non-Assignable Types: Supports non-assignable (but MoveConstructible) types
- * for `insert` and `erase` operations in both inline and heap modes by using
- * internal rebuild-and-swap logic instead of direct assignment where necessary.
+ * for `insert` and `erase` operations in both inline and heap modes. If `T` is
+ * nothrow-move-constructible, elements are shifted in place by relocation
+ * (move-construct + destroy); only types with throwing moves fall back to
+ * internal rebuild-and-swap logic.
  */
-template<typename T, std::size_t N, typename Alloc = std::allocator<T>>
+template<typename T, std::size_t N, typename Alloc = std::allocator<T>, std::size_t Align = alignof(T)>
 class InlinedVector {
 public:
     // --- Public Member Types ---
@@ -111,11 +399,16 @@ public:
     static_assert(std::is_object_v<T> && !std::is_const_v<T> && !std::is_volatile_v<T>,
                   "InlinedVector requires T to be a non-cv object type");
     static_assert(std::is_move_constructible_v<T>, "InlinedVector requires T to be MoveConstructible");
+    static_assert(Align >= alignof(T) && (Align & (Align - 1)) == 0,
+                  "InlinedVector requires Align to be a power of two no smaller than alignof(T)");
 
     // --- Static Constants ---
     /** @brief The number of elements that can be stored inline without heap allocation. */
     static constexpr size_type inline_capacity = N;
 
+    /** @brief Guaranteed alignment of `data()` in both inline and heap modes. */
+    static constexpr size_type alignment = Align;
+
     /**
      * @brief A compile-time constant indicating whether operations generally
      * provide the strong exception guarantee, based on `T`'s move/swap properties.
@@ -128,7 +421,17 @@ public:
 private:
     // --- Private Member Types ---
     using AllocTraits = std::allocator_traits<Alloc>;
-    using HeapVec = std::vector<T, Alloc>;
+    // Over-aligned heap storage goes through the adaptor; the default keeps plain Alloc, and so does
+    // std::allocator up to the alignment operator new already guarantees
+    static constexpr bool adapt_align_ = Align > alignof(T) &&
+        !(std::is_same_v<Alloc, std::allocator<T>> && Align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    using AlignedAlloc = std::conditional_t<adapt_align_, aligned_allocator_adaptor<Alloc, Align>, Alloc>;
+    // Wink-out: the arena reclaims heap blocks, so the vector never deallocates
+    static constexpr bool wink_out_ = is_wink_out_allocator_v<Alloc>;
+    using HeapAlloc = std::conditional_t<wink_out_, detail::wink_out_allocator_adaptor<AlignedAlloc>, AlignedAlloc>;
+    using HeapVec = std::vector<T, HeapAlloc>;
+    // Spill feedback: the allocator picks the first heap capacity and hears the final size
+    static constexpr bool spill_feedback_ = has_spill_feedback_v<Alloc>;
 
     // ========================================================================
     // InlineBuf: Internal POD struct holding the inline buffer and size.
@@ -136,7 +439,7 @@ private:
     // slow-path rebuilds in `insert` and `erase`.
     // ========================================================================
     struct InlineBuf {
-        alignas(T) std::byte buf[sizeof(T) * N];
+        alignas(Align) std::byte buf[sizeof(T) * N];
         size_type size = 0;
         InlinedVector* parent_ = nullptr; // Pointer to parent for allocator-aware ops
 
@@ -167,8 +470,19 @@ private:
 
         void swap(InlineBuf& other) noexcept(std::is_nothrow_swappable_v<T> && std::is_nothrow_move_constructible_v<T>) {
             using std::swap; size_type min_sz = std::min(size, other.size);
-            for (size_type i = 0; i < min_sz; ++i) swap(ptr()[i], other.ptr()[i]);
-            
+            for (size_type i = 0; i < min_sz; ++i) {
+                if constexpr (std::is_swappable_v<T>) {
+                    swap(ptr()[i], other.ptr()[i]);
+                } else {
+                    // Non-assignable: swap by relocation through a temporary
+                    T tmp(std::move(ptr()[i]));
+                    parent_->destroy_at_(ptr() + i);
+                    parent_->construct_at_(ptr() + i, std::move(other.ptr()[i]));
+                    other.parent_->destroy_at_(other.ptr() + i);
+                    other.parent_->construct_at_(other.ptr() + i, std::move(tmp));
+                }
+            }
+
             if (size > other.size) {
                 // move tail from *this into other (use other's allocator), then destroy in *this (use this->allocator)
                 for (size_type i = min_sz; i < size; ++i) {
@@ -202,7 +516,7 @@ private:
     // ========================================================================
 
     /** @brief Returns a pointer to static, aligned, non-constructed storage. Used as a non-null sentinel for empty ranges. */
-    static std::byte* empty_bytes_() noexcept { alignas(T) static std::byte s_empty_buf[sizeof(T)]; return s_empty_buf; }
+    static std::byte* empty_bytes_() noexcept { alignas(Align) static std::byte s_empty_buf[sizeof(T)]; return s_empty_buf; }
     /** @brief Returns a `const_pointer` sentinel for empty ranges. */
     static const T* empty_sentinel_c() noexcept { return reinterpret_cast<const T*>(empty_bytes_()); }
     /** @brief Returns a `pointer` sentinel for empty ranges. */
@@ -220,6 +534,185 @@ private:
     /** @brief Checks if storage is currently inline (or valueless, treated as inline). Non-mutating. */
     bool is_inline() const noexcept { if (is_valueless_()) return true; return std::holds_alternative<InlineBuf>(storage_); }
 
+    /** @brief First-spill capacity suggested by a spill-feedback allocator (0: none). */
+    size_type spill_hint_() const noexcept {
+        if constexpr (spill_feedback_) return alloc_.spill_capacity_hint(); else return 0;
+    }
+    /** @brief Capacity of the heap block that `old_size` inline elements spill into. */
+    size_type first_spill_capacity_(size_type old_size) const noexcept {
+        const size_type hint = spill_hint_();
+        return hint > old_size ? hint : std::max<size_type>(N * 2, old_size + (old_size >> 1) + 1);
+    }
+
+    // ========================================================================
+    // Relocation helpers (move-construct + destroy, no assignment)
+    // Used by insert/erase for non-assignable, nothrow-move-constructible T.
+    // ========================================================================
+
+    /** @brief True if in-place relocation can be used instead of a rebuild. */
+    static constexpr bool relocatable_ = std::is_nothrow_move_constructible_v<T>;
+
+    /**
+     * @brief Relocates `[idx, size)` one slot right, leaving `p[idx]` as raw storage.
+     * @pre `p[size]` is raw storage.
+     */
+    void relocate_right_(pointer p, size_type size, size_type idx) noexcept {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memmove(static_cast<void*>(p + idx + 1), static_cast<const void*>(p + idx), (size - idx) * sizeof(T));
+        } else {
+            for (size_type i = size; i > idx; --i) { construct_at_(p + i, std::move(p[i - 1])); destroy_at_(p + i - 1); }
+        }
+    }
+
+    /**
+     * @brief Inverse of `relocate_right_`: relocates `[idx + 1, size + 1)` one slot left,
+     * leaving `p[size]` as raw storage. @pre `p[idx]` is raw storage.
+     */
+    void relocate_left_(pointer p, size_type size, size_type idx) noexcept {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memmove(static_cast<void*>(p + idx), static_cast<const void*>(p + idx + 1), (size - idx) * sizeof(T));
+        } else {
+            for (size_type i = idx; i < size; ++i) { construct_at_(p + i, std::move(p[i + 1])); destroy_at_(p + i + 1); }
+        }
+    }
+
+    /**
+     * @brief Replaces `[start, start + cnt)` with the elements following it, by
+     * destroying each target slot and move-constructing into it.
+     * @post `[size - cnt, size)` still holds live (erased or moved-from) objects,
+     * which the caller must destroy (inline) or `pop_back` (heap).
+     */
+    void relocate_down_(pointer p, size_type size, size_type start, size_type cnt) noexcept {
+        const size_type keep = size - cnt;
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memmove(static_cast<void*>(p + start), static_cast<const void*>(p + start + cnt), (keep - start) * sizeof(T));
+        } else {
+            for (size_type i = start; i < keep; ++i) { destroy_at_(p + i); construct_at_(p + i, std::move(p[i + cnt])); }
+        }
+    }
+
+    /**
+     * @brief Heap-mode insert by in-place relocation. Grows through `emplace_back`
+     * (so `std::vector` owns the growth policy), then shifts the tail.
+     * Strong guarantee: if constructing `src` throws, the tail is shifted back.
+     */
+    template<class U>
+    void heap_insert_relocate_(HeapVec& vec, size_type idx, U&& src) {
+        const size_type old_size = vec.size();
+        if (idx == old_size) { vec.emplace_back(std::forward<U>(src)); return; }
+        vec.emplace_back(std::move(vec.back())); // May reallocate; back() is now moved-from
+        pointer p = vec.data();
+        destroy_at_(p + old_size - 1);
+        relocate_right_(p, old_size - 1, idx);
+        try {
+            construct_at_(p + idx, std::forward<U>(src));
+        } catch (...) {
+            relocate_left_(p, old_size - 1, idx);
+            construct_at_(p + old_size - 1, std::move(p[old_size]));
+            vec.pop_back();
+            throw;
+        }
+    }
+
+    /** @brief Heap-mode erase of `[start, start + cnt)` by in-place relocation. */
+    void heap_erase_relocate_(HeapVec& vec, size_type start, size_type cnt) noexcept {
+        relocate_down_(vec.data(), vec.size(), start, cnt);
+        for (size_type i = 0; i < cnt; ++i) vec.pop_back();
+    }
+
+    /**
+     * @brief Grows `vec` by `cnt` slots and ends their lifetimes, leaving
+     * `[size, size + cnt)` as raw storage for the caller to construct before
+     * anything observes `vec`. Placeholders are moved-from copies of the last
+     * element, as in `heap_insert_relocate_`.
+     * @pre `vec.capacity() >= vec.size() + cnt` and `!vec.empty()`.
+     */
+    void heap_open_tail_(HeapVec& vec, size_type cnt) noexcept {
+        const size_type old_size = vec.size();
+        for (size_type i = 0; i < cnt; ++i) vec.emplace_back(std::move(vec[old_size - 1])); // No reallocation
+        pointer p = vec.data();
+        destroy_at_(p + old_size - 1);
+        construct_at_(p + old_size - 1, std::move(p[old_size])); // The real last element, moved back
+        destroy_n_(p + old_size, cnt);
+    }
+
+    // ========================================================================
+    // Sorted-merge helpers for merge_insert_sorted
+    // ========================================================================
+
+    /** @brief Number of keys in sorted `[first, last)` that `merge_duplicates::skip` would insert. */
+    template<typename ForwardIt, typename Compare>
+    size_type count_new_keys_(ForwardIt first, ForwardIt last, Compare& comp) const {
+        const_pointer p = data(); const size_type n = size();
+        size_type cnt = 0, i = 0;
+        for (ForwardIt prev = first, it = first; it != last; prev = it, ++it) {
+            if (it != first && !comp(*prev, *it)) continue; // Repeats the previous key
+            i = static_cast<size_type>(std::lower_bound(p + i, p + n, *it, comp) - p);
+            if (i < n && !comp(*it, p[i])) continue;        // Already present
+            ++cnt;
+        }
+        return cnt;
+    }
+
+    /**
+     * @brief Forward merge of the current elements (moved out) and `[first, last)`
+     * onto the end of `out`. Each key binary-searches its position, and the run
+     * of elements before it moves as a block.
+     */
+    template<typename Out, typename InputIt, typename Compare>
+    void merge_forward_(Out& out, InputIt first, InputIt last, Compare& comp, bool unique) {
+        pointer p = data(); const size_type n = size();
+        auto append_run = [&](size_type from, size_type to) {
+            if constexpr (std::is_same_v<Out, HeapVec> && std::is_trivially_copyable_v<T> && std::is_move_assignable_v<T>) {
+                out.insert(out.end(), p + from, p + to); // One memmove; capacity is reserved
+            } else {
+                for (; from < to; ++from) out.emplace_back(std::move_if_noexcept(p[from]));
+            }
+        };
+        size_type i = 0;
+        for (; first != last; ++first) {
+            auto&& key = *first;
+            const size_type pos = static_cast<size_type>(std::lower_bound(p + i, p + n, key, comp) - p);
+            append_run(i, pos);
+            i = pos;
+            if (unique && ((i < n && !comp(key, p[i])) || (!out.empty() && !comp(out.back(), key)))) continue;
+            out.emplace_back(std::forward<decltype(key)>(key));
+        }
+        append_run(i, n);
+    }
+
+    /**
+     * @brief Backward in-place merge: `p[0, n)` holds the current elements and
+     * `p[n, n + cnt)` is raw storage, where `cnt` is the number of keys to insert.
+     * Walking the keys from the back, each one binary-searches the elements not
+     * less than it and relocates them into the raw gap as a block. The gap stays
+     * `[r, w)`, every element moves at most once, and nothing is assigned.
+     */
+    template<typename BidirIt, typename Compare>
+    void merge_backward_(pointer p, size_type n, size_type cnt, BidirIt first, BidirIt last, Compare& comp, bool unique) noexcept {
+        size_type w = n + cnt, r = n;
+        const T* placed = nullptr; // Smallest existing element relocated so far
+        BidirIt it = last;
+        while (w != r) {
+            BidirIt key = std::prev(it);
+            it = key;
+            const size_type pos = static_cast<size_type>(std::lower_bound(p, p + r, *key, comp) - p);
+            if (pos != r) { // [pos, r) goes after the key: shift it up by the gap, top first
+                const size_type gap = w - r;
+                if constexpr (std::is_trivially_copyable_v<T>) {
+                    std::memmove(static_cast<void*>(p + pos + gap), static_cast<const void*>(p + pos), (r - pos) * sizeof(T));
+                } else {
+                    for (size_type j = r; j-- > pos;) { construct_at_(p + j + gap, std::move(p[j])); destroy_at_(p + j); }
+                }
+                w = pos + gap; r = pos;
+                placed = p + w;
+            }
+            if (unique && ((key != first && !comp(*std::prev(key), *key)) || (placed && !comp(*key, *placed)))) continue;
+            --w;
+            construct_at_(p + w, *key);
+        }
+    }
+
 public:
     // ========================================================================
     // Constructors and Destructor
@@ -229,8 +722,14 @@ public:
     explicit InlinedVector(const Alloc& alloc = Alloc{}) noexcept
         : storage_(std::in_place_type<InlineBuf>, this), alloc_(alloc) {}
 
-    /** @brief Destroys the InlinedVector, clearing its contents. */
-    ~InlinedVector() { clear(); } // Delegates destruction logic to clear()
+    /**
+     * @brief Destroys the InlinedVector, clearing its contents. With a wink-out
+     * allocator and trivially destructible T there is nothing to run.
+     */
+    ~InlinedVector() {
+        if constexpr (spill_feedback_) { if (!is_inline()) alloc_.record_spilled_size(size()); }
+        if constexpr (!(wink_out_ && std::is_trivially_destructible_v<T>)) clear(); // Delegates destruction logic to clear()
+    }
 
     /** @brief Copy constructor. Uses the source allocator according to allocator traits. */
     InlinedVector(const InlinedVector& other)
@@ -564,6 +1063,24 @@ public:
     /** @brief Returns the maximum possible number of elements, according to the allocator. */
     [[nodiscard]] size_type max_size() const noexcept { return AllocTraits::max_size(alloc_); }
 
+    /**
+     * @brief Returns the bytes owned by this container: `sizeof(*this)`, plus heap
+     * capacity when spilled, plus heap storage owned by the elements themselves
+     * (via `memory_usage_traits<T>`). O(1) when `T` owns no heap storage. When the
+     * heap block comes from `aligned_allocator_adaptor`, its `overhead` bytes count too.
+     */
+    [[nodiscard]] size_type memory_usage() const noexcept {
+        size_type bytes = sizeof(*this);
+        if (!is_inline()) {
+            bytes += std::get<HeapVec>(storage_).capacity() * sizeof(T);
+            if constexpr (adapt_align_) bytes += AlignedAlloc::overhead;
+        }
+        if constexpr (memory_usage_traits<T>::has_heap) {
+            for (const auto& e : *this) bytes += memory_usage_traits<T>::heap_bytes(e);
+        }
+        return bytes;
+    }
+
 
     /** @brief Increase capacity. Invalidates all iterators if capacity changes or transitions inline->heap. */
     void reserve(size_type new_cap) {
@@ -627,14 +1144,22 @@ public:
                 ++buf->size; return *elem;
             } else {
                 const size_type old_size = buf->size;
-                const size_type new_cap = std::max<size_type>(N * 2, old_size + (old_size >> 1) + 1);
+                const size_type new_cap = first_spill_capacity_(old_size);
                 HeapVec vec(alloc_); vec.reserve(new_cap);
                 pointer src_ptr = buf->ptr(); 
-                try {
-                     for(size_type i=0; i < old_size; ++i) vec.emplace_back(std::move(src_ptr[i]));
-                     vec.emplace_back(std::forward<Args>(args)...);
-                     storage_ = std::move(vec);
-                } catch (...) { throw; }
+                const auto in_buffer = [&](const void* a) {
+                    return a >= static_cast<const void*>(src_ptr) && a < static_cast<const void*>(src_ptr + old_size);
+                };
+                if ((in_buffer(std::addressof(args)) || ...)) {
+                    // An argument aliases an element about to be moved from: build the value first
+                    detail::temporary_value<T, Alloc> value(alloc_, std::forward<Args>(args)...);
+                    for(size_type i=0; i < old_size; ++i) vec.emplace_back(std::move(src_ptr[i]));
+                    vec.emplace_back(std::move(*value.get()));
+                } else {
+                    for(size_type i=0; i < old_size; ++i) vec.emplace_back(std::move(src_ptr[i]));
+                    vec.emplace_back(std::forward<Args>(args)...);
+                }
+                storage_ = std::move(vec);
                 return std::get<HeapVec>(storage_).back();
             }
         } else {
@@ -689,6 +1214,13 @@ public:
                             throw;
                         }
                         return begin() + idx;
+                    } else if constexpr (relocatable_) {
+                        // Relocation path: shift tail by move-construct + destroy
+                        relocate_right_(p, old_size, idx);
+                        try { construct_at_(p + idx, src); }
+                        catch (...) { relocate_left_(p, old_size, idx); throw; }
+                        buf->size = old_size + 1;
+                        return begin() + idx;
                     } else {
                         // Slow path: rebuild buffer using traits
                         InlineBuf tmp(this); pointer d = tmp.ptr(); pointer s = buf->ptr(); size_type k = 0;
@@ -703,7 +1235,7 @@ public:
                     }
                 } else {
                     // --- Inline path, spill to heap ---
-                    const size_type new_cap = std::max<size_type>(N * 2, old_size + (old_size >> 1) + 1);
+                    const size_type new_cap = first_spill_capacity_(old_size);
                     HeapVec vec(alloc_); vec.reserve(new_cap);
                     pointer src_ptr = buf->ptr();
                     try {
@@ -715,17 +1247,22 @@ public:
                     return begin() + idx;
                 }
             } else {
-                // --- Heap path: rebuild and swap ---
                 auto& vec = std::get<HeapVec>(storage_);
-                const size_type old_size = vec.size();
-                HeapVec new_vec(alloc_);
-                new_vec.reserve(old_size + 1);
-                try {
-                    for (size_type i = 0; i < idx; ++i) new_vec.emplace_back(std::move_if_noexcept(vec[i]));
-                    new_vec.emplace_back(src); // copy-insert src
-                    for (size_type i = idx; i < old_size; ++i) new_vec.emplace_back(std::move_if_noexcept(vec[i]));
-                    vec.swap(new_vec); // Swap new vector into place
-                } catch(...) { throw; } // new_vec dtor cleans up
+                if constexpr (relocatable_) {
+                    // --- Heap path: in-place relocation ---
+                    heap_insert_relocate_(vec, idx, src);
+                } else {
+                    // --- Heap path: rebuild and swap (throwing moves) ---
+                    const size_type old_size = vec.size();
+                    HeapVec new_vec(alloc_);
+                    new_vec.reserve(old_size + 1);
+                    try {
+                        for (size_type i = 0; i < idx; ++i) new_vec.emplace_back(std::move_if_noexcept(vec[i]));
+                        new_vec.emplace_back(src); // copy-insert src
+                        for (size_type i = idx; i < old_size; ++i) new_vec.emplace_back(std::move_if_noexcept(vec[i]));
+                        vec.swap(new_vec); // Swap new vector into place
+                    } catch(...) { throw; } // new_vec dtor cleans up
+                }
                 return begin() + idx;
             }
         };
@@ -781,6 +1318,12 @@ public:
                             throw;
                         }
                         return begin() + idx;
+                    } else if constexpr (relocatable_) {
+                        // Relocation path: shift tail by move-construct + destroy
+                        relocate_right_(p, old_size, idx);
+                        construct_at_(p + idx, std::forward<decltype(src)>(src)); // nothrow move-construct
+                        buf->size = old_size + 1;
+                        return begin() + idx;
                     } else {
                         // Slow path: rebuild buffer
                         InlineBuf tmp(this); pointer d = tmp.ptr(); pointer s = buf->ptr(); size_type k = 0;
@@ -795,7 +1338,7 @@ public:
                     }
                 } else {
                     // --- Inline path, spill to heap ---
-                    const size_type new_cap = std::max<size_type>(N * 2, old_size + (old_size >> 1) + 1);
+                    const size_type new_cap = first_spill_capacity_(old_size);
                     HeapVec vec(alloc_); vec.reserve(new_cap);
                     pointer src_ptr = buf->ptr();
                     try {
@@ -807,17 +1350,22 @@ public:
                     return begin() + idx;
                 }
             } else {
-                // --- Heap path: rebuild and swap ---
                  auto& vec = std::get<HeapVec>(storage_);
-                 const size_type old_size = vec.size();
-                 HeapVec new_vec(alloc_);
-                 new_vec.reserve(old_size + 1);
-                 try {
-                     for (size_type i = 0; i < idx; ++i) new_vec.emplace_back(std::move_if_noexcept(vec[i]));
-                     new_vec.emplace_back(std::forward<decltype(src)>(src)); // move-insert src
-                     for (size_type i = idx; i < old_size; ++i) new_vec.emplace_back(std::move_if_noexcept(vec[i]));
-                     vec.swap(new_vec); // Swap new vector into place
-                 } catch(...) { throw; }
+                 if constexpr (relocatable_) {
+                     // --- Heap path: in-place relocation ---
+                     heap_insert_relocate_(vec, idx, std::forward<decltype(src)>(src));
+                 } else {
+                     // --- Heap path: rebuild and swap (throwing moves) ---
+                     const size_type old_size = vec.size();
+                     HeapVec new_vec(alloc_);
+                     new_vec.reserve(old_size + 1);
+                     try {
+                         for (size_type i = 0; i < idx; ++i) new_vec.emplace_back(std::move_if_noexcept(vec[i]));
+                         new_vec.emplace_back(std::forward<decltype(src)>(src)); // move-insert src
+                         for (size_type i = idx; i < old_size; ++i) new_vec.emplace_back(std::move_if_noexcept(vec[i]));
+                         vec.swap(new_vec); // Swap new vector into place
+                     } catch(...) { throw; }
+                 }
                  return begin() + idx;
             }
         };
@@ -861,6 +1409,11 @@ public:
                 for (size_type i = start; i < keep; ++i) p[i] = std::move(p[i + cnt]);
                 destroy_n_(p + keep, cnt);
                 buf->size = keep;
+            } else if constexpr (relocatable_) {
+                // Relocation path: destroy + move-construct over erased slots
+                relocate_down_(p, old_size, start, cnt);
+                destroy_n_(p + keep, cnt);
+                buf->size = keep;
             } else {
                 // Slow path: rebuild buffer
                 InlineBuf tmp(this); pointer d = tmp.ptr(); const pointer s = buf->ptr(); size_type k = 0;
@@ -873,28 +1426,103 @@ public:
             }
             return begin() + start;
         } else {
-            // --- Heap path: rebuild and swap ---
             auto& vec = std::get<HeapVec>(storage_);
-            const size_type old_size = vec.size();
-            const size_type keep = old_size - cnt;
-            HeapVec new_vec(alloc_);
-            new_vec.reserve(keep);
-            try {
-                 for (size_type i = 0; i < start; ++i) new_vec.emplace_back(std::move_if_noexcept(vec[i]));
-                 for (size_type i = start + cnt; i < old_size; ++i) new_vec.emplace_back(std::move_if_noexcept(vec[i]));
-                 vec.swap(new_vec); // Swap new vector into place
-            } catch(...) { throw; }
+            if constexpr (relocatable_) {
+                // --- Heap path: in-place relocation ---
+                heap_erase_relocate_(vec, start, cnt);
+            } else {
+                // --- Heap path: rebuild and swap (throwing moves) ---
+                const size_type old_size = vec.size();
+                const size_type keep = old_size - cnt;
+                HeapVec new_vec(alloc_);
+                new_vec.reserve(keep);
+                try {
+                     for (size_type i = 0; i < start; ++i) new_vec.emplace_back(std::move_if_noexcept(vec[i]));
+                     for (size_type i = start + cnt; i < old_size; ++i) new_vec.emplace_back(std::move_if_noexcept(vec[i]));
+                     vec.swap(new_vec); // Swap new vector into place
+                } catch(...) { throw; }
+            }
             return begin() + start;
         }
     }
 
+    /**
+     * @brief Merges the sorted keys `[first, last)` into this sorted vector in one pass.
+     *
+     * Inserting k keys one at a time with `insert(lower_bound(...))` shifts the tail
+     * k times and, when spilling, may reallocate k times. This grows capacity at most
+     * once. If the result fits the current capacity it merges backwards from the end,
+     * relocating each displaced element once, so `T` need not be assignable. If it
+     * does not fit, it merges forwards into the new block, moving each element once.
+     * Equivalent keys are placed before existing equivalents, matching
+     * `insert(lower_bound(...))`. With `merge_duplicates::skip` the vector behaves
+     * as a sorted set.
+     *
+     * Single-pass iterators, and keys whose construction can throw, are first copied
+     * into a temporary so the merge itself cannot throw. Types with throwing moves
+     * merge into a fresh vector that is then swapped in.
+     *
+     * @pre `*this` and `[first, last)` are sorted by `comp`, and the range does not
+     * refer into `*this`.
+     * @return The number of keys inserted.
+     */
+    template<typename InputIt, typename Compare = std::less<>>
+    size_type merge_insert_sorted(InputIt first, InputIt last, Compare comp = Compare{},
+                                  merge_duplicates dups = merge_duplicates::keep) {
+        using Category = typename std::iterator_traits<InputIt>::iterator_category;
+        using Ref = typename std::iterator_traits<InputIt>::reference;
+        constexpr bool forward = std::is_base_of_v<std::forward_iterator_tag, Category>;
+        constexpr bool bidirectional = std::is_base_of_v<std::bidirectional_iterator_tag, Category>;
+        recover_if_valueless_();
+        assert(std::is_sorted(begin(), end(), comp));
+        const bool unique = dups == merge_duplicates::skip;
+        const size_type old_size = size();
+
+        if constexpr (!relocatable_) {
+            // Throwing moves: merge into fresh storage, then swap it in
+            InlinedVector out(alloc_);
+            if constexpr (forward) out.reserve(old_size + static_cast<size_type>(std::distance(first, last)));
+            merge_forward_(out, first, last, comp, unique);
+            swap(out);
+            return size() - old_size;
+        } else if constexpr (!bidirectional || !std::is_nothrow_constructible_v<T, Ref>) {
+            // Stage the keys so the merge below only moves
+            InlinedVector staged(alloc_);
+            if constexpr (forward) staged.reserve(static_cast<size_type>(std::distance(first, last)));
+            for (; first != last; ++first) staged.emplace_back(*first);
+            return merge_insert_sorted(std::make_move_iterator(staged.begin()), std::make_move_iterator(staged.end()), comp, dups);
+        } else {
+            assert(std::is_sorted(first, last, comp));
+            const size_type cnt = unique ? count_new_keys_(first, last, comp) : static_cast<size_type>(std::distance(first, last));
+            if (cnt == 0) return 0;
+            const size_type new_size = old_size + cnt;
+            if (new_size > capacity()) {
+                // Growing anyway: merge forwards into the new block
+                HeapVec vec(alloc_);
+                vec.reserve(is_inline() ? std::max(new_size, first_spill_capacity_(old_size)) : std::max(new_size, 2 * capacity()));
+                merge_forward_(vec, first, last, comp, unique);
+                storage_ = std::move(vec);
+            } else if (old_size == 0) {
+                merge_forward_(*this, first, last, comp, unique); // Nothing to move: appends the keys
+            } else if (auto* buf = std::get_if<InlineBuf>(&storage_)) {
+                merge_backward_(buf->ptr(), old_size, cnt, first, last, comp, unique);
+                buf->size = new_size;
+            } else {
+                auto& vec = std::get<HeapVec>(storage_);
+                heap_open_tail_(vec, cnt);
+                merge_backward_(vec.data(), old_size, cnt, first, last, comp, unique);
+            }
+            return cnt;
+        }
+    }
+
     /** @brief Resizes to count elements (default construction). Requires T to be DefaultInsertable. */
     template<typename U = T, std::enable_if_t<std::is_default_constructible_v<U>, int> = 0>
     void resize(size_type count) {
         recover_if_valueless_(); size_type current = size();
         if (count < current) { erase(begin() + count, end()); }
         else if (count > current) {
-            reserve(count);
+            reserve(count > N && is_inline() ? std::max(count, spill_hint_()) : count);
             if (auto* buf = std::get_if<InlineBuf>(&storage_)) {
                 pointer p = buf->ptr();
                 for (size_type i = current; i < count; ++i) construct_at_(p + i);
@@ -909,7 +1537,7 @@ public:
         recover_if_valueless_(); size_type current = size();
         if (count < current) { erase(begin() + count, end()); }
         else if (count > current) {
-            reserve(count);
+            reserve(count > N && is_inline() ? std::max(count, spill_hint_()) : count);
             if (auto* buf = std::get_if<InlineBuf>(&storage_)) {
                 pointer p = buf->ptr();
                 for (size_type i = current; i < count; ++i) construct_at_(p + i, value);
@@ -996,34 +1624,4091 @@ public:
 };
 
 /** @brief Non-member swap for InlinedVector. */
-template<typename T, std::size_t N, typename Alloc>
-void swap(InlinedVector<T, N, Alloc>& lhs, InlinedVector<T, N, Alloc>& rhs)
+template<typename T, std::size_t N, typename Alloc, std::size_t Align>
+void swap(InlinedVector<T, N, Alloc, Align>& lhs, InlinedVector<T, N, Alloc, Align>& rhs)
     noexcept(noexcept(lhs.swap(rhs)))
 {
     lhs.swap(rhs);
 }
 
+/** @brief Nested `InlinedVector`s report everything they own beyond their own footprint. */
+template<typename T, std::size_t N, typename Alloc, std::size_t Align>
+struct memory_usage_traits<InlinedVector<T, N, Alloc, Align>> {
+    static constexpr bool has_heap = true;
+    static std::size_t heap_bytes(const InlinedVector<T, N, Alloc, Align>& v) noexcept {
+        return v.memory_usage() - sizeof(v);
+    }
+};
+
 // ============================================================================
-// Out-of-class definitions for allocator-aware helpers
+// Algorithms: lloyal::sort, stable_sort, rotate
 // ============================================================================
 
-template<typename T, std::size_t N, typename Alloc>
-template<class... Args>
-inline T* InlinedVector<T, N, Alloc>::construct_at_(T* p, Args&&... args) {
-    AllocTraits::construct(alloc_, p, std::forward<Args>(args)...);
-    return p;
+namespace detail {
+
+/** @brief Largest size sorted by a network; larger inputs use `std::sort`. */
+inline constexpr std::size_t sort_network_max = 64;
+
+/** @brief One comparator of a sorting network: orders `p[a] <= p[b]`. */
+struct comparator { unsigned char a, b; };
+
+/** @brief Comparator count of Batcher's odd-even merge sort for `n` elements. */
+constexpr std::size_t batcher_count(std::size_t n) {
+    std::size_t count = 0;
+    for (std::size_t p = 1; p < n; p += p)
+        for (std::size_t k = p; k >= 1; k /= 2)
+            for (std::size_t j = k % p; j + k < n; j += 2 * k)
+                for (std::size_t i = 0; i < k && i + j + k < n; ++i)
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) ++count;
+    return count;
 }
 
-template<typename T, std::size_t N, typename Alloc>
-inline void InlinedVector<T, N, Alloc>::destroy_at_(T* p) noexcept {
-    AllocTraits::destroy(alloc_, p);
+/** @brief Batcher's odd-even merge sort network for exactly `K` elements, built at compile time. */
+template<std::size_t K>
+struct batcher_network {
+    static constexpr std::size_t size = batcher_count(K);
+    static constexpr std::array<comparator, size> pairs = [] {
+        std::array<comparator, size> out{};
+        std::size_t c = 0;
+        for (std::size_t p = 1; p < K; p += p)
+            for (std::size_t k = p; k >= 1; k /= 2)
+                for (std::size_t j = k % p; j + k < K; j += 2 * k)
+                    for (std::size_t i = 0; i < k && i + j + k < K; ++i)
+                        if ((i + j) / (2 * p) == (i + j + k) / (2 * p))
+                            out[c++] = {static_cast<unsigned char>(i + j), static_cast<unsigned char>(i + j + k)};
+        return out;
+    }();
+};
+
+/** @brief Branch-free compare-exchange; compiles to min/max (or cmov) for arithmetic types. */
+template<typename T>
+inline void compare_exchange(T& a, T& b) noexcept {
+    const bool swap = b < a;
+    const T lo = swap ? b : a;
+    const T hi = swap ? a : b;
+    a = lo; b = hi;
 }
 
-template<typename T, std::size_t N, typename Alloc>
-inline void InlinedVector<T, N, Alloc>::destroy_n_(T* p, size_type n) noexcept {
-    for (size_type i = 0; i < n; ++i) {
-        AllocTraits::destroy(alloc_, p + i);
+template<typename T, std::size_t K>
+void sort_network_fixed(T* p) noexcept {
+    for (const comparator& c : batcher_network<K>::pairs) compare_exchange(p[c.a], p[c.b]);
+}
+
+/** @brief Dispatches a runtime size in `[0, Max]` to the matching fixed-size network. */
+template<typename T, std::size_t... Ks>
+void sort_network(T* p, std::size_t n, std::index_sequence<Ks...>) noexcept {
+    using fn = void (*)(T*) noexcept;
+    static constexpr fn table[] = {&sort_network_fixed<T, Ks>...};
+    table[n](p);
+}
+
+/** @brief True if the std algorithms (which move-assign elements) can be used on `T`. */
+template<typename T>
+inline constexpr bool std_permutable_v = std::is_move_assignable_v<T> && std::is_swappable_v<T>;
+
+/**
+ * @brief Reorders `p[0, n)` so that slot `i` receives the element previously at
+ * `order[i]`, by walking permutation cycles with one temporary and relocating
+ * (move-construct + destroy through `alloc`). Never assigns. `order` is consumed.
+ */
+template<typename Alloc, typename T, typename Index>
+void relocate_permutation(Alloc& alloc, T* p, std::size_t n, Index* order) noexcept {
+    using AT = std::allocator_traits<Alloc>;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (order[i] == i) continue;
+        T tmp(std::move(p[i]));
+        AT::destroy(alloc, p + i);
+        std::size_t j = i;
+        for (;;) {
+            const std::size_t k = order[j];
+            order[j] = static_cast<Index>(j);
+            if (k == i) { AT::construct(alloc, p + j, std::move(tmp)); break; }
+            AT::construct(alloc, p + j, std::move(p[k]));
+            AT::destroy(alloc, p + k);
+            j = k;
+        }
+    }
+}
+
+/**
+ * @brief Sorts an index permutation of `p[0, n)` with `sort_fn`, then applies it
+ * by relocation. Comparisons all happen before any element moves, so a throwing
+ * comparator leaves the elements untouched. Inline-sized inputs use a stack index
+ * buffer; larger ones a scratch `std::vector`.
+ */
+template<std::size_t N, typename Alloc, typename T, typename Compare, typename SortFn>
+void relocation_sort(Alloc& alloc, T* p, std::size_t n, Compare& comp, SortFn sort_fn) {
+    auto run = [&](std::size_t* order) {
+        for (std::size_t i = 0; i < n; ++i) order[i] = i;
+        sort_fn(order, order + n, [&](std::size_t a, std::size_t b) { return comp(p[a], p[b]); });
+        relocate_permutation(alloc, p, n, order);
+    };
+    if constexpr (N <= 256) {
+        if (n <= N) { std::size_t order[N]; run(order); return; }
+    }
+    std::vector<std::size_t> order(n);
+    run(order.data());
+}
+
+} // namespace detail
+
+/**
+ * @brief Sorts `v` in ascending order.
+ *
+ * For arithmetic `T`, sizes up to `min(N, 64)` are sorted with a branch-free
+ * Batcher odd-even merge network selected at compile time (the compare-exchange
+ * lowers to scalar min/max); larger sizes fall back to `std::sort`. Other types
+ * always use `std::sort`. Not stable.
+ */
+template<typename T, std::size_t N, typename Alloc, std::size_t Align, typename Compare>
+void sort(InlinedVector<T, N, Alloc, Align>& v, Compare comp);
+
+template<typename T, std::size_t N, typename Alloc, std::size_t Align>
+void sort(InlinedVector<T, N, Alloc, Align>& v) {
+    constexpr std::size_t max_network = std::min(N, detail::sort_network_max);
+    if constexpr (std::is_arithmetic_v<T>) {
+        if (v.size() <= max_network) {
+            detail::sort_network(v.data(), v.size(), std::make_index_sequence<max_network + 1>{});
+            return;
+        }
+    }
+    lloyal::sort(v, std::less<>{});
+}
+
+/**
+ * @brief Sorts `v` by `comp`. Not stable.
+ *
+ * Uses `std::sort` when `T` is move-assignable. Otherwise (e.g. `const` members)
+ * sorts an index permutation and applies it by relocation, which requires
+ * `T` to be nothrow-move-constructible. Strong guarantee if `comp` throws.
+ */
+template<typename T, std::size_t N, typename Alloc, std::size_t Align, typename Compare>
+void sort(InlinedVector<T, N, Alloc, Align>& v, Compare comp) {
+    if constexpr (detail::std_permutable_v<T>) {
+        std::sort(v.begin(), v.end(), comp);
+    } else {
+        static_assert(std::is_nothrow_move_constructible_v<T>,
+                      "lloyal::sort on non-assignable T requires a nothrow move constructor");
+        auto alloc = v.get_allocator();
+        detail::relocation_sort<N>(alloc, v.data(), v.size(), comp,
+            [](auto first, auto last, auto cmp) { std::sort(first, last, cmp); });
+    }
+}
+
+/** @brief Stable sort by `comp`; relocation-based for non-assignable `T` (see `sort`). */
+template<typename T, std::size_t N, typename Alloc, std::size_t Align, typename Compare>
+void stable_sort(InlinedVector<T, N, Alloc, Align>& v, Compare comp) {
+    if constexpr (detail::std_permutable_v<T>) {
+        std::stable_sort(v.begin(), v.end(), comp);
+    } else {
+        static_assert(std::is_nothrow_move_constructible_v<T>,
+                      "lloyal::stable_sort on non-assignable T requires a nothrow move constructor");
+        auto alloc = v.get_allocator();
+        detail::relocation_sort<N>(alloc, v.data(), v.size(), comp,
+            [](auto first, auto last, auto cmp) { std::stable_sort(first, last, cmp); });
     }
 }
 
-} // namespace lloyal
\ No newline at end of file
+/** @brief Stable sort in ascending order. */
+template<typename T, std::size_t N, typename Alloc, std::size_t Align>
+void stable_sort(InlinedVector<T, N, Alloc, Align>& v) {
+    lloyal::stable_sort(v, std::less<>{});
+}
+
+/**
+ * @brief Rotates `v` so that `middle` becomes the first element, like `std::rotate`.
+ * @return Iterator to the new position of the former first element.
+ *
+ * For non-assignable `T`, walks the gcd(n, k) rotation cycles with one temporary,
+ * relocating each element exactly once. No allocation in either mode.
+ */
+template<typename T, std::size_t N, typename Alloc, std::size_t Align>
+typename InlinedVector<T, N, Alloc, Align>::iterator
+rotate(InlinedVector<T, N, Alloc, Align>& v, typename InlinedVector<T, N, Alloc, Align>::const_iterator middle) {
+    T* p = v.data();
+    const std::size_t n = v.size();
+    const std::size_t k = static_cast<std::size_t>(middle - v.cbegin());
+    if constexpr (detail::std_permutable_v<T>) {
+        return std::rotate(v.begin(), v.begin() + k, v.end());
+    } else {
+        static_assert(std::is_nothrow_move_constructible_v<T>,
+                      "lloyal::rotate on non-assignable T requires a nothrow move constructor");
+        if (k == 0 || k == n) return v.begin() + (n - k);
+        using AT = std::allocator_traits<Alloc>;
+        auto alloc = v.get_allocator();
+        std::size_t a = n, b = k;
+        while (b != 0) { const std::size_t t = a % b; a = b; b = t; } // a = gcd(n, k)
+        for (std::size_t start = 0; start < a; ++start) {
+            T tmp(std::move(p[start]));
+            AT::destroy(alloc, p + start);
+            std::size_t j = start;
+            for (;;) {
+                std::size_t src = j + k;
+                if (src >= n) src -= n;
+                if (src == start) break;
+                AT::construct(alloc, p + j, std::move(p[src]));
+                AT::destroy(alloc, p + src);
+                j = src;
+            }
+            AT::construct(alloc, p + j, std::move(tmp));
+        }
+        return v.begin() + (n - k);
+    }
+}
+
+// ============================================================================
+// Out-of-class definitions for allocator-aware helpers
+// ============================================================================
+
+template<typename T, std::size_t N, typename Alloc, std::size_t Align>
+template<class... Args>
+inline T* InlinedVector<T, N, Alloc, Align>::construct_at_(T* p, Args&&... args) {
+    AllocTraits::construct(alloc_, p, std::forward<Args>(args)...);
+    return p;
+}
+
+template<typename T, std::size_t N, typename Alloc, std::size_t Align>
+inline void InlinedVector<T, N, Alloc, Align>::destroy_at_(T* p) noexcept {
+    AllocTraits::destroy(alloc_, p);
+}
+
+template<typename T, std::size_t N, typename Alloc, std::size_t Align>
+inline void InlinedVector<T, N, Alloc, Align>::destroy_n_(T* p, size_type n) noexcept {
+    for (size_type i = 0; i < n; ++i) {
+        AllocTraits::destroy(alloc_, p + i);
+    }
+}
+
+// ============================================================================
+// InlinedVectorRef: InlinedVector over a caller-provided buffer
+// ============================================================================
+
+/**
+ * @brief Uninitialized, suitably aligned storage for `K` objects of type `T`.
+ * Declare one on the stack and pass it to `InlinedVectorRef`.
+ */
+template<typename T, std::size_t K>
+struct inline_storage {
+    alignas(T) std::byte bytes[sizeof(T) * K];
+    static constexpr std::size_t capacity = K;
+};
+
+/**
+ * @brief A vector that uses a borrowed buffer as its inline storage.
+ *
+ * The buffer's capacity is a runtime value. It can be a stack array
+ * (`inline_storage<T, K>`) or a slice of a per-thread scratch arena. Growth
+ * beyond it spills to `Alloc`, and `shrink_to_fit()` returns to the buffer
+ * once the elements fit again. Otherwise this class mirrors `InlinedVector`,
+ * including relocation-based insert/erase for non-assignable `T`.
+ *
+ * The buffer must outlive the container and must not be shared with another
+ * live container. For that reason `InlinedVectorRef` is neither copy- nor
+ * move-constructible. Copy and move assignment transfer elements, and a move
+ * steals the source's heap block when the allocators allow it.
+ *
+ * @tparam T Element type. Must be MoveConstructible.
+ * @tparam Alloc Allocator used once the buffer is full.
+ */
+template<typename T, typename Alloc = std::allocator<T>>
+class InlinedVectorRef {
+public:
+    // --- Member Types ---
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = pointer;
+    using const_iterator = const_pointer;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static_assert(std::is_same_v<typename Alloc::value_type, T>, "Allocator::value_type must be T");
+    static_assert(std::is_move_constructible_v<T>, "InlinedVectorRef requires T to be MoveConstructible");
+
+private:
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    pointer data_;
+    size_type size_ = 0;
+    size_type cap_;
+    pointer buffer_;          // Borrowed storage; never deallocated
+    size_type buffer_cap_;
+    LLOYAL_NO_UNIQUE_ADDRESS allocator_type alloc_;
+
+    template<class... Args>
+    pointer construct_at_(pointer p, Args&&... args) {
+        AllocTraits::construct(alloc_, p, std::forward<Args>(args)...);
+        return p;
+    }
+    void destroy_at_(pointer p) noexcept { AllocTraits::destroy(alloc_, p); }
+    void destroy_n_(pointer p, size_type n) noexcept { for (size_type i = 0; i < n; ++i) destroy_at_(p + i); }
+
+    static constexpr bool wink_out_ = is_wink_out_allocator_v<Alloc>;
+
+    bool on_heap_() const noexcept { return data_ != buffer_; }
+    /** @brief Returns a heap block; a no-op for wink-out allocators. */
+    void deallocate_(pointer p, size_type n) noexcept { if constexpr (!wink_out_) AllocTraits::deallocate(alloc_, p, n); }
+    /** @brief Frees the heap block, if any. Elements must already be destroyed or moved out. */
+    void release_() noexcept { if (on_heap_()) deallocate_(data_, cap_); }
+    void adopt_(pointer p, size_type cap) noexcept { release_(); data_ = p; cap_ = cap; }
+
+    size_type next_capacity_() const noexcept { return std::max<size_type>(cap_ * 2, 4); }
+
+    /** @brief Move-constructs `[src, src + n)` into raw `dst` (copies if the move may throw); all-or-nothing. */
+    void transfer_(pointer src, size_type n, pointer dst) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (n) std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+        } else {
+            size_type i = 0;
+            try { for (; i < n; ++i) construct_at_(dst + i, std::move_if_noexcept(src[i])); }
+            catch (...) { destroy_n_(dst, i); throw; }
+        }
+    }
+
+    /** @brief Moves all elements to `[dst, dst + new_cap)`, which becomes the storage. Strong guarantee. */
+    void relocate_to_(pointer dst, size_type new_cap) {
+        transfer_(data_, size_, dst);
+        destroy_n_(data_, size_);
+        adopt_(dst, new_cap);
+    }
+
+    /** @brief Moves into a new heap block of `new_cap`. Strong guarantee. */
+    void reallocate_(size_type new_cap) {
+        pointer nb = AllocTraits::allocate(alloc_, new_cap);
+        try { relocate_to_(nb, new_cap); }
+        catch (...) { deallocate_(nb, new_cap); throw; }
+    }
+
+    /**
+     * @brief Rebuilds into a new heap block with `cnt` new elements at `idx`,
+     * the k-th constructed by `make(p)` in order. Used when the storage is full.
+     * Strong guarantee.
+     */
+    template<typename Make>
+    void insert_realloc_(size_type idx, size_type cnt, Make&& make) {
+        const size_type new_cap = std::max(next_capacity_(), size_ + cnt);
+        pointer nb = AllocTraits::allocate(alloc_, new_cap);
+        size_type made = 0;
+        int stage = 0;
+        try {
+            for (; made < cnt; ++made) make(nb + idx + made); // Before moving: sources may alias elements
+            stage = 1;
+            transfer_(data_, idx, nb);
+            stage = 2;
+            transfer_(data_ + idx, size_ - idx, nb + idx + cnt);
+        } catch (...) {
+            destroy_n_(nb + idx, made);
+            if (stage >= 2) destroy_n_(nb, idx);
+            deallocate_(nb, new_cap);
+            throw;
+        }
+        destroy_n_(data_, size_);
+        adopt_(nb, new_cap);
+        size_ += cnt;
+    }
+
+    /** @brief Relocates `[from, from + n)` to `[to, to + n)`; the ranges may overlap. Requires nothrow moves. */
+    void relocate_range_(size_type from, size_type n, size_type to) noexcept {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (n) std::memmove(static_cast<void*>(data_ + to), static_cast<const void*>(data_ + from), n * sizeof(T));
+        } else if (to > from) {
+            for (size_type i = n; i-- > 0;) { construct_at_(data_ + to + i, std::move(data_[from + i])); destroy_at_(data_ + from + i); }
+        } else {
+            for (size_type i = 0; i < n; ++i) { construct_at_(data_ + to + i, std::move(data_[from + i])); destroy_at_(data_ + from + i); }
+        }
+    }
+
+    /**
+     * @brief Inserts `cnt` elements at `idx` as `insert_realloc_` does, in place
+     * when they fit. Nothrow-relocatable `T` shifts the tail by relocation (strong
+     * guarantee). Otherwise the tail shifts with move_if_noexcept, and a throw
+     * destroys the elements from the failing slot onward (basic guarantee).
+     */
+    template<typename Make>
+    void insert_n_(size_type idx, size_type cnt, Make&& make) {
+        if (cnt == 0) return;
+        if (cnt > cap_ - size_) { insert_realloc_(idx, cnt, make); return; }
+        const size_type old_size = size_;
+        if constexpr (std::is_trivially_copyable_v<T> || std::is_nothrow_move_constructible_v<T>) {
+            relocate_range_(idx, old_size - idx, idx + cnt);
+            size_type made = 0;
+            try { for (; made < cnt; ++made) make(data_ + idx + made); }
+            catch (...) { destroy_n_(data_ + idx, made); relocate_range_(idx + cnt, old_size - idx, idx); throw; }
+        } else {
+            size_type d = old_size + cnt; // Slot being filled; [old_size, d) is raw
+            try {
+                for (size_type i = old_size; i-- > idx;) {
+                    d = i + cnt;
+                    if (d < old_size) destroy_at_(data_ + d);
+                    construct_at_(data_ + d, std::move_if_noexcept(data_[i]));
+                }
+            } catch (...) {
+                destroy_n_(data_ + d + 1, old_size + cnt - d - 1);
+                size_ = std::min(d, old_size);
+                throw;
+            }
+            destroy_n_(data_ + idx, std::min(idx + cnt, old_size) - idx); // Moved-from sources in the gap
+            size_type made = 0;
+            try { for (; made < cnt; ++made) make(data_ + idx + made); }
+            catch (...) { destroy_n_(data_ + idx + cnt, old_size - idx); size_ = idx + made; throw; }
+        }
+        size_ += cnt;
+    }
+
+    /** @brief True if `p` points at one of the elements. */
+    bool holds_(const T* p) const noexcept { return p >= data_ && p < data_ + size_; }
+
+public:
+    // ========================================================================
+    // Constructors and Destructor
+    // ========================================================================
+
+    /**
+     * @brief Borrows `buffer` as inline storage for up to `capacity` elements.
+     * @pre `buffer` is aligned for `T`, holds `capacity * sizeof(T)` bytes, and
+     * outlives the container. It may be null only if `capacity` is 0.
+     */
+    InlinedVectorRef(void* buffer, size_type capacity, const Alloc& alloc = Alloc{}) noexcept
+        : data_(static_cast<pointer>(buffer)), cap_(capacity),
+          buffer_(static_cast<pointer>(buffer)), buffer_cap_(capacity), alloc_(alloc)
+    {
+        assert((buffer != nullptr || capacity == 0) && "InlinedVectorRef: null buffer with non-zero capacity");
+        assert(reinterpret_cast<std::uintptr_t>(buffer) % alignof(T) == 0 && "InlinedVectorRef: misaligned buffer");
+    }
+
+    /** @brief Borrows an `inline_storage<T, K>`. */
+    template<std::size_t K>
+    explicit InlinedVectorRef(inline_storage<T, K>& storage, const Alloc& alloc = Alloc{}) noexcept
+        : InlinedVectorRef(storage.bytes, K, alloc) {}
+
+    /** @brief Destroys the elements and frees any heap block. The buffer is left to the caller. */
+    ~InlinedVectorRef() {
+        if constexpr (!(wink_out_ && std::is_trivially_destructible_v<T>)) { clear(); release_(); }
+    }
+
+    InlinedVectorRef(const InlinedVectorRef&) = delete;
+    InlinedVectorRef(InlinedVectorRef&&) = delete;
+
+    /** @brief Copy assignment: copies elements into this container's own buffer or heap. */
+    InlinedVectorRef& operator=(const InlinedVectorRef& other) {
+        if (this == &other) return *this;
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+            if (alloc_ != other.alloc_) { clear(); release_(); data_ = buffer_; cap_ = buffer_cap_; }
+            alloc_ = other.alloc_;
+        }
+        assign(other.begin(), other.end());
+        return *this;
+    }
+
+    /** @brief Move assignment. Steals `other`'s heap block when allocators allow, else moves elements. */
+    InlinedVectorRef& operator=(InlinedVectorRef&& other) {
+        if (this == &other) return *this;
+        constexpr bool pocma = AllocTraits::propagate_on_container_move_assignment::value;
+        if (other.on_heap_() && (pocma || alloc_ == other.alloc_)) {
+            clear(); release_();
+            if constexpr (pocma) alloc_ = std::move(other.alloc_);
+            data_ = other.data_; size_ = other.size_; cap_ = other.cap_;
+            other.data_ = other.buffer_; other.size_ = 0; other.cap_ = other.buffer_cap_;
+        } else {
+            clear();
+            if constexpr (pocma) {
+                // Our heap block belongs to the old allocator; other keeps using its own
+                if (alloc_ != other.alloc_) { release_(); data_ = buffer_; cap_ = buffer_cap_; }
+                alloc_ = other.alloc_;
+            }
+            reserve(other.size_);
+            transfer_(other.data_, other.size_, data_);
+            size_ = other.size_;
+            other.clear();
+        }
+        return *this;
+    }
+
+    /** @brief Replaces the contents with `[first, last)`. */
+    template<typename InputIt, std::enable_if_t<!std::is_integral_v<InputIt>, int> = 0>
+    void assign(InputIt first, InputIt last) {
+        clear();
+        using cat = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, cat>) {
+            reserve(static_cast<size_type>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) emplace_back(*first);
+    }
+    /** @brief Replaces the contents with `count` copies of `value`. */
+    void assign(size_type count, const T& value) { T tmp(value); clear(); resize(count, tmp); }
+    /** @brief Replaces the contents with `init`. */
+    void assign(std::initializer_list<T> init) { assign(init.begin(), init.end()); }
+
+    /** @brief Returns the associated allocator. */
+    allocator_type get_allocator() const noexcept { return alloc_; }
+
+    // ========================================================================
+    // Element Access
+    // ========================================================================
+    /** @brief Access specified element with bounds checking. */
+    reference at(size_type pos) { if (pos >= size_) throw std::out_of_range("InlinedVectorRef::at"); return data_[pos]; }
+    /** @brief Access specified element with bounds checking. */
+    const_reference at(size_type pos) const { if (pos >= size_) throw std::out_of_range("InlinedVectorRef::at"); return data_[pos]; }
+    /** @brief Access specified element. @warning No bounds checking. */
+    reference operator[](size_type pos) noexcept { assert(pos < size_); return data_[pos]; }
+    /** @brief Access specified element. @warning No bounds checking. */
+    const_reference operator[](size_type pos) const noexcept { assert(pos < size_); return data_[pos]; }
+    /** @brief Access the first element. @warning Undefined behavior if empty. */
+    reference front() noexcept { assert(!empty()); return data_[0]; }
+    /** @brief Access the first element. @warning Undefined behavior if empty. */
+    const_reference front() const noexcept { assert(!empty()); return data_[0]; }
+    /** @brief Access the last element. @warning Undefined behavior if empty. */
+    reference back() noexcept { assert(!empty()); return data_[size_ - 1]; }
+    /** @brief Access the last element. @warning Undefined behavior if empty. */
+    const_reference back() const noexcept { assert(!empty()); return data_[size_ - 1]; }
+    /** @brief Returns a pointer to the underlying data (the buffer, or the heap block). */
+    pointer data() noexcept { return data_; }
+    /** @brief Returns a const pointer to the underlying data. */
+    const_pointer data() const noexcept { return data_; }
+
+    // ========================================================================
+    // Iterators
+    // ========================================================================
+    iterator begin() noexcept { return data_; }
+    const_iterator begin() const noexcept { return data_; }
+    const_iterator cbegin() const noexcept { return data_; }
+    iterator end() noexcept { return data_ + size_; }
+    const_iterator end() const noexcept { return data_ + size_; }
+    const_iterator cend() const noexcept { return data_ + size_; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+
+    // ========================================================================
+    // Capacity
+    // ========================================================================
+    /** @brief Checks if the container is empty. */
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    /** @brief Returns the number of elements in the container. */
+    [[nodiscard]] size_type size() const noexcept { return size_; }
+    /** @brief Returns the number of elements the current storage can hold. */
+    [[nodiscard]] size_type capacity() const noexcept { return cap_; }
+    /** @brief Returns the borrowed buffer's capacity (the runtime counterpart of `InlinedVector::inline_capacity`). */
+    [[nodiscard]] size_type inline_capacity() const noexcept { return buffer_cap_; }
+    /** @brief True while the elements live in the borrowed buffer. */
+    [[nodiscard]] bool is_inline() const noexcept { return !on_heap_(); }
+    /** @brief Returns the maximum possible number of elements, according to the allocator. */
+    [[nodiscard]] size_type max_size() const noexcept { return AllocTraits::max_size(alloc_); }
+
+    /**
+     * @brief As `InlinedVector::memory_usage()`. The borrowed buffer belongs to
+     * the caller and is not counted.
+     */
+    [[nodiscard]] size_type memory_usage() const noexcept {
+        size_type bytes = sizeof(*this);
+        if (on_heap_()) bytes += cap_ * sizeof(T);
+        if constexpr (memory_usage_traits<T>::has_heap) {
+            for (const auto& e : *this) bytes += memory_usage_traits<T>::heap_bytes(e);
+        }
+        return bytes;
+    }
+
+    /** @brief Increase capacity. Invalidates all iterators if capacity changes. */
+    void reserve(size_type new_cap) { if (new_cap > cap_) reallocate_(new_cap); }
+
+    /**
+     * @brief Returns to the borrowed buffer if the elements fit, otherwise shrinks
+     * the heap block to `size()`. Invalidates all iterators if storage changes.
+     */
+    void shrink_to_fit() {
+        if (!on_heap_() || size_ == cap_) return;
+        if (size_ <= buffer_cap_) relocate_to_(buffer_, buffer_cap_);
+        else reallocate_(size_);
+    }
+
+    // ========================================================================
+    // Modifiers
+    // ========================================================================
+
+    /** @brief Clears the contents. Keeps the current storage. */
+    void clear() noexcept { destroy_n_(data_, size_); size_ = 0; }
+
+    /** @brief Appends value to the end. */
+    void push_back(const T& value) { emplace_back(value); }
+    /** @brief Appends value to the end. */
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    /** @brief Constructs element in-place at the end. Spills to the allocator when full. */
+    template<typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (size_ == cap_) insert_realloc_(size_, 1, [&](pointer p) { construct_at_(p, std::forward<Args>(args)...); });
+        else { construct_at_(data_ + size_, std::forward<Args>(args)...); ++size_; }
+        return data_[size_ - 1];
+    }
+
+    /** @brief Removes the last element. */
+    void pop_back() noexcept { assert(!empty()); --size_; destroy_at_(data_ + size_); }
+
+    /** @brief Constructs an element in-place before pos. */
+    template<typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        const size_type idx = static_cast<size_type>(pos - cbegin());
+        if (size_ == cap_) { insert_realloc_(idx, 1, [&](pointer p) { construct_at_(p, std::forward<Args>(args)...); }); return begin() + idx; }
+        if (idx == size_) { construct_at_(data_ + size_, std::forward<Args>(args)...); ++size_; return begin() + idx; }
+        detail::temporary_value<T, Alloc> staged(alloc_, std::forward<Args>(args)...); // args may alias elements
+        T& tmp = *staged.get();
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memmove(static_cast<void*>(data_ + idx + 1), static_cast<const void*>(data_ + idx), (size_ - idx) * sizeof(T));
+            std::memcpy(static_cast<void*>(data_ + idx), static_cast<const void*>(std::addressof(tmp)), sizeof(T));
+            ++size_;
+        } else if constexpr (std::is_move_assignable_v<T>) {
+            construct_at_(data_ + size_, std::move(data_[size_ - 1]));
+            ++size_;
+            std::move_backward(data_ + idx, data_ + size_ - 2, data_ + size_ - 1);
+            data_[idx] = std::move(tmp);
+        } else {
+            // Non-assignable: relocate the tail into the spare slot
+            insert_n_(idx, 1, [&](pointer p) { construct_at_(p, std::move_if_noexcept(tmp)); });
+        }
+        return begin() + idx;
+    }
+    /** @brief Inserts value before pos. */
+    iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+    /** @brief Inserts value before pos. */
+    iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+    /** @brief Inserts `count` copies of `value` before pos. */
+    iterator insert(const_iterator pos, size_type count, const T& value) {
+        const size_type idx = static_cast<size_type>(pos - cbegin());
+        if (holds_(std::addressof(value))) { T tmp(value); return insert(pos, count, tmp); }
+        insert_n_(idx, count, [&](pointer p) { construct_at_(p, value); });
+        return begin() + idx;
+    }
+    /** @brief Inserts `[first, last)` before pos. The range must not refer to this container. */
+    template<typename InputIt, std::enable_if_t<!std::is_integral_v<InputIt>, int> = 0>
+    iterator insert(const_iterator pos, InputIt first, InputIt last) {
+        const size_type idx = static_cast<size_type>(pos - cbegin());
+        using cat = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, cat>) {
+            insert_n_(idx, static_cast<size_type>(std::distance(first, last)), [&](pointer p) { construct_at_(p, *first); ++first; });
+        } else {
+            // Single pass: stage the input so the count is known, then move it in
+            InlinedVector<T, 8, Alloc> staged(alloc_);
+            for (; first != last; ++first) staged.emplace_back(*first);
+            auto it = std::make_move_iterator(staged.begin());
+            insert_n_(idx, staged.size(), [&](pointer p) { construct_at_(p, *it); ++it; });
+        }
+        return begin() + idx;
+    }
+    /** @brief Inserts `init` before pos. */
+    iterator insert(const_iterator pos, std::initializer_list<T> init) { return insert(pos, init.begin(), init.end()); }
+
+    /** @brief Erases element at pos. */
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    /** @brief Erases elements in [first, last). Invalidates iterators at/after first. */
+    iterator erase(const_iterator first, const_iterator last) {
+        const size_type start = static_cast<size_type>(first - cbegin());
+        const size_type cnt = static_cast<size_type>(last - first);
+        if (cnt == 0) return begin() + start;
+        const size_type keep = size_ - cnt;
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memmove(static_cast<void*>(data_ + start), static_cast<const void*>(data_ + start + cnt), (keep - start) * sizeof(T));
+            destroy_n_(data_ + keep, cnt);
+        } else if constexpr (std::is_move_assignable_v<T>) {
+            std::move(data_ + start + cnt, data_ + size_, data_ + start);
+            destroy_n_(data_ + keep, cnt);
+        } else if constexpr (std::is_nothrow_move_constructible_v<T>) {
+            // Relocation path: destroy + move-construct over erased slots
+            for (size_type i = start; i < keep; ++i) { destroy_at_(data_ + i); construct_at_(data_ + i, std::move(data_[i + cnt])); }
+            destroy_n_(data_ + keep, cnt);
+        } else {
+            // Non-assignable and the move may throw: relocate in place, as in
+            // emplace. If a move throws, slot i is raw and the rest are dropped.
+            size_type i = start;
+            try {
+                for (; i < keep; ++i) { destroy_at_(data_ + i); construct_at_(data_ + i, std::move_if_noexcept(data_[i + cnt])); }
+            } catch (...) {
+                destroy_n_(data_ + i + 1, size_ - i - 1);
+                size_ = i;
+                throw;
+            }
+            destroy_n_(data_ + keep, cnt);
+        }
+        size_ = keep;
+        return begin() + start;
+    }
+
+    /** @brief Resizes to count elements (default construction). */
+    template<typename U = T, std::enable_if_t<std::is_default_constructible_v<U>, int> = 0>
+    void resize(size_type count) {
+        if (count <= size_) { destroy_n_(data_ + count, size_ - count); size_ = count; return; }
+        reserve(count);
+        for (; size_ < count; ++size_) construct_at_(data_ + size_);
+    }
+    /** @brief Resizes to count elements (copying value). */
+    void resize(size_type count, const value_type& value) {
+        if (count <= size_) { destroy_n_(data_ + count, size_ - count); size_ = count; return; }
+        if (count > cap_) { T tmp(value); reserve(count); resize(count, tmp); return; } // value may alias
+        for (; size_ < count; ++size_) construct_at_(data_ + size_, value);
+    }
+
+    /**
+     * @brief Exchanges contents. Heap blocks change owner; elements in a borrowed
+     * buffer are moved, since each buffer stays with its container. A side whose
+     * buffered elements do not fit the other's buffer first moves them to its own
+     * heap block, so `swap` may allocate.
+     */
+    void swap(InlinedVectorRef& other) {
+        if (this == &other) return;
+        if (!on_heap_() && size_ > other.buffer_cap_) reallocate_(size_);
+        if (!other.on_heap_() && other.size_ > buffer_cap_) other.reallocate_(other.size_);
+        using POCS = typename AllocTraits::propagate_on_container_swap;
+        if constexpr (POCS::value) {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        } else {
+            assert(alloc_ == other.alloc_ && "Cannot swap InlinedVectorRefs with unequal non-propagating allocators");
+        }
+
+        if (on_heap_() && other.on_heap_()) {
+            std::swap(data_, other.data_); std::swap(size_, other.size_); std::swap(cap_, other.cap_);
+        } else if (!on_heap_() && !other.on_heap_()) {
+            swap_buffered_(other);
+        } else {
+            // One heap block, one buffer: the buffered elements move into the free buffer
+            InlinedVectorRef& h = on_heap_() ? *this : other;
+            InlinedVectorRef& b = on_heap_() ? other : *this;
+            try { h.transfer_(b.data_, b.size_, h.buffer_); }
+            catch (...) { if constexpr (POCS::value) { using std::swap; swap(alloc_, other.alloc_); } throw; }
+            b.destroy_n_(b.data_, b.size_);
+            b.data_ = h.data_; b.cap_ = h.cap_;
+            h.data_ = h.buffer_; h.cap_ = h.buffer_cap_;
+            std::swap(h.size_, b.size_);
+        }
+    }
+
+    // ========================================================================
+    // Comparison operators
+    // ========================================================================
+    friend bool operator==(const InlinedVectorRef& lhs, const InlinedVectorRef& rhs) {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+    friend bool operator!=(const InlinedVectorRef& lhs, const InlinedVectorRef& rhs) { return !(lhs == rhs); }
+    friend bool operator<(const InlinedVectorRef& lhs, const InlinedVectorRef& rhs) {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+    friend bool operator<=(const InlinedVectorRef& lhs, const InlinedVectorRef& rhs) { return !(rhs < lhs); }
+    friend bool operator>(const InlinedVectorRef& lhs, const InlinedVectorRef& rhs) { return rhs < lhs; }
+    friend bool operator>=(const InlinedVectorRef& lhs, const InlinedVectorRef& rhs) { return !(lhs < rhs); }
+
+private:
+    /** @brief `swap` when both sides are buffered and each fits the other's buffer. */
+    void swap_buffered_(InlinedVectorRef& other) {
+        using std::swap;
+        const size_type common = std::min(size_, other.size_);
+        for (size_type i = 0; i < common; ++i) {
+            if constexpr (std::is_swappable_v<T>) {
+                swap(data_[i], other.data_[i]);
+            } else {
+                // Non-assignable: swap by relocation through a temporary
+                T tmp(std::move(data_[i]));
+                destroy_at_(data_ + i);
+                construct_at_(data_ + i, std::move(other.data_[i]));
+                other.destroy_at_(other.data_ + i);
+                other.construct_at_(other.data_ + i, std::move(tmp));
+            }
+        }
+        InlinedVectorRef& longer = size_ > common ? *this : other;
+        InlinedVectorRef& shorter = size_ > common ? other : *this;
+        size_type i = common;
+        try {
+            for (; i < longer.size_; ++i) {
+                shorter.construct_at_(shorter.data_ + i, std::move_if_noexcept(longer.data_[i]));
+                ++shorter.size_;
+                longer.destroy_at_(longer.data_ + i);
+            }
+        } catch (...) {
+            longer.destroy_n_(longer.data_ + i, longer.size_ - i);
+            longer.size_ = common;
+            throw;
+        }
+        longer.size_ = common;
+    }
+};
+
+/** @brief Non-member swap for InlinedVectorRef. */
+template<typename T, typename Alloc>
+void swap(InlinedVectorRef<T, Alloc>& lhs, InlinedVectorRef<T, Alloc>& rhs) { lhs.swap(rhs); }
+
+// ============================================================================
+// PolyInlinedVector: heterogeneous derived objects stored inline
+// ============================================================================
+
+namespace detail {
+/** @brief Per-type thunks used by `PolyInlinedVector` to move and destroy erased objects. */
+struct poly_ops {
+    void (*relocate)(void* dst, void* src) noexcept; // Move-construct at dst, destroy src
+    void (*destroy)(void* p) noexcept;
+    std::size_t size;
+    std::size_t align;
+};
+
+template<typename D>
+inline constexpr poly_ops poly_ops_for = {
+    [](void* dst, void* src) noexcept {
+        D* s = std::launder(static_cast<D*>(src));
+        ::new (dst) D(std::move(*s));
+        s->~D();
+    },
+    [](void* p) noexcept { std::launder(static_cast<D*>(p))->~D(); },
+    sizeof(D),
+    alignof(D),
+};
+} // namespace detail
+
+/**
+ * @brief A sequence of objects derived from `Base`, with different sizes, that
+ * are placement-constructed into one byte region instead of one allocation each.
+ *
+ * The first `Bytes` bytes live inline. Past that, the region moves to a single
+ * heap block, and elements are relocated through a per-type move thunk that
+ * keeps their offsets. An offset table (an `InlinedVector`) maps indices to
+ * objects. Iterating yields `Base&`, so calls dispatch virtually as they would
+ * through `unique_ptr<Base>`. `Base` does not need a virtual destructor,
+ * because each element is destroyed as its own type.
+ *
+ * Elements must be nothrow move-constructible (they are relocated on growth
+ * and erase) and no more aligned than `std::max_align_t`. The container is
+ * move-only.
+ *
+ * @tparam Base Common base class of the stored objects.
+ * @tparam Bytes Size of the inline byte region.
+ */
+template<typename Base, std::size_t Bytes>
+class PolyInlinedVector {
+public:
+    using value_type = Base;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = Base&;
+    using const_reference = const Base&;
+
+    static_assert(Bytes > 0, "PolyInlinedVector requires a non-empty inline region");
+
+    /** @brief Size of the inline byte region. */
+    static constexpr size_type inline_bytes = Bytes;
+
+private:
+    struct Entry {
+        std::uint32_t offset;    // Object start within the region
+        std::int32_t base_delta; // Base subobject address minus object address
+        const detail::poly_ops* ops;
+    };
+    static constexpr size_type kAlign = alignof(std::max_align_t);
+    static constexpr size_type kTableInline = Bytes / 16 > 0 ? Bytes / 16 : 1;
+    using BlockAlloc = std::allocator<std::max_align_t>;
+
+    alignas(std::max_align_t) std::byte inline_[Bytes];
+    std::byte* data_ = inline_;
+    size_type used_ = 0;
+    size_type cap_ = Bytes;
+    InlinedVector<Entry, kTableInline> entries_;
+
+    static size_type align_up_(size_type n, size_type a) noexcept { return (n + a - 1) & ~(a - 1); }
+
+    bool on_heap_() const noexcept { return data_ != inline_; }
+
+    Base* base_at_(const Entry& e) const noexcept {
+        return std::launder(reinterpret_cast<Base*>(data_ + e.offset + e.base_delta));
+    }
+
+    void release_() noexcept {
+        if (on_heap_()) BlockAlloc{}.deallocate(reinterpret_cast<std::max_align_t*>(data_), cap_ / kAlign);
+    }
+
+    /** @brief Relocates every element into `dst` at the same offsets; `dst` becomes the region. */
+    void adopt_region_(std::byte* dst, size_type cap) noexcept {
+        for (const Entry& e : entries_) e.ops->relocate(dst + e.offset, data_ + e.offset);
+        release_();
+        data_ = dst;
+        cap_ = cap;
+    }
+
+    std::byte* allocate_(size_type cap) {
+        assert(cap <= std::numeric_limits<std::uint32_t>::max() && "PolyInlinedVector: region exceeds 4 GiB");
+        return reinterpret_cast<std::byte*>(BlockAlloc{}.allocate(cap / kAlign));
+    }
+
+    /**
+     * @brief Relocates elements `[first, size())` as low as possible, starting at
+     * `cursor`. Skips a move whenever source and destination would overlap.
+     */
+    void compact_from_(size_type first, size_type cursor) noexcept {
+        for (size_type i = first; i < entries_.size(); ++i) {
+            Entry& e = entries_[i];
+            const size_type dst = align_up_(cursor, e.ops->align);
+            if (dst + e.ops->size <= e.offset) {
+                e.ops->relocate(data_ + dst, data_ + e.offset);
+                e.offset = static_cast<std::uint32_t>(dst);
+            }
+            cursor = e.offset + e.ops->size;
+        }
+        used_ = cursor;
+    }
+
+    void steal_(PolyInlinedVector& other) noexcept {
+        entries_ = std::move(other.entries_);
+        used_ = other.used_;
+        if (other.on_heap_()) {
+            data_ = other.data_;
+            cap_ = other.cap_;
+        } else {
+            for (const Entry& e : entries_) e.ops->relocate(inline_ + e.offset, other.data_ + e.offset);
+        }
+        other.entries_.clear();
+        other.data_ = other.inline_;
+        other.used_ = 0;
+        other.cap_ = Bytes;
+    }
+
+public:
+    // ========================================================================
+    // Iterators (yield Base&)
+    // ========================================================================
+    template<bool Const>
+    class basic_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Base;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const Base&, Base&>;
+        using pointer = std::conditional_t<Const, const Base*, Base*>;
+
+        basic_iterator() noexcept = default;
+        template<bool C = Const, std::enable_if_t<C, int> = 0>
+        basic_iterator(const basic_iterator<false>& o) noexcept : owner_(o.owner_), i_(o.i_) {}
+
+        reference operator*() const noexcept { return *owner_->base_at_(owner_->entries_[i_]); }
+        pointer operator->() const noexcept { return owner_->base_at_(owner_->entries_[i_]); }
+        reference operator[](difference_type n) const noexcept { return *(*this + n); }
+        basic_iterator& operator++() noexcept { ++i_; return *this; }
+        basic_iterator operator++(int) noexcept { basic_iterator t = *this; ++i_; return t; }
+        basic_iterator& operator--() noexcept { --i_; return *this; }
+        basic_iterator operator--(int) noexcept { basic_iterator t = *this; --i_; return t; }
+        basic_iterator& operator+=(difference_type n) noexcept { i_ += n; return *this; }
+        basic_iterator& operator-=(difference_type n) noexcept { i_ -= n; return *this; }
+        friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept { return it += n; }
+        friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept { return it -= n; }
+        friend difference_type operator-(const basic_iterator& a, const basic_iterator& b) noexcept {
+            return static_cast<difference_type>(a.i_) - static_cast<difference_type>(b.i_);
+        }
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept { return a.i_ == b.i_; }
+        friend bool operator!=(const basic_iterator& a, const basic_iterator& b) noexcept { return a.i_ != b.i_; }
+        friend bool operator<(const basic_iterator& a, const basic_iterator& b) noexcept { return a.i_ < b.i_; }
+
+    private:
+        friend class PolyInlinedVector;
+        using Owner = std::conditional_t<Const, const PolyInlinedVector, PolyInlinedVector>;
+        basic_iterator(Owner* owner, size_type i) noexcept : owner_(owner), i_(i) {}
+        Owner* owner_ = nullptr;
+        size_type i_ = 0;
+    };
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    // ========================================================================
+    // Construction
+    // ========================================================================
+    PolyInlinedVector() noexcept = default;
+    PolyInlinedVector(const PolyInlinedVector&) = delete;
+    PolyInlinedVector& operator=(const PolyInlinedVector&) = delete;
+    /** @brief Steals a heap region, or relocates inline elements. */
+    PolyInlinedVector(PolyInlinedVector&& other) noexcept { steal_(other); }
+    PolyInlinedVector& operator=(PolyInlinedVector&& other) noexcept {
+        if (this != &other) { clear(); release_(); data_ = inline_; cap_ = Bytes; steal_(other); }
+        return *this;
+    }
+    ~PolyInlinedVector() { clear(); release_(); }
+
+    // ========================================================================
+    // Element Access
+    // ========================================================================
+    Base& operator[](size_type i) noexcept { assert(i < size()); return *base_at_(entries_[i]); }
+    const Base& operator[](size_type i) const noexcept { assert(i < size()); return *base_at_(entries_[i]); }
+    Base& front() noexcept { return (*this)[0]; }
+    const Base& front() const noexcept { return (*this)[0]; }
+    Base& back() noexcept { return (*this)[size() - 1]; }
+    const Base& back() const noexcept { return (*this)[size() - 1]; }
+
+    iterator begin() noexcept { return iterator(this, 0); }
+    iterator end() noexcept { return iterator(this, size()); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, size()); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // ========================================================================
+    // Capacity
+    // ========================================================================
+    [[nodiscard]] bool empty() const noexcept { return entries_.empty(); }
+    [[nodiscard]] size_type size() const noexcept { return entries_.size(); }
+    /** @brief True while the objects live in the inline region. */
+    [[nodiscard]] bool is_inline() const noexcept { return !on_heap_(); }
+    /** @brief Bytes of the region in use, including alignment padding. */
+    [[nodiscard]] size_type bytes_used() const noexcept { return used_; }
+    /** @brief Size of the current region (inline or heap). */
+    [[nodiscard]] size_type capacity_bytes() const noexcept { return cap_; }
+    /** @brief `sizeof(*this)` plus the heap region and the spilled offset table. */
+    [[nodiscard]] size_type memory_usage() const noexcept {
+        return entries_.memory_usage() - sizeof(entries_) + sizeof(*this) + (on_heap_() ? cap_ : 0);
+    }
+
+    /** @brief Ensures the region holds at least `bytes` without reallocating. */
+    void reserve_bytes(size_type bytes) {
+        if (bytes <= cap_) return;
+        const size_type cap = align_up_(bytes, kAlign);
+        adopt_region_(allocate_(cap), cap);
+    }
+
+    /** @brief Compacts the region, moving back inline if the objects fit. */
+    void shrink_to_fit() {
+        compact_from_(0, 0);
+        if (!on_heap_()) return;
+        if (used_ <= Bytes) { adopt_region_(inline_, Bytes); return; }
+        const size_type cap = align_up_(used_, kAlign);
+        if (cap < cap_) adopt_region_(allocate_(cap), cap);
+    }
+
+    // ========================================================================
+    // Modifiers
+    // ========================================================================
+
+    /**
+     * @brief Constructs a `D` at the end of the region. Spills to, or grows,
+     * the heap region if it does not fit. Strong guarantee.
+     */
+    template<typename D, typename... Args>
+    D& emplace_back(Args&&... args) {
+        static_assert(std::is_base_of_v<Base, D>, "PolyInlinedVector elements must derive from Base");
+        static_assert(std::is_nothrow_move_constructible_v<D>, "PolyInlinedVector relocates elements: D must be nothrow move-constructible");
+        static_assert(alignof(D) <= kAlign, "PolyInlinedVector supports alignments up to alignof(std::max_align_t)");
+        entries_.reserve(entries_.size() + 1); // The push below cannot throw
+        const size_type offset = align_up_(used_, alignof(D));
+        const size_type need = offset + sizeof(D);
+        D* obj;
+        if (need <= cap_) {
+            obj = ::new (static_cast<void*>(data_ + offset)) D(std::forward<Args>(args)...);
+        } else {
+            const size_type cap = align_up_(std::max(need, 2 * cap_), kAlign);
+            std::byte* block = allocate_(cap);
+            try {
+                obj = ::new (static_cast<void*>(block + offset)) D(std::forward<Args>(args)...);
+            } catch (...) {
+                BlockAlloc{}.deallocate(reinterpret_cast<std::max_align_t*>(block), cap / kAlign);
+                throw;
+            }
+            adopt_region_(block, cap);
+        }
+        const auto delta = reinterpret_cast<const std::byte*>(static_cast<Base*>(obj)) - reinterpret_cast<const std::byte*>(obj);
+        entries_.push_back(Entry{static_cast<std::uint32_t>(offset), static_cast<std::int32_t>(delta), &detail::poly_ops_for<D>});
+        used_ = need;
+        return *obj;
+    }
+
+    /** @brief Moves or copies `obj` (deduced as its own type) to the end. */
+    template<typename D, std::enable_if_t<std::is_base_of_v<Base, std::decay_t<D>>, int> = 0>
+    std::decay_t<D>& push_back(D&& obj) { return emplace_back<std::decay_t<D>>(std::forward<D>(obj)); }
+
+    /** @brief Destroys the last object and returns its bytes to the region. */
+    void pop_back() noexcept {
+        assert(!empty());
+        const Entry e = entries_.back();
+        e.ops->destroy(data_ + e.offset);
+        entries_.pop_back();
+        used_ = empty() ? 0 : entries_.back().offset + entries_.back().ops->size;
+    }
+
+    /** @brief Destroys the object at `pos` and relocates later objects down. */
+    iterator erase(const_iterator pos) noexcept {
+        const size_type i = pos.i_;
+        const Entry e = entries_[i];
+        e.ops->destroy(data_ + e.offset);
+        entries_.erase(entries_.begin() + i);
+        const size_type cursor = i == 0 ? 0 : entries_[i - 1].offset + entries_[i - 1].ops->size;
+        compact_from_(i, cursor);
+        return iterator(this, i);
+    }
+
+    /** @brief Destroys all objects. Keeps the current region. */
+    void clear() noexcept {
+        for (const Entry& e : entries_) e.ops->destroy(data_ + e.offset);
+        entries_.clear();
+        used_ = 0;
+    }
+};
+
+// ============================================================================
+// InlinedByteBuffer: I/O byte buffer with spare capacity and a read cursor
+// ============================================================================
+
+/**
+ * @brief A contiguous byte buffer for network and file I/O. Its first `N`
+ * bytes of capacity are inline.
+ *
+ * The layout is `[consumed | readable | writable]`. Callers read straight into
+ * the spare capacity with `prepare(n)` and then `commit(bytes_read)`, in the
+ * style of Asio's `dynamic_buffer`. `consume(n)` advances a read cursor, so
+ * dropping parsed bytes never shifts the rest. Readable bytes are moved to the
+ * front only when `prepare` needs the room, and the buffer grows only when
+ * compaction is not enough.
+ *
+ * `data_iovecs` and `prepare_iovecs` fill any struct with `iov_base`/`iov_len`
+ * members (POSIX `iovec`) without this header depending on `<sys/uio.h>`.
+ * Storage is contiguous, so each buffer contributes a single segment. Gather
+ * several buffers into one `writev`/`readv` by calling them in turn.
+ *
+ * @tparam N Inline capacity in bytes.
+ * @tparam Alloc Allocator for the heap block (`std::byte` value type).
+ */
+template<std::size_t N, typename Alloc = std::allocator<std::byte>>
+class InlinedByteBuffer {
+public:
+    using value_type = std::byte;
+    using size_type = std::size_t;
+    using allocator_type = Alloc;
+
+    static_assert(std::is_same_v<typename Alloc::value_type, std::byte>, "InlinedByteBuffer requires an allocator of std::byte");
+    static_assert(N > 0, "InlinedByteBuffer requires a non-zero inline capacity");
+
+    /** @brief Number of bytes that fit without heap allocation. */
+    static constexpr size_type inline_capacity = N;
+
+private:
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    std::byte inline_[N];
+    std::byte* data_ = inline_;
+    size_type cap_ = N;
+    size_type read_ = 0;   // Start of readable bytes
+    size_type write_ = 0;  // End of readable bytes, start of spare capacity
+    LLOYAL_NO_UNIQUE_ADDRESS allocator_type alloc_;
+
+    bool on_heap_() const noexcept { return data_ != inline_; }
+    void release_() noexcept { if (on_heap_()) AllocTraits::deallocate(alloc_, data_, cap_); }
+
+    /** @brief Moves the readable bytes into `dst[0, size())`, which becomes the storage. */
+    void adopt_(std::byte* dst, size_type cap) noexcept {
+        const size_type n = size();
+        if (n) std::memmove(dst, data_ + read_, n);
+        if (dst != data_) release_();
+        data_ = dst; cap_ = cap; read_ = 0; write_ = n;
+    }
+
+    void assign_from_(const InlinedByteBuffer& other) {
+        const size_type n = other.size();
+        if (n > cap_) {
+            std::byte* block = AllocTraits::allocate(alloc_, n);
+            release_();
+            data_ = block; cap_ = n;
+        }
+        if (n) std::memcpy(data_, other.data(), n);
+        read_ = 0; write_ = n;
+    }
+
+    void steal_(InlinedByteBuffer& other) noexcept {
+        if (other.on_heap_()) {
+            data_ = other.data_; cap_ = other.cap_; read_ = other.read_; write_ = other.write_;
+        } else {
+            const size_type n = other.size();
+            if (n) std::memcpy(inline_, other.data(), n);
+            data_ = inline_; cap_ = N; read_ = 0; write_ = n;
+        }
+        other.data_ = other.inline_; other.cap_ = N; other.read_ = other.write_ = 0;
+    }
+
+public:
+    // ========================================================================
+    // Construction
+    // ========================================================================
+    explicit InlinedByteBuffer(const Alloc& alloc = Alloc{}) noexcept : alloc_(alloc) {}
+    InlinedByteBuffer(const InlinedByteBuffer& other)
+        : alloc_(AllocTraits::select_on_container_copy_construction(other.alloc_)) { assign_from_(other); }
+    InlinedByteBuffer(InlinedByteBuffer&& other) noexcept : alloc_(std::move(other.alloc_)) { steal_(other); }
+    InlinedByteBuffer& operator=(const InlinedByteBuffer& other) {
+        if (this != &other) { clear(); assign_from_(other); }
+        return *this;
+    }
+    /** @brief Steals a heap block when allocators compare equal, else copies the bytes. */
+    InlinedByteBuffer& operator=(InlinedByteBuffer&& other) noexcept(AllocTraits::is_always_equal::value) {
+        if (this == &other) return *this;
+        if (alloc_ == other.alloc_) { release_(); steal_(other); }
+        else { clear(); assign_from_(other); other.clear(); }
+        return *this;
+    }
+    ~InlinedByteBuffer() { release_(); }
+
+    allocator_type get_allocator() const noexcept { return alloc_; }
+
+    // ========================================================================
+    // Readable bytes
+    // ========================================================================
+    /** @brief Number of committed, unconsumed bytes. */
+    [[nodiscard]] size_type size() const noexcept { return write_ - read_; }
+    [[nodiscard]] bool empty() const noexcept { return write_ == read_; }
+    /** @brief Pointer to the first readable byte. */
+    std::byte* data() noexcept { return data_ + read_; }
+    /** @brief Pointer to the first readable byte. */
+    const std::byte* data() const noexcept { return data_ + read_; }
+
+    /** @brief Drops `n` readable bytes from the front by advancing the read cursor. */
+    void consume(size_type n) noexcept {
+        assert(n <= size());
+        read_ += n;
+        if (read_ == write_) read_ = write_ = 0; // Empty: rewind for free
+    }
+
+    // ========================================================================
+    // Writable spare capacity
+    // ========================================================================
+    /** @brief Total bytes the current storage holds, including consumed and spare bytes. */
+    [[nodiscard]] size_type capacity() const noexcept { return cap_; }
+    /** @brief Bytes writable after the readable region without compaction or growth. */
+    [[nodiscard]] size_type spare() const noexcept { return cap_ - write_; }
+    /** @brief True while the bytes live in the inline buffer. */
+    [[nodiscard]] bool is_inline() const noexcept { return !on_heap_(); }
+
+    /**
+     * @brief Returns at least `n` writable bytes after the readable region. It
+     * compacts consumed bytes away first, and grows only if that is not enough.
+     * Invalidates pointers from earlier `data()`/`prepare()` calls when it moves
+     * bytes.
+     */
+    std::byte* prepare(size_type n) {
+        if (n <= spare()) return data_ + write_;
+        const size_type readable = size();
+        if (readable + n <= cap_) {
+            adopt_(data_, cap_); // Compact in place
+        } else {
+            const size_type cap = std::max(cap_ * 2, readable + n);
+            adopt_(AllocTraits::allocate(alloc_, cap), cap);
+        }
+        return data_ + write_;
+    }
+
+    /** @brief Makes `n` bytes written into the prepared region readable. */
+    void commit(size_type n) noexcept { assert(n <= spare()); write_ += n; }
+
+    /** @brief Copies `n` bytes to the end: `prepare` + `memcpy` + `commit`. */
+    void append(const void* src, size_type n) {
+        if (n == 0) return;
+        std::memcpy(prepare(n), src, n);
+        commit(n);
+    }
+
+    // ========================================================================
+    // Scatter/gather export
+    // ========================================================================
+    /**
+     * @brief Writes the readable region into `out` (an `iovec`-like struct with
+     * `iov_base`/`iov_len`). Returns the number of entries written: 0 or 1.
+     */
+    template<typename IoVec>
+    size_type data_iovecs(IoVec* out, size_type max_count) const noexcept {
+        if (empty() || max_count == 0) return 0;
+        out[0].iov_base = const_cast<std::byte*>(data());
+        out[0].iov_len = size();
+        return 1;
+    }
+
+    /** @brief `prepare(n)`, then writes the writable region into `out`. Returns the entries written: 1. */
+    template<typename IoVec>
+    size_type prepare_iovecs(IoVec* out, size_type n) {
+        out[0].iov_base = prepare(n);
+        out[0].iov_len = spare();
+        return 1;
+    }
+
+    // ========================================================================
+    // Housekeeping
+    // ========================================================================
+    /** @brief Drops all bytes. Keeps the current storage. */
+    void clear() noexcept { read_ = write_ = 0; }
+
+    /** @brief Compacts; returns to inline storage when the readable bytes fit. */
+    void shrink_to_fit() {
+        if (!on_heap_()) { adopt_(data_, cap_); return; }
+        const size_type n = size();
+        if (n <= N) adopt_(inline_, N);
+        else if (n < cap_) adopt_(AllocTraits::allocate(alloc_, n), n);
+    }
+
+    /** @brief `sizeof(*this)` plus the heap block, if any. */
+    [[nodiscard]] size_type memory_usage() const noexcept { return sizeof(*this) + (on_heap_() ? cap_ : 0); }
+};
+
+// ============================================================================
+// InlinedSpscRing: single-producer single-consumer ring with inline slots
+// ============================================================================
+
+/** @brief What `InlinedSpscRing` does when the producer finds every slot full. */
+enum class ring_overflow {
+    reject, ///< Pushes fail (or `push_n` pushes fewer). The ring never allocates.
+    heap    ///< Pushes continue into a heap segment linked after the full one
+};
+
+namespace detail {
+// Assumed destructive-interference size. std::hardware_destructive_interference_size
+// is missing from several of the standard libraries we support.
+inline constexpr std::size_t spsc_cache_line = 64;
+} // namespace detail
+
+/**
+ * @brief A lock-free single-producer single-consumer FIFO whose first `N`
+ * slots live inline.
+ *
+ * Elements are constructed into their slot and destroyed out of it through the
+ * allocator, so `T` does not need to be assignable. The producer's index, the
+ * consumer's index and the segment link each sit on their own cache line. Each
+ * side caches its last view of the other's index, so an uncontended push or pop
+ * touches no shared line. `push_n`/`pop_n` publish a whole batch with a single
+ * release store.
+ *
+ * With `ring_overflow::heap` a full segment is never a failure. The producer
+ * links a heap segment twice the size of the last one after it, and the consumer
+ * frees each heap segment once it has drained it and the next one exists. When
+ * the producer fills the last heap segment after the consumer has drained the
+ * inline segment, it relinks the inline segment instead of allocating. FIFO order
+ * holds across segments. Unlike `InlinedVector`'s spill, nothing is relocated,
+ * because the consumer may still be reading the old slots.
+ *
+ * Exactly one thread may call the producer functions (`try_push`, `try_emplace`,
+ * `push_n`) and one the consumer functions (`try_pop`, `front`, `pop`, `pop_n`,
+ * `empty`). Under `ring_overflow::heap` both threads use the allocator, so it must
+ * be stateless or thread-safe.
+ *
+ * @tparam T Element type.
+ * @tparam N Number of inline slots.
+ * @tparam Overflow Behaviour when the ring is full.
+ * @tparam Alloc Allocator used for construction and heap segments.
+ */
+template<typename T, std::size_t N, ring_overflow Overflow = ring_overflow::reject, typename Alloc = std::allocator<T>>
+class InlinedSpscRing {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using allocator_type = Alloc;
+
+    static_assert(N > 0, "InlinedSpscRing requires at least one inline slot");
+
+    /** @brief Number of slots in the inline segment. */
+    static constexpr size_type inline_capacity = N;
+
+private:
+    using AllocTraits = std::allocator_traits<Alloc>;
+    static constexpr std::size_t kLine = detail::spsc_cache_line;
+
+    struct Segment {
+        // Producer line
+        alignas(kLine) std::atomic<size_type> tail{0}; // Elements published, ever
+        size_type cached_head = 0;                      // Producer's last view of head
+        size_type tail_slot = 0;                        // tail % cap, kept without division
+        // Consumer line
+        alignas(kLine) std::atomic<size_type> head{0};  // Elements consumed, ever
+        size_type cached_tail = 0;                      // Consumer's last view of tail
+        size_type head_slot = 0;                        // head % cap
+        // Read-mostly
+        alignas(kLine) std::atomic<Segment*> next{nullptr};
+        T* slots = nullptr;
+        size_type cap = 0;
+    };
+    using SegAlloc = typename AllocTraits::template rebind_alloc<Segment>;
+    using SegTraits = std::allocator_traits<SegAlloc>;
+
+    Segment inline_seg_;
+    alignas(alignof(T) > kLine ? alignof(T) : kLine) std::byte inline_slots_[N * sizeof(T)];
+    alignas(kLine) Segment* prod_ = &inline_seg_;      // Producer-only
+    size_type next_cap_ = 2 * N;                       // Producer-only: size of the next heap segment
+    alignas(kLine) Segment* cons_ = &inline_seg_;      // Consumer-only
+    alignas(kLine) std::atomic<bool> inline_free_{false}; // Consumer has drained and unlinked the inline segment
+    LLOYAL_NO_UNIQUE_ADDRESS allocator_type alloc_;
+
+    Segment* allocate_segment_(size_type cap) {
+        SegAlloc sa(alloc_);
+        Segment* s = SegTraits::allocate(sa, 1);
+        T* slots;
+        try { slots = AllocTraits::allocate(alloc_, cap); }
+        catch (...) { SegTraits::deallocate(sa, s, 1); throw; }
+        ::new (static_cast<void*>(s)) Segment(); // Begin the lifetime before touching members
+        s->slots = slots;
+        s->cap = cap;
+        return s;
+    }
+
+    void deallocate_segment_(Segment* s) noexcept {
+        AllocTraits::deallocate(alloc_, s->slots, s->cap);
+        s->~Segment();
+        SegAlloc sa(alloc_);
+        SegTraits::deallocate(sa, s, 1);
+    }
+
+    /**
+     * @brief Producer: the segment to write into and its free slot count. Links a
+     * new segment when the current one is full under `ring_overflow::heap`.
+     * Returns nullptr when full under `ring_overflow::reject`.
+     */
+    Segment* producer_segment_(size_type want, size_type& free) {
+        Segment* s = prod_;
+        const size_type t = s->tail.load(std::memory_order_relaxed);
+        free = s->cap - (t - s->cached_head);
+        if (free < want) {
+            s->cached_head = s->head.load(std::memory_order_acquire);
+            free = s->cap - (t - s->cached_head);
+        }
+        if (free > 0) return s;
+        if constexpr (Overflow == ring_overflow::reject) {
+            return nullptr;
+        } else {
+            Segment* n;
+            if (inline_free_.load(std::memory_order_acquire)) {
+                n = &inline_seg_; // Drained and unlinked by the consumer: reuse it
+                inline_free_.store(false, std::memory_order_relaxed);
+                n->next.store(nullptr, std::memory_order_relaxed);
+                n->cached_head = n->head.load(std::memory_order_acquire);
+            } else {
+                n = allocate_segment_(next_cap_);
+                next_cap_ *= 2;
+            }
+            s->next.store(n, std::memory_order_release); // Producer never touches s again
+            prod_ = n;
+            free = n->cap - (n->tail.load(std::memory_order_relaxed) - n->cached_head);
+            return n;
+        }
+    }
+
+    /**
+     * @brief Consumer: the segment to read from and its readable count. Retires
+     * drained segments that have a successor. Returns nullptr when empty.
+     */
+    Segment* consumer_segment_(size_type want, size_type& avail) {
+        for (;;) {
+            Segment* s = cons_;
+            const size_type h = s->head.load(std::memory_order_relaxed);
+            avail = s->cached_tail - h;
+            if (avail < want) {
+                s->cached_tail = s->tail.load(std::memory_order_acquire);
+                avail = s->cached_tail - h;
+            }
+            if (avail > 0) return s;
+            if constexpr (Overflow == ring_overflow::reject) {
+                return nullptr;
+            } else {
+                Segment* n = s->next.load(std::memory_order_acquire);
+                if (!n) return nullptr;
+                // The producer published its last element into s before linking n
+                s->cached_tail = s->tail.load(std::memory_order_acquire);
+                if (s->cached_tail != h) { avail = s->cached_tail - h; return s; }
+                cons_ = n;
+                if (s == &inline_seg_) inline_free_.store(true, std::memory_order_release);
+                else deallocate_segment_(s);
+            }
+        }
+    }
+
+public:
+    // ========================================================================
+    // Construction
+    // ========================================================================
+    explicit InlinedSpscRing(const Alloc& alloc = Alloc{}) noexcept : alloc_(alloc) {
+        inline_seg_.slots = std::launder(reinterpret_cast<T*>(inline_slots_));
+        inline_seg_.cap = N;
+    }
+    InlinedSpscRing(const InlinedSpscRing&) = delete;
+    InlinedSpscRing& operator=(const InlinedSpscRing&) = delete;
+
+    /** @brief Destroys the remaining elements. Neither thread may still be using the ring. */
+    ~InlinedSpscRing() {
+        Segment* s = cons_;
+        while (s) {
+            size_type slot = s->head_slot;
+            const size_type tail = s->tail.load(std::memory_order_acquire);
+            for (size_type i = s->head.load(std::memory_order_relaxed); i != tail; ++i) {
+                AllocTraits::destroy(alloc_, s->slots + slot);
+                if (++slot == s->cap) slot = 0;
+            }
+            Segment* n = s->next.load(std::memory_order_acquire);
+            if (s != &inline_seg_) deallocate_segment_(s);
+            s = n;
+        }
+    }
+
+    allocator_type get_allocator() const noexcept { return alloc_; }
+
+    /** @brief Number of inline slots. Under `ring_overflow::reject`, the most elements the ring ever holds. */
+    [[nodiscard]] static constexpr size_type capacity() noexcept { return N; }
+
+    // ========================================================================
+    // Producer
+    // ========================================================================
+    /** @brief Constructs an element at the back. Returns false if the ring is full (reject mode only). */
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        size_type free;
+        Segment* s = producer_segment_(1, free);
+        if (!s) return false;
+        const size_type t = s->tail.load(std::memory_order_relaxed);
+        AllocTraits::construct(alloc_, s->slots + s->tail_slot, std::forward<Args>(args)...);
+        if (++s->tail_slot == s->cap) s->tail_slot = 0;
+        s->tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    bool try_push(const T& value) { return try_emplace(value); }
+    bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+    /**
+     * @brief Constructs up to `count` elements from `first` (pass a move iterator
+     * to move). Publishes each segment's run with one release store. Returns the
+     * number pushed, which is less than `count` only when the ring is full in
+     * reject mode. If a constructor throws, the elements before it stay published.
+     */
+    template<typename InputIt>
+    size_type push_n(InputIt first, size_type count) {
+        size_type done = 0;
+        while (done < count) {
+            size_type free;
+            Segment* s = producer_segment_(count - done, free);
+            if (!s) break;
+            const size_type t = s->tail.load(std::memory_order_relaxed);
+            const size_type n = std::min(free, count - done);
+            size_type k = 0;
+            try {
+                for (; k < n; ++k, ++first) {
+                    AllocTraits::construct(alloc_, s->slots + s->tail_slot, *first);
+                    if (++s->tail_slot == s->cap) s->tail_slot = 0;
+                }
+            } catch (...) {
+                s->tail.store(t + k, std::memory_order_release);
+                throw;
+            }
+            s->tail.store(t + n, std::memory_order_release);
+            done += n;
+        }
+        return done;
+    }
+
+    // ========================================================================
+    // Consumer
+    // ========================================================================
+    /** @brief True if no element is currently visible to the consumer. */
+    [[nodiscard]] bool empty() {
+        size_type avail;
+        return consumer_segment_(1, avail) == nullptr;
+    }
+
+    /** @brief The oldest element, in place, or nullptr if the ring is empty. */
+    T* front() {
+        size_type avail;
+        Segment* s = consumer_segment_(1, avail);
+        return s ? s->slots + s->head_slot : nullptr;
+    }
+
+    /** @brief Destroys the oldest element. Requires `front() != nullptr`. */
+    void pop() {
+        size_type avail;
+        Segment* s = consumer_segment_(1, avail);
+        assert(s && "pop() on an empty InlinedSpscRing");
+        const size_type h = s->head.load(std::memory_order_relaxed);
+        AllocTraits::destroy(alloc_, s->slots + s->head_slot);
+        if (++s->head_slot == s->cap) s->head_slot = 0;
+        s->head.store(h + 1, std::memory_order_release);
+    }
+
+    /** @brief Moves out and destroys the oldest element, or returns nullopt if the ring is empty. */
+    std::optional<T> try_pop() {
+        T* p = front();
+        if (!p) return std::nullopt;
+        std::optional<T> out(std::move(*p));
+        pop();
+        return out;
+    }
+
+    /**
+     * @brief Moves up to `max` elements to `out` as `*out++ = std::move(x)`, then
+     * destroys them. Use a back inserter for non-assignable `T`. Frees each segment's
+     * run with one release store and returns the number popped.
+     */
+    template<typename OutputIt>
+    size_type pop_n(OutputIt out, size_type max) {
+        size_type done = 0;
+        while (done < max) {
+            size_type avail;
+            Segment* s = consumer_segment_(max - done, avail);
+            if (!s) break;
+            const size_type h = s->head.load(std::memory_order_relaxed);
+            const size_type n = std::min(avail, max - done);
+            size_type k = 0;
+            try {
+                for (; k < n; ++k) {
+                    T* p = s->slots + s->head_slot;
+                    *out = std::move(*p);
+                    ++out;
+                    AllocTraits::destroy(alloc_, p);
+                    if (++s->head_slot == s->cap) s->head_slot = 0;
+                }
+            } catch (...) {
+                s->head.store(h + k, std::memory_order_release);
+                throw;
+            }
+            s->head.store(h + n, std::memory_order_release);
+            done += n;
+        }
+        return done;
+    }
+};
+
+// ============================================================================
+// IncrementalInlinedVector: growth with bounded worst-case push latency
+// ============================================================================
+
+/**
+ * @brief A vector whose growth never moves more than `Step` old elements in one
+ * call.
+ *
+ * When the storage is full, `push_back` allocates a buffer twice the size and
+ * constructs the new element there. The old elements stay where they are. Each
+ * later `push_back` (the growing one included) then moves up to `Step` of them
+ * across. Because the new buffer has room for as many pushes as there are old
+ * elements, the migration always finishes before the next growth. Until it
+ * finishes, `operator[]` and iterators look in either buffer by index. That
+ * costs one compare per access but no stall. Plain growth moves all elements at
+ * once: at a million elements that is milliseconds on one push.
+ *
+ * The storage is contiguous only when no migration is pending. `data()` and
+ * `reserve()` finish any pending migration first, at O(remaining) cost. The
+ * first `N` elements live inline, and the inline buffer is drained the same way
+ * once the vector spills.
+ *
+ * @tparam T Element type. Must be nothrow move-constructible, because a
+ * migration step cannot be rolled back.
+ * @tparam N Inline capacity.
+ * @tparam Alloc Allocator used for the heap buffers.
+ * @tparam Step Old elements migrated per `push_back`. Must be at least 1.
+ */
+template<typename T, std::size_t N, typename Alloc = std::allocator<T>, std::size_t Step = 2>
+class IncrementalInlinedVector {
+public:
+    // --- Member Types ---
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = T*;
+    using const_pointer = const T*;
+
+    static_assert(N > 0, "IncrementalInlinedVector requires a non-zero inline capacity");
+    static_assert(Step >= 1, "IncrementalInlinedVector must migrate at least one element per push");
+    static_assert(std::is_same_v<typename Alloc::value_type, T>, "Allocator::value_type must be T");
+    static_assert(std::is_nothrow_move_constructible_v<T>, "IncrementalInlinedVector requires T to be nothrow move-constructible");
+
+    /** @brief Number of old elements moved per `push_back` while migrating. */
+    static constexpr size_type migration_step = Step;
+
+private:
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    alignas(T) std::byte inline_[sizeof(T) * N];
+    pointer data_;               // Current buffer
+    size_type cap_ = N;
+    size_type size_ = 0;
+    pointer old_ = nullptr;      // Buffer being drained; nullptr when not migrating
+    size_type old_cap_ = 0;
+    size_type migrated_ = 0;     // Indices [migrated_, old_end_) still live in old_
+    size_type old_end_ = 0;
+    LLOYAL_NO_UNIQUE_ADDRESS allocator_type alloc_;
+
+    pointer inline_ptr_() noexcept { return std::launder(reinterpret_cast<pointer>(inline_)); }
+    bool is_inline_ptr_(const_pointer p) const noexcept { return static_cast<const void*>(p) == static_cast<const void*>(inline_); }
+
+    template<class... Args>
+    pointer construct_at_(pointer p, Args&&... args) {
+        AllocTraits::construct(alloc_, p, std::forward<Args>(args)...);
+        return p;
+    }
+    void destroy_at_(pointer p) noexcept { AllocTraits::destroy(alloc_, p); }
+
+    void deallocate_(pointer p, size_type n) noexcept { if (!is_inline_ptr_(p)) AllocTraits::deallocate(alloc_, p, n); }
+
+    /** @brief Where element `i` lives right now. One unsigned compare when not migrating. */
+    pointer slot_(size_type i) const noexcept {
+        return const_cast<pointer>(i - migrated_ < old_end_ - migrated_ ? old_ + i : data_ + i);
+    }
+
+    /** @brief Moves up to `k` pending elements from `old_` into `data_`; frees `old_` when drained. */
+    void migrate_(size_type k) noexcept {
+        if (!old_) return;
+        const size_type end = old_end_ - migrated_ > k ? migrated_ + k : old_end_;
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memcpy(static_cast<void*>(data_ + migrated_), static_cast<const void*>(old_ + migrated_), (end - migrated_) * sizeof(T));
+            migrated_ = end;
+        } else {
+            for (; migrated_ < end; ++migrated_) {
+                construct_at_(data_ + migrated_, std::move(old_[migrated_]));
+                destroy_at_(old_ + migrated_);
+            }
+        }
+        if (migrated_ == old_end_) {
+            deallocate_(old_, old_cap_);
+            old_ = nullptr; old_cap_ = 0; migrated_ = old_end_ = 0;
+        }
+    }
+
+    void destroy_all_() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_type i = 0; i < size_; ++i) destroy_at_(slot_(i));
+        }
+        if (old_) deallocate_(old_, old_cap_);
+        old_ = nullptr; old_cap_ = 0; migrated_ = old_end_ = 0;
+        size_ = 0;
+    }
+
+    /** @brief Moves every element into `[dst, dst + new_cap)`, which becomes the storage. No migration may be pending. */
+    void relocate_to_(pointer dst, size_type new_cap) noexcept {
+        if (dst != data_) {
+            for (size_type i = 0; i < size_; ++i) {
+                construct_at_(dst + i, std::move(data_[i]));
+                destroy_at_(data_ + i);
+            }
+            deallocate_(data_, cap_);
+        }
+        data_ = dst; cap_ = new_cap;
+    }
+
+    void steal_(IncrementalInlinedVector& other) noexcept {
+        if (other.old_ && other.is_inline_ptr_(other.old_)) other.finish_migration(); // At most N moves
+        if (!other.is_inline_ptr_(other.data_)) {
+            data_ = other.data_; cap_ = other.cap_; size_ = other.size_;
+            old_ = other.old_; old_cap_ = other.old_cap_; migrated_ = other.migrated_; old_end_ = other.old_end_;
+        } else {
+            for (size_type i = 0; i < other.size_; ++i) {
+                construct_at_(data_ + i, std::move(other.data_[i]));
+                other.destroy_at_(other.data_ + i);
+            }
+            size_ = other.size_;
+        }
+        other.data_ = other.inline_ptr_(); other.cap_ = N; other.size_ = 0;
+        other.old_ = nullptr; other.old_cap_ = 0; other.migrated_ = other.old_end_ = 0;
+    }
+
+    template<bool Const>
+    class basic_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const T&, T&>;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+
+        basic_iterator() noexcept = default;
+        template<bool C = Const, std::enable_if_t<C, int> = 0>
+        basic_iterator(const basic_iterator<false>& o) noexcept : owner_(o.owner_), i_(o.i_) {}
+
+        reference operator*() const noexcept { return *owner_->slot_(i_); }
+        pointer operator->() const noexcept { return owner_->slot_(i_); }
+        reference operator[](difference_type n) const noexcept { return *(*this + n); }
+        basic_iterator& operator++() noexcept { ++i_; return *this; }
+        basic_iterator operator++(int) noexcept { basic_iterator t = *this; ++i_; return t; }
+        basic_iterator& operator--() noexcept { --i_; return *this; }
+        basic_iterator operator--(int) noexcept { basic_iterator t = *this; --i_; return t; }
+        basic_iterator& operator+=(difference_type n) noexcept { i_ += n; return *this; }
+        basic_iterator& operator-=(difference_type n) noexcept { i_ -= n; return *this; }
+        friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept { return it += n; }
+        friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept { return it -= n; }
+        friend difference_type operator-(const basic_iterator& a, const basic_iterator& b) noexcept {
+            return static_cast<difference_type>(a.i_) - static_cast<difference_type>(b.i_);
+        }
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept { return a.i_ == b.i_; }
+        friend bool operator!=(const basic_iterator& a, const basic_iterator& b) noexcept { return a.i_ != b.i_; }
+        friend bool operator<(const basic_iterator& a, const basic_iterator& b) noexcept { return a.i_ < b.i_; }
+
+    private:
+        friend class IncrementalInlinedVector;
+        using Owner = std::conditional_t<Const, const IncrementalInlinedVector, IncrementalInlinedVector>;
+        basic_iterator(Owner* owner, size_type i) noexcept : owner_(owner), i_(i) {}
+        Owner* owner_ = nullptr;
+        size_type i_ = 0;
+    };
+
+public:
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    // ========================================================================
+    // Construction
+    // ========================================================================
+    explicit IncrementalInlinedVector(const Alloc& alloc = Alloc{}) noexcept : data_(inline_ptr_()), alloc_(alloc) {}
+    IncrementalInlinedVector(std::initializer_list<T> init, const Alloc& alloc = Alloc{}) : IncrementalInlinedVector(alloc) {
+        reserve(init.size());
+        for (const T& v : init) emplace_back(v);
+    }
+    IncrementalInlinedVector(const IncrementalInlinedVector& other)
+        : IncrementalInlinedVector(AllocTraits::select_on_container_copy_construction(other.alloc_)) {
+        reserve(other.size_);
+        for (const T& v : other) emplace_back(v);
+    }
+    IncrementalInlinedVector(IncrementalInlinedVector&& other) noexcept
+        : data_(inline_ptr_()), alloc_(std::move(other.alloc_)) { steal_(other); }
+
+    IncrementalInlinedVector& operator=(const IncrementalInlinedVector& other) {
+        if (this == &other) return *this;
+        clear();
+        reserve(other.size_);
+        for (const T& v : other) emplace_back(v);
+        return *this;
+    }
+    /** @brief Steals the buffers under POCMA or equal allocators; otherwise moves element-wise. */
+    IncrementalInlinedVector& operator=(IncrementalInlinedVector&& other) noexcept(
+        AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
+        if (this == &other) return *this;
+        if (AllocTraits::propagate_on_container_move_assignment::value || alloc_ == other.alloc_) {
+            destroy_all_();
+            deallocate_(data_, cap_);
+            data_ = inline_ptr_(); cap_ = N;
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) alloc_ = std::move(other.alloc_);
+            steal_(other);
+        } else {
+            clear();
+            reserve(other.size_);
+            for (T& v : other) emplace_back(std::move(v));
+            other.clear();
+        }
+        return *this;
+    }
+
+    ~IncrementalInlinedVector() {
+        destroy_all_();
+        deallocate_(data_, cap_);
+    }
+
+    allocator_type get_allocator() const noexcept { return alloc_; }
+
+    // ========================================================================
+    // Element Access
+    // ========================================================================
+    reference operator[](size_type i) noexcept { assert(i < size_); return *slot_(i); }
+    const_reference operator[](size_type i) const noexcept { assert(i < size_); return *slot_(i); }
+    reference at(size_type i) {
+        if (i >= size_) throw std::out_of_range("IncrementalInlinedVector::at: index out of range");
+        return *slot_(i);
+    }
+    const_reference at(size_type i) const {
+        if (i >= size_) throw std::out_of_range("IncrementalInlinedVector::at: index out of range");
+        return *slot_(i);
+    }
+    reference front() noexcept { return (*this)[0]; }
+    const_reference front() const noexcept { return (*this)[0]; }
+    reference back() noexcept { return (*this)[size_ - 1]; }
+    const_reference back() const noexcept { return (*this)[size_ - 1]; }
+
+    /** @brief Contiguous storage. Finishes any pending migration first, at O(remaining) cost. */
+    pointer data() noexcept { finish_migration(); return data_; }
+
+    iterator begin() noexcept { return iterator(this, 0); }
+    iterator end() noexcept { return iterator(this, size_); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, size_); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // ========================================================================
+    // Capacity
+    // ========================================================================
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] size_type size() const noexcept { return size_; }
+    [[nodiscard]] size_type capacity() const noexcept { return cap_; }
+    [[nodiscard]] static constexpr size_type inline_capacity() noexcept { return N; }
+    [[nodiscard]] bool is_inline() const noexcept { return is_inline_ptr_(data_); }
+    /** @brief True while some elements still live in the previous buffer. */
+    [[nodiscard]] bool is_migrating() const noexcept { return old_ != nullptr; }
+
+    /** @brief Moves every pending element now. A no-op when not migrating. */
+    void finish_migration() noexcept { migrate_(old_end_); }
+
+    /** @brief Ensures capacity for `n` elements. Finishes migration and reallocates when growing: O(size). */
+    void reserve(size_type n) {
+        if (n <= cap_) return;
+        finish_migration();
+        relocate_to_(AllocTraits::allocate(alloc_, n), n);
+    }
+
+    /** @brief Finishes migration, then returns inline if the elements fit, else trims the heap buffer. */
+    void shrink_to_fit() {
+        finish_migration();
+        if (is_inline()) return;
+        if (size_ <= N) relocate_to_(inline_ptr_(), N);
+        else if (size_ < cap_) relocate_to_(AllocTraits::allocate(alloc_, size_), size_);
+    }
+
+    /** @brief `sizeof(*this)` plus both heap buffers while migrating. */
+    [[nodiscard]] size_type memory_usage() const noexcept {
+        size_type bytes = sizeof(*this);
+        if (!is_inline()) bytes += cap_ * sizeof(T);
+        if (old_ && !is_inline_ptr_(old_)) bytes += old_cap_ * sizeof(T);
+        return bytes;
+    }
+
+    // ========================================================================
+    // Modifiers
+    // ========================================================================
+    /**
+     * @brief Appends an element, then migrates up to `Step` pending elements.
+     * Moves at most `Step` old elements per call. Strong guarantee.
+     */
+    template<class... Args>
+    reference emplace_back(Args&&... args) {
+        if (size_ == cap_) {
+            finish_migration(); // A no-op: Step >= 1 drains the old buffer before the new one fills
+            const size_type new_cap = cap_ * 2;
+            pointer nb = AllocTraits::allocate(alloc_, new_cap);
+            try { construct_at_(nb + size_, std::forward<Args>(args)...); }
+            catch (...) { AllocTraits::deallocate(alloc_, nb, new_cap); throw; }
+            old_ = data_; old_cap_ = cap_; migrated_ = 0; old_end_ = size_;
+            data_ = nb; cap_ = new_cap;
+        } else {
+            construct_at_(data_ + size_, std::forward<Args>(args)...);
+        }
+        ++size_;
+        migrate_(Step);
+        return *slot_(size_ - 1);
+    }
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back() noexcept {
+        assert(size_ > 0);
+        destroy_at_(slot_(--size_));
+        if (old_end_ > size_) {
+            old_end_ = std::max(size_, migrated_);
+            migrate_(0); // Frees the old buffer if nothing remains in it
+        }
+    }
+
+    /** @brief Destroys all elements. Keeps the current buffer and frees the old one. */
+    void clear() noexcept { destroy_all_(); }
+
+    friend bool operator==(const IncrementalInlinedVector& lhs, const IncrementalInlinedVector& rhs) {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+    friend bool operator!=(const IncrementalInlinedVector& lhs, const IncrementalInlinedVector& rhs) { return !(lhs == rhs); }
+};
+
+// ============================================================================
+// CowInlinedVector: spilled storage shared between copies until one writes
+// ============================================================================
+
+/**
+ * @brief An inlined vector whose heap block is reference-counted and shared by
+ * copies until one of them writes.
+ *
+ * Copying a spilled `InlinedVector` copies every element. Copying a spilled
+ * `CowInlinedVector` takes a reference to the source's heap block: O(1) at any
+ * size. Before any mutating call (`push_back`, `insert`, `erase`, `resize`...)
+ * or non-const accessor (`data()`, `operator[]`, `begin()`...), a vector that
+ * shares its block copies the elements into a block of its own. Const access
+ * never separates. Read through a const reference (or `std::as_const`) to keep
+ * sharing. Inline contents are always copied by value.
+ *
+ * A non-const accessor hands out a reference the vector cannot track, so it also
+ * marks the block, unshared by then, as unshareable. Later copies then deep-copy
+ * until growth, `shrink_to_fit`, `clear` or assignment replaces or empties the
+ * block. The reference count is atomic, so copies of one snapshot can be read,
+ * copied and destroyed on different threads. Each vector still needs external
+ * synchronization. Blocks are shared only when the copy's allocator compares
+ * equal to the source's.
+ *
+ * @tparam T Element type. Must be copy-constructible; `insert` and `erase` also
+ * need move assignment.
+ * @tparam N Inline capacity.
+ * @tparam Alloc Allocator.
+ */
+template<typename T, std::size_t N, typename Alloc = std::allocator<T>>
+class CowInlinedVector {
+public:
+    // --- Member Types ---
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = pointer;
+    using const_iterator = const_pointer;
+
+    static_assert(N > 0, "CowInlinedVector requires a non-zero inline capacity");
+    static_assert(std::is_same_v<typename Alloc::value_type, T>, "Allocator::value_type must be T");
+    static_assert(std::is_copy_constructible_v<T>, "CowInlinedVector requires T to be copy-constructible");
+
+private:
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    /** @brief Heap block header. `cap` elements follow it; the owners track the size. */
+    struct Rep {
+        std::atomic<size_type> refs;
+        size_type cap;
+        bool shareable; // False once a mutable reference escaped the sole owner
+    };
+    static constexpr std::size_t kUnit = alignof(T) > alignof(Rep) ? alignof(T) : alignof(Rep);
+    struct alignas(kUnit) Unit { std::byte b[kUnit]; };
+    static constexpr size_type kHeaderUnits = (sizeof(Rep) + kUnit - 1) / kUnit;
+    using UnitAlloc = typename AllocTraits::template rebind_alloc<Unit>;
+    using UnitTraits = std::allocator_traits<UnitAlloc>;
+
+    alignas(T) std::byte inline_[sizeof(T) * N];
+    Rep* rep_ = nullptr; // Heap block, possibly shared; nullptr while inline
+    size_type size_ = 0;
+    LLOYAL_NO_UNIQUE_ADDRESS allocator_type alloc_;
+
+    pointer inline_ptr_() const noexcept { return std::launder(reinterpret_cast<pointer>(const_cast<std::byte*>(inline_))); }
+    static pointer elems_(Rep* r) noexcept { return reinterpret_cast<pointer>(reinterpret_cast<Unit*>(r) + kHeaderUnits); }
+    static size_type units_for_(size_type cap) noexcept { return kHeaderUnits + (cap * sizeof(T) + kUnit - 1) / kUnit; }
+    pointer data_ptr_() const noexcept { return rep_ ? elems_(rep_) : inline_ptr_(); }
+    bool shared_() const noexcept { return rep_ && rep_->refs.load(std::memory_order_acquire) != 1; }
+
+    template<class... Args>
+    pointer construct_at_(pointer p, Args&&... args) {
+        AllocTraits::construct(alloc_, p, std::forward<Args>(args)...);
+        return p;
+    }
+    void destroy_n_(pointer p, size_type n) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_type i = 0; i < n; ++i) AllocTraits::destroy(alloc_, p + i);
+        }
+    }
+
+    Rep* allocate_rep_(size_type cap) {
+        UnitAlloc ua(alloc_);
+        Unit* u = UnitTraits::allocate(ua, units_for_(cap));
+        return ::new (static_cast<void*>(u)) Rep{{1}, cap, true};
+    }
+    void deallocate_rep_(Rep* r) noexcept {
+        const size_type units = units_for_(r->cap);
+        r->~Rep();
+        UnitAlloc ua(alloc_);
+        UnitTraits::deallocate(ua, reinterpret_cast<Unit*>(r), units);
+    }
+    /** @brief Drops one reference to `r`; the last owner destroys its `n` elements. */
+    void release_rep_(Rep* r, size_type n) noexcept {
+        // A count of 1 means no other vector can reach the block, so no RMW is needed
+        if (r->refs.load(std::memory_order_acquire) == 1 || r->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            destroy_n_(elems_(r), n);
+            deallocate_rep_(r);
+        }
+    }
+    /** @brief Destroys or releases the contents and returns to the empty inline state. */
+    void reset_() noexcept {
+        if (rep_) release_rep_(rep_, size_);
+        else destroy_n_(inline_ptr_(), size_);
+        rep_ = nullptr; size_ = 0;
+    }
+
+    /** @brief Copies (block shared) or moves (block owned) every element to `dst`. Strong guarantee. */
+    void transfer_to_(pointer dst) {
+        pointer src = data_ptr_();
+        const bool copy = shared_();
+        size_type i = 0;
+        try {
+            for (; i < size_; ++i) {
+                if (copy) construct_at_(dst + i, std::as_const(src[i]));
+                else construct_at_(dst + i, std::move_if_noexcept(src[i]));
+            }
+        } catch (...) { destroy_n_(dst, i); throw; }
+    }
+
+    /**
+     * @brief Moves the contents into a fresh, unshared block of `new_cap`, after
+     * `place` has constructed `placed` new elements at index `size()`. The old
+     * elements are untouched until then, so `place` may read them. Strong guarantee.
+     */
+    template<class Place>
+    void rebuild_(size_type new_cap, size_type placed, Place&& place) {
+        Rep* fresh = allocate_rep_(new_cap);
+        pointer dst = elems_(fresh);
+        try { place(dst + size_); }
+        catch (...) { deallocate_rep_(fresh); throw; }
+        try { transfer_to_(dst); }
+        catch (...) { destroy_n_(dst + size_, placed); deallocate_rep_(fresh); throw; }
+        const size_type n = size_;
+        reset_();
+        rep_ = fresh; size_ = n + placed;
+    }
+
+    /** @brief Gives this vector sole ownership of its block, copying the elements if shared. */
+    void unshare_() {
+        if (shared_()) rebuild_(rep_->cap, 0, [](pointer) {});
+    }
+    /** @brief Unshares and marks the block unshareable: a mutable reference is about to escape. */
+    pointer leak_() {
+        unshare_();
+        if (rep_) rep_->shareable = false;
+        return data_ptr_();
+    }
+
+    size_type grown_capacity_() const noexcept { return std::max<size_type>(N * 2, size_ * 2); }
+
+    /** @brief Copies `[src, src + n)` into this empty vector. Strong guarantee. */
+    void assign_copy_(const_pointer src, size_type n) {
+        if (n == 0) return;
+        Rep* fresh = n > N ? allocate_rep_(n) : nullptr;
+        pointer dst = fresh ? elems_(fresh) : inline_ptr_();
+        size_type i = 0;
+        try {
+            for (; i < n; ++i) construct_at_(dst + i, src[i]);
+        } catch (...) {
+            destroy_n_(dst, i);
+            if (fresh) deallocate_rep_(fresh);
+            throw;
+        }
+        rep_ = fresh; size_ = n;
+    }
+    /** @brief Takes a reference to `other`'s block if it may be shared with this allocator. */
+    bool try_share_(const CowInlinedVector& other) noexcept {
+        if (!other.rep_ || !other.rep_->shareable || !(alloc_ == other.alloc_)) return false;
+        other.rep_->refs.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void steal_(CowInlinedVector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (other.rep_) {
+            rep_ = other.rep_; size_ = other.size_;
+            other.rep_ = nullptr; other.size_ = 0;
+            return;
+        }
+        pointer src = other.inline_ptr_(), dst = inline_ptr_();
+        if constexpr (std::is_nothrow_move_constructible_v<T>) {
+            for (size_type i = 0; i < other.size_; ++i) construct_at_(dst + i, std::move(src[i]));
+        } else {
+            size_type i = 0;
+            try {
+                for (; i < other.size_; ++i) construct_at_(dst + i, std::move(src[i]));
+            } catch (...) { destroy_n_(dst, i); throw; }
+        }
+        size_ = other.size_;
+        other.reset_();
+    }
+
+public:
+    // ========================================================================
+    // Construction
+    // ========================================================================
+    explicit CowInlinedVector(const Alloc& alloc = Alloc{}) noexcept : alloc_(alloc) {}
+    CowInlinedVector(std::initializer_list<T> init, const Alloc& alloc = Alloc{}) : alloc_(alloc) {
+        assign_copy_(init.begin(), init.size());
+    }
+    /** @brief O(1) when `other` is spilled and shareable; otherwise copies the elements. */
+    CowInlinedVector(const CowInlinedVector& other)
+        : alloc_(AllocTraits::select_on_container_copy_construction(other.alloc_)) {
+        if (try_share_(other)) { rep_ = other.rep_; size_ = other.size_; }
+        else assign_copy_(other.data(), other.size_);
+    }
+    CowInlinedVector(CowInlinedVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : alloc_(std::move(other.alloc_)) { steal_(other); }
+
+    /** @brief Shares `other`'s block when possible; otherwise copies. Keeps this allocator. */
+    CowInlinedVector& operator=(const CowInlinedVector& other) {
+        if (this == &other) return *this;
+        if (try_share_(other)) { // Counted before the release, so a common block survives
+            reset_();
+            rep_ = other.rep_; size_ = other.size_;
+        } else {
+            CowInlinedVector tmp(other.data(), other.size_, alloc_);
+            reset_();
+            steal_(tmp);
+        }
+        return *this;
+    }
+    /** @brief Steals the block under POCMA or equal allocators; otherwise copies. */
+    CowInlinedVector& operator=(CowInlinedVector&& other) noexcept(
+        (AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) &&
+        std::is_nothrow_move_constructible_v<T>) {
+        if (this == &other) return *this;
+        if (AllocTraits::propagate_on_container_move_assignment::value || alloc_ == other.alloc_) {
+            reset_();
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) alloc_ = std::move(other.alloc_);
+            steal_(other);
+        } else {
+            *this = std::as_const(other);
+            other.reset_();
+        }
+        return *this;
+    }
+
+    ~CowInlinedVector() { reset_(); }
+
+    allocator_type get_allocator() const noexcept { return alloc_; }
+
+    // ========================================================================
+    // Element Access
+    // Non-const access unshares first and pins the block (see the class notes).
+    // ========================================================================
+    reference operator[](size_type i) { assert(i < size_); return leak_()[i]; }
+    const_reference operator[](size_type i) const noexcept { assert(i < size_); return data_ptr_()[i]; }
+    reference at(size_type i) {
+        if (i >= size_) throw std::out_of_range("CowInlinedVector::at: index out of range");
+        return leak_()[i];
+    }
+    const_reference at(size_type i) const {
+        if (i >= size_) throw std::out_of_range("CowInlinedVector::at: index out of range");
+        return data_ptr_()[i];
+    }
+    reference front() { return (*this)[0]; }
+    const_reference front() const noexcept { return (*this)[0]; }
+    reference back() { return (*this)[size_ - 1]; }
+    const_reference back() const noexcept { return (*this)[size_ - 1]; }
+
+    pointer data() { return leak_(); }
+    const_pointer data() const noexcept { return data_ptr_(); }
+
+    iterator begin() { return leak_(); }
+    iterator end() { return leak_() + size_; }
+    const_iterator begin() const noexcept { return data_ptr_(); }
+    const_iterator end() const noexcept { return data_ptr_() + size_; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // ========================================================================
+    // Capacity
+    // ========================================================================
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] size_type size() const noexcept { return size_; }
+    [[nodiscard]] size_type capacity() const noexcept { return rep_ ? rep_->cap : N; }
+    [[nodiscard]] static constexpr size_type inline_capacity() noexcept { return N; }
+    [[nodiscard]] bool is_inline() const noexcept { return rep_ == nullptr; }
+    /** @brief True while another vector references the same heap block. */
+    [[nodiscard]] bool is_shared() const noexcept { return shared_(); }
+
+    /** @brief Ensures capacity for `n` elements; a shared block is copied into the new one. */
+    void reserve(size_type n) {
+        if (n > capacity()) rebuild_(n, 0, [](pointer) {});
+    }
+
+    /** @brief Returns inline if the elements fit, else trims an unshared block. A shared block is left alone. */
+    void shrink_to_fit() {
+        if (!rep_ || shared_()) return;
+        if (size_ <= N) {
+            transfer_to_(inline_ptr_());
+            const size_type n = size_;
+            release_rep_(rep_, n);
+            rep_ = nullptr; size_ = n;
+        } else if (size_ < rep_->cap) {
+            rebuild_(size_, 0, [](pointer) {});
+        }
+    }
+
+    /** @brief `sizeof(*this)` plus the whole heap block, even when it is shared. */
+    [[nodiscard]] size_type memory_usage() const noexcept {
+        return sizeof(*this) + (rep_ ? units_for_(rep_->cap) * kUnit : 0);
+    }
+
+    // ========================================================================
+    // Modifiers
+    // ========================================================================
+    template<class... Args>
+    reference emplace_back(Args&&... args) {
+        emplace_back_(std::forward<Args>(args)...);
+        return back();
+    }
+    void push_back(const T& value) { emplace_back_(value); }
+    void push_back(T&& value) { emplace_back_(std::move(value)); }
+
+    void pop_back() {
+        assert(size_ > 0);
+        unshare_();
+        destroy_n_(data_ptr_() + size_ - 1, 1);
+        --size_;
+    }
+
+    template<class... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        const size_type idx = static_cast<size_type>(pos - cbegin());
+        emplace_back_(std::forward<Args>(args)...);
+        pointer d = leak_();
+        std::rotate(d + idx, d + size_ - 1, d + size_);
+        return d + idx;
+    }
+    iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+    iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        const size_type idx = static_cast<size_type>(first - cbegin());
+        const size_type count = static_cast<size_type>(last - first);
+        pointer d = leak_();
+        if (count) {
+            std::move(d + idx + count, d + size_, d + idx);
+            destroy_n_(d + size_ - count, count);
+            size_ -= count;
+        }
+        return d + idx;
+    }
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    /** @brief Destroys all elements. Releases a shared block; an owned one is kept for reuse. */
+    void clear() noexcept {
+        if (!rep_ || shared_()) { reset_(); return; }
+        destroy_n_(elems_(rep_), size_);
+        size_ = 0;
+        rep_->shareable = true; // Every earlier reference is now dangling anyway
+    }
+
+    void resize(size_type count) { resize_(count, [this](pointer p) { construct_at_(p); }); }
+    void resize(size_type count, const T& value) {
+        const T copy(value); // value may be an element that the reserve moves
+        resize_(count, [&](pointer p) { construct_at_(p, copy); });
+    }
+
+    friend bool operator==(const CowInlinedVector& lhs, const CowInlinedVector& rhs) {
+        return lhs.size() == rhs.size() && (lhs.data() == rhs.data() || std::equal(lhs.begin(), lhs.end(), rhs.begin()));
+    }
+    friend bool operator!=(const CowInlinedVector& lhs, const CowInlinedVector& rhs) { return !(lhs == rhs); }
+
+private:
+    CowInlinedVector(const_pointer src, size_type n, const Alloc& alloc) : alloc_(alloc) { assign_copy_(src, n); }
+
+    template<class... Args>
+    void emplace_back_(Args&&... args) {
+        if (size_ < capacity() && !shared_()) {
+            construct_at_(data_ptr_() + size_, std::forward<Args>(args)...);
+            ++size_;
+            return;
+        }
+        // Full or shared: construct the new element first, since args may alias an old one
+        const size_type new_cap = size_ < capacity() ? capacity() : grown_capacity_();
+        rebuild_(new_cap, 1, [&](pointer p) { construct_at_(p, std::forward<Args>(args)...); });
+    }
+
+    template<class Make>
+    void resize_(size_type count, Make&& make) {
+        if (count <= size_) {
+            if (count == size_) return;
+            unshare_();
+            destroy_n_(data_ptr_() + count, size_ - count);
+            size_ = count;
+            return;
+        }
+        if (count > capacity() || shared_()) rebuild_(std::max(count, capacity()), 0, [](pointer) {});
+        pointer d = data_ptr_();
+        for (; size_ < count; ++size_) make(d + size_);
+    }
+};
+
+// ============================================================================
+// AtomicInlinedVectorSnapshot: RCU-style publication of immutable snapshots
+// ============================================================================
+
+namespace detail {
+/**
+ * @brief One reader thread's announcement: the epoch it entered its read-side
+ * section in, or 0 while quiescent. Records are claimed by threads, returned at
+ * thread exit and recycled, and never freed, so writers can scan them lock-free.
+ */
+struct alignas(spsc_cache_line) rcu_reader_record {
+    std::atomic<std::uint64_t> active{0};
+    std::atomic<bool> in_use{true};
+    unsigned depth = 0;                      // Nesting; touched only by the owning thread
+    rcu_reader_record* next = nullptr;       // Immutable once published
+};
+
+/** @brief The process-wide epoch domain shared by every `AtomicInlinedVectorSnapshot`. */
+struct rcu_domain {
+    static inline std::atomic<std::uint64_t> epoch{1};
+    static inline std::atomic<rcu_reader_record*> readers{nullptr};
+
+    /** @brief Claims a record for the calling thread and returns it at thread exit. */
+    struct thread_handle {
+        rcu_reader_record* rec;
+        thread_handle() : rec(claim_()) {}
+        ~thread_handle() { rec->active.store(0, std::memory_order_release); rec->in_use.store(false, std::memory_order_release); }
+
+        static rcu_reader_record* claim_() {
+            for (rcu_reader_record* r = readers.load(std::memory_order_acquire); r; r = r->next) {
+                bool free = false;
+                if (!r->in_use.load(std::memory_order_relaxed) &&
+                    r->in_use.compare_exchange_strong(free, true, std::memory_order_acquire)) return r;
+            }
+            auto* r = new rcu_reader_record;
+            r->next = readers.load(std::memory_order_relaxed);
+            while (!readers.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) {}
+            return r;
+        }
+    };
+
+    static rcu_reader_record& local() {
+        static thread_local thread_handle handle;
+        return *handle.rec;
+    }
+
+    /** @brief Enters a read-side section: one store to the thread's own cache line. Wait-free. */
+    static rcu_reader_record& enter() {
+        rcu_reader_record& r = local();
+        if (r.depth++ == 0) r.active.store(epoch.load(std::memory_order_acquire), std::memory_order_seq_cst);
+        return r;
+    }
+    static void leave(rcu_reader_record& r) noexcept {
+        if (--r.depth == 0) r.active.store(0, std::memory_order_release);
+    }
+
+    /**
+     * @brief Oldest epoch a reader is still inside, or UINT64_MAX if none. Memory
+     * retired at epoch `e` is unreachable once this is at least `e`.
+     */
+    static std::uint64_t oldest_active() noexcept {
+        std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+        for (rcu_reader_record* r = readers.load(std::memory_order_acquire); r; r = r->next) {
+            const std::uint64_t e = r->active.load(std::memory_order_seq_cst);
+            if (e != 0 && e < oldest) oldest = e;
+        }
+        return oldest;
+    }
+};
+} // namespace detail
+
+/**
+ * @brief A read-mostly `InlinedVector` published as immutable snapshots through
+ * an atomic pointer, with epoch-based reclamation (RCU).
+ *
+ * Readers call `read()`, which announces the global epoch in the calling
+ * thread's own record and loads the current snapshot pointer. The guard it
+ * returns keeps that snapshot alive. Reads take no lock, never retry and write
+ * no shared cache line, so they scale with the number of reader threads. A
+ * `shared_mutex` makes every reader bump the same counter. Guards may nest.
+ *
+ * Writers never modify a published snapshot. `update(f)` copies the current one,
+ * applies `f`, and swaps the copy in; `publish(v)` swaps in a ready value. Both
+ * are serialized by a writer mutex. The replaced snapshot is retired with the
+ * bumped epoch and freed once no reader remains in an older epoch. Each write
+ * frees what it can; `synchronize()` waits until everything retired is freed.
+ * A reader that holds a guard for long only delays reclamation, never a write.
+ *
+ * Reader records are per thread and recycled at thread exit. All snapshots share
+ * one epoch domain. Destroying the object requires that no reader holds one of
+ * its guards.
+ *
+ * @tparam T Element type. Must be copy-constructible for `update`.
+ * @tparam N Inline capacity of each snapshot.
+ * @tparam Alloc Allocator for the snapshots and their elements.
+ */
+template<typename T, std::size_t N, typename Alloc = std::allocator<T>>
+class AtomicInlinedVectorSnapshot {
+public:
+    using vector_type = InlinedVector<T, N, Alloc>;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+
+private:
+    struct Node {
+        vector_type value;
+        std::uint64_t retired_at = 0;
+        Node* next_retired = nullptr;
+        template<class... Args> explicit Node(Args&&... args) : value(std::forward<Args>(args)...) {}
+    };
+    using NodeAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+    using NodeTraits = std::allocator_traits<NodeAlloc>;
+
+    std::atomic<Node*> current_;
+    LLOYAL_NO_UNIQUE_ADDRESS NodeAlloc node_alloc_;
+    mutable std::mutex writer_;      // Serializes publication and guards the retired list
+    Node* retired_ = nullptr;        // Newest first
+    size_type retired_count_ = 0;
+
+    template<class... Args>
+    Node* make_node_(Args&&... args) {
+        Node* n = NodeTraits::allocate(node_alloc_, 1);
+        try { NodeTraits::construct(node_alloc_, n, std::forward<Args>(args)...); }
+        catch (...) { NodeTraits::deallocate(node_alloc_, n, 1); throw; }
+        return n;
+    }
+    void free_node_(Node* n) noexcept {
+        NodeTraits::destroy(node_alloc_, n);
+        NodeTraits::deallocate(node_alloc_, n, 1);
+    }
+
+    /** @brief Swaps `fresh` in and retires the old snapshot. Requires `writer_`. */
+    void install_(Node* fresh) noexcept {
+        Node* old = current_.exchange(fresh, std::memory_order_seq_cst);
+        // Readers that can still see `old` announced an epoch older than this one
+        old->retired_at = detail::rcu_domain::epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+        old->next_retired = retired_;
+        retired_ = old; ++retired_count_;
+        reclaim_();
+    }
+    /** @brief Frees every retired snapshot no reader can reach. Requires `writer_`. */
+    void reclaim_() noexcept {
+        if (!retired_) return;
+        const std::uint64_t oldest = detail::rcu_domain::oldest_active();
+        Node** link = &retired_;
+        while (Node* n = *link) {
+            if (n->retired_at <= oldest) { *link = n->next_retired; free_node_(n); --retired_count_; }
+            else link = &n->next_retired;
+        }
+    }
+
+public:
+    /** @brief Keeps one snapshot alive for the duration of a read-side section. */
+    class read_guard {
+    public:
+        read_guard(const read_guard&) = delete;
+        read_guard& operator=(const read_guard&) = delete;
+        ~read_guard() { detail::rcu_domain::leave(rec_); }
+
+        const vector_type& operator*() const noexcept { return *vec_; }
+        const vector_type* operator->() const noexcept { return vec_; }
+        const vector_type& get() const noexcept { return *vec_; }
+
+    private:
+        friend class AtomicInlinedVectorSnapshot;
+        read_guard(detail::rcu_reader_record& rec, const vector_type* vec) noexcept : rec_(rec), vec_(vec) {}
+        detail::rcu_reader_record& rec_;
+        const vector_type* vec_;
+    };
+
+    explicit AtomicInlinedVectorSnapshot(const Alloc& alloc = Alloc{})
+        : current_(nullptr), node_alloc_(alloc) { current_.store(make_node_(alloc), std::memory_order_release); }
+    explicit AtomicInlinedVectorSnapshot(vector_type initial)
+        : current_(nullptr), node_alloc_(initial.get_allocator()) {
+        current_.store(make_node_(std::move(initial)), std::memory_order_release);
+    }
+    AtomicInlinedVectorSnapshot(const AtomicInlinedVectorSnapshot&) = delete;
+    AtomicInlinedVectorSnapshot& operator=(const AtomicInlinedVectorSnapshot&) = delete;
+
+    /** @brief Frees the current and all retired snapshots. No reader may hold a guard. */
+    ~AtomicInlinedVectorSnapshot() {
+        while (Node* n = retired_) { retired_ = n->next_retired; free_node_(n); }
+        free_node_(current_.load(std::memory_order_relaxed));
+    }
+
+    /** @brief Pins the current snapshot. Wait-free; the guard must stay on this thread. */
+    [[nodiscard]] read_guard read() const {
+        detail::rcu_reader_record& rec = detail::rcu_domain::enter();
+        return read_guard(rec, &current_.load(std::memory_order_seq_cst)->value);
+    }
+
+    /** @brief Calls `f(const vector_type&)` on the current snapshot and returns its result. */
+    template<class F>
+    decltype(auto) read(F&& f) const {
+        read_guard g = read();
+        return std::forward<F>(f)(*g);
+    }
+
+    /** @brief Replaces the snapshot with `next`. */
+    void publish(vector_type next) {
+        Node* fresh = make_node_(std::move(next));
+        std::lock_guard<std::mutex> lock(writer_);
+        install_(fresh);
+    }
+
+    /**
+     * @brief Copies the current snapshot, applies `f(vector_type&)` to the copy and
+     * publishes it. Concurrent updates are serialized, so none is lost. If `f`
+     * throws, nothing is published.
+     */
+    template<class F>
+    void update(F&& f) {
+        std::lock_guard<std::mutex> lock(writer_);
+        Node* fresh = make_node_(current_.load(std::memory_order_relaxed)->value);
+        try { std::forward<F>(f)(fresh->value); }
+        catch (...) { free_node_(fresh); throw; }
+        install_(fresh);
+    }
+
+    /** @brief Blocks until every retired snapshot is freed. Must not be called inside a read section. */
+    void synchronize() {
+        std::unique_lock<std::mutex> lock(writer_);
+        while (retired_) {
+            reclaim_();
+            if (!retired_) break;
+            lock.unlock();
+            std::this_thread::yield();
+            lock.lock();
+        }
+    }
+
+    /** @brief Retired snapshots still waiting for readers to leave. */
+    [[nodiscard]] size_type retired_count() const {
+        std::lock_guard<std::mutex> lock(writer_);
+        return retired_count_;
+    }
+};
+
+// ============================================================================
+// CompressedInlinedVector: bit-packed or delta-varint integers, inline
+// ============================================================================
+
+/** @brief Inline encoding used by `CompressedInlinedVector`. */
+enum class compression : unsigned char {
+    packed,       ///< Fixed bit width, widened on demand. O(1) random access.
+    sorted_delta  ///< Non-decreasing values as LEB128 varint deltas. Sequential access.
+};
+
+namespace detail {
+/** @brief Number of bits needed to represent `v` (0 for 0). */
+inline unsigned bit_width_u64(std::uint64_t v) noexcept {
+#if defined(__cpp_lib_bitops) && __cpp_lib_bitops >= 201907L
+    return static_cast<unsigned>(std::bit_width(v));
+#else
+    unsigned w = 0;
+    while (v) { ++w; v >>= 1; }
+    return w;
+#endif
+}
+} // namespace detail
+
+/**
+ * @brief An append-oriented sequence of `uint32_t`/`uint64_t` that keeps values
+ * compressed inside a `Bytes`-byte inline buffer, and spills to a plain
+ * `std::vector<T>` when they no longer fit.
+ *
+ * In `compression::packed` mode every value uses the same bit width: the width
+ * of the largest value so far. A wider value repacks the buffer in place. In
+ * `compression::sorted_delta` mode values must be non-decreasing and are stored
+ * as varint deltas (posting lists, adjacency rows). A decreasing value spills.
+ * Small IDs therefore stay inline 2-4x longer than in
+ * `InlinedVector<T, Bytes / sizeof(T)>`.
+ *
+ * Elements are values, not objects: `operator[]`, `front()`, `back()` and the
+ * iterators return `T` by value. Random access is O(1) except in
+ * `sorted_delta` mode (O(i)); iterate or `unpack()` instead.
+ *
+ * @tparam T `std::uint32_t` or `std::uint64_t`.
+ * @tparam Bytes Inline payload size; a positive multiple of 8.
+ */
+template<typename T, std::size_t Bytes>
+class CompressedInlinedVector {
+public:
+    static_assert(std::is_same_v<T, std::uint32_t> || std::is_same_v<T, std::uint64_t>,
+                  "CompressedInlinedVector supports uint32_t and uint64_t");
+    static_assert(Bytes >= 8 && Bytes % 8 == 0, "CompressedInlinedVector requires Bytes to be a positive multiple of 8");
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    /** @brief Size of the inline payload in bytes. */
+    static constexpr size_type inline_bytes = Bytes;
+
+private:
+    static constexpr size_type kWords = Bytes / 8;
+    static constexpr size_type kBits = Bytes * 8;
+
+    struct InlineRep {
+        std::uint64_t words[kWords] = {};
+        size_type size = 0;
+        std::uint32_t nbytes = 0;  // sorted_delta: bytes used
+        unsigned char width = 1;   // packed: bits per value
+        T last = 0;                // sorted_delta: last value, base for the next delta
+
+        unsigned char* bytes() noexcept { return reinterpret_cast<unsigned char*>(words); }
+        const unsigned char* bytes() const noexcept { return reinterpret_cast<const unsigned char*>(words); }
+    };
+    using HeapVec = std::vector<T>;
+
+    std::variant<InlineRep, HeapVec> storage_;
+    compression mode_;
+
+    static std::uint64_t mask_(unsigned width) noexcept {
+        return width == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << width) - 1;
+    }
+
+    /** @brief Reads value `i` of width `width`; may span two words. */
+    static T extract_(const std::uint64_t* w, size_type i, unsigned width) noexcept {
+        const size_type bit = i * width;
+        const size_type k = bit / 64;
+        const unsigned s = static_cast<unsigned>(bit % 64);
+        std::uint64_t v = w[k] >> s;
+        if (s + width > 64) v |= w[k + 1] << (64 - s);
+        return static_cast<T>(v & mask_(width));
+    }
+
+    static void deposit_(std::uint64_t* w, size_type i, unsigned width, std::uint64_t v) noexcept {
+        const size_type bit = i * width;
+        const size_type k = bit / 64;
+        const unsigned s = static_cast<unsigned>(bit % 64);
+        const std::uint64_t m = mask_(width);
+        w[k] = (w[k] & ~(m << s)) | (v << s);
+        if (s + width > 64) {
+            const unsigned hi = 64 - s;
+            w[k + 1] = (w[k + 1] & ~(m >> hi)) | (v >> hi);
+        }
+    }
+
+    /** @brief Decodes one LEB128 varint at `pos`, advancing it. */
+    static std::uint64_t read_varint_(const unsigned char* b, size_type& pos) noexcept {
+        std::uint64_t v = 0;
+        for (unsigned shift = 0;; shift += 7) {
+            const unsigned char byte = b[pos++];
+            v |= std::uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return v;
+        }
+    }
+
+    /** @brief Unpacks a width that divides 64: whole words, then the partial tail word. */
+    template<unsigned W>
+    static void unpack_aligned_(const InlineRep& r, T* out) noexcept {
+        constexpr unsigned kPerWord = 64 / W;
+        const std::uint64_t m = mask_(W);
+        const size_type full = r.size / kPerWord;
+        for (size_type k = 0; k < full; ++k, out += kPerWord) {
+            const std::uint64_t w = r.words[k];
+            for (unsigned j = 0; j < kPerWord; ++j) out[j] = static_cast<T>((w >> (j * W % 64)) & m);
+        }
+        const std::uint64_t w = full < kWords ? r.words[full] : 0;
+        for (size_type j = 0; j < r.size % kPerWord; ++j) out[j] = static_cast<T>((w >> (j * W % 64)) & m);
+    }
+
+    /** @brief Widens every stored value to `width` bits, back to front so nothing is overwritten early. */
+    static void widen_(InlineRep& r, unsigned width) noexcept {
+        for (size_type i = r.size; i-- > 0;) deposit_(r.words, i, width, extract_(r.words, i, r.width));
+        r.width = static_cast<unsigned char>(width);
+    }
+
+    /** @brief Tries to append inline. Returns false if `v` does not fit. */
+    bool push_inline_(InlineRep& r, T v) noexcept {
+        if (mode_ == compression::packed) {
+            const unsigned need = std::max(1u, detail::bit_width_u64(v));
+            const unsigned width = std::max<unsigned>(need, r.width);
+            if ((r.size + 1) * width > kBits) return false;
+            if (width > r.width) widen_(r, width);
+            deposit_(r.words, r.size, width, v);
+        } else {
+            if (r.size > 0 && v < r.last) return false;
+            std::uint64_t delta = v - r.last;
+            const unsigned len = std::max(1u, (detail::bit_width_u64(delta) + 6) / 7);
+            if (r.nbytes + len > Bytes) return false;
+            unsigned char* b = r.bytes();
+            while (delta >= 0x80) { b[r.nbytes++] = static_cast<unsigned char>(delta | 0x80); delta >>= 7; }
+            b[r.nbytes++] = static_cast<unsigned char>(delta);
+            r.last = v;
+        }
+        ++r.size;
+        return true;
+    }
+
+    /** @brief Moves to the heap layout with room for `extra` more values. */
+    void spill_(size_type extra) {
+        HeapVec vec;
+        vec.reserve(std::max(size() + extra, 2 * size()));
+        vec.resize(size());
+        unpack(vec.data());
+        storage_ = std::move(vec);
+    }
+
+public:
+    // ========================================================================
+    // Iterator (decodes on the fly)
+    // ========================================================================
+
+    /** @brief Forward iterator yielding values. */
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = T;
+
+        const_iterator() noexcept = default;
+
+        T operator*() const noexcept {
+            if (heap_) return heap_[i_];
+            if (delta_) return cur_;
+            return extract_(words_, i_, width_);
+        }
+        const_iterator& operator++() noexcept {
+            ++i_;
+            if (delta_ && i_ < n_) cur_ += static_cast<T>(read_varint_(bytes_, pos_));
+            return *this;
+        }
+        const_iterator operator++(int) noexcept { const_iterator tmp = *this; ++*this; return tmp; }
+        friend bool operator==(const const_iterator& a, const const_iterator& b) noexcept { return a.i_ == b.i_; }
+        friend bool operator!=(const const_iterator& a, const const_iterator& b) noexcept { return a.i_ != b.i_; }
+
+    private:
+        friend class CompressedInlinedVector;
+        const_iterator(const CompressedInlinedVector& c, size_type i) noexcept : i_(i), n_(c.size()) {
+            if (const auto* vec = std::get_if<HeapVec>(&c.storage_)) { heap_ = vec->data(); return; }
+            const auto& r = std::get<InlineRep>(c.storage_);
+            words_ = r.words; bytes_ = r.bytes(); width_ = r.width;
+            delta_ = c.mode_ == compression::sorted_delta;
+            if (delta_ && i_ < n_) cur_ = static_cast<T>(read_varint_(bytes_, pos_));
+        }
+
+        const T* heap_ = nullptr;
+        const std::uint64_t* words_ = nullptr;
+        const unsigned char* bytes_ = nullptr;
+        size_type i_ = 0, n_ = 0, pos_ = 0;
+        T cur_ = 0;
+        unsigned width_ = 1;
+        bool delta_ = false;
+    };
+    using iterator = const_iterator;
+
+    // ========================================================================
+    // Construction
+    // ========================================================================
+
+    /** @brief Constructs an empty vector using the given inline encoding. */
+    explicit CompressedInlinedVector(compression mode = compression::packed) noexcept : mode_(mode) {}
+
+    CompressedInlinedVector(std::initializer_list<T> init, compression mode = compression::packed) : mode_(mode) {
+        for (T v : init) push_back(v);
+    }
+
+    // ========================================================================
+    // Observers
+    // ========================================================================
+
+    [[nodiscard]] size_type size() const noexcept {
+        if (const auto* r = std::get_if<InlineRep>(&storage_)) return r->size;
+        return std::get<HeapVec>(storage_).size();
+    }
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+    /** @brief True while values are stored compressed in the inline buffer. */
+    [[nodiscard]] bool is_inline() const noexcept { return std::holds_alternative<InlineRep>(storage_); }
+    [[nodiscard]] compression mode() const noexcept { return mode_; }
+    /** @brief Bits per value in packed inline mode; 0 otherwise. */
+    [[nodiscard]] unsigned bit_width() const noexcept {
+        const auto* r = std::get_if<InlineRep>(&storage_);
+        return (r && mode_ == compression::packed) ? r->width : 0;
+    }
+    /** @brief `sizeof(*this)` plus the heap buffer, if spilled. */
+    [[nodiscard]] size_type memory_usage() const noexcept {
+        size_type bytes = sizeof(*this);
+        if (const auto* vec = std::get_if<HeapVec>(&storage_)) bytes += vec->capacity() * sizeof(T);
+        return bytes;
+    }
+
+    /** @brief Value at `i`. O(1), except O(i) in inline `sorted_delta` mode. */
+    T operator[](size_type i) const noexcept {
+        if (const auto* vec = std::get_if<HeapVec>(&storage_)) return (*vec)[i];
+        const auto& r = std::get<InlineRep>(storage_);
+        if (mode_ == compression::packed) return extract_(r.words, i, r.width);
+        auto it = begin();
+        for (; i > 0; --i) ++it;
+        return *it;
+    }
+    T front() const noexcept { return (*this)[0]; }
+    T back() const noexcept {
+        if (const auto* r = std::get_if<InlineRep>(&storage_); r && mode_ == compression::sorted_delta) return r->last;
+        return (*this)[size() - 1];
+    }
+
+    const_iterator begin() const noexcept { return const_iterator(*this, 0); }
+    const_iterator end() const noexcept { return const_iterator(*this, size()); }
+
+    /**
+     * @brief Decodes every value into `out[0, size())`.
+     * Packed widths that divide 64 never straddle words; they take a
+     * fixed-width shift-and-mask loop that compilers vectorize.
+     */
+    void unpack(T* out) const noexcept {
+        if (const auto* vec = std::get_if<HeapVec>(&storage_)) { std::copy(vec->begin(), vec->end(), out); return; }
+        const auto& r = std::get<InlineRep>(storage_);
+        if (mode_ == compression::sorted_delta) {
+            size_type pos = 0; T acc = 0;
+            for (size_type i = 0; i < r.size; ++i) { acc += static_cast<T>(read_varint_(r.bytes(), pos)); out[i] = acc; }
+            return;
+        }
+        switch (r.width) {
+            case 1: return unpack_aligned_<1>(r, out);
+            case 2: return unpack_aligned_<2>(r, out);
+            case 4: return unpack_aligned_<4>(r, out);
+            case 8: return unpack_aligned_<8>(r, out);
+            case 16: return unpack_aligned_<16>(r, out);
+            case 32: return unpack_aligned_<32>(r, out);
+            case 64: return unpack_aligned_<64>(r, out);
+            default:
+                for (size_type i = 0; i < r.size; ++i) out[i] = extract_(r.words, i, r.width);
+        }
+    }
+
+    // ========================================================================
+    // Modifiers
+    // ========================================================================
+
+    /** @brief Appends `v`, widening or spilling to the heap if it does not fit inline. */
+    void push_back(T v) {
+        if (auto* r = std::get_if<InlineRep>(&storage_)) {
+            if (push_inline_(*r, v)) return;
+            spill_(1);
+        }
+        std::get<HeapVec>(storage_).push_back(v);
+    }
+
+    /** @brief Removes the last value. O(size()) in inline `sorted_delta` mode. */
+    void pop_back() noexcept {
+        auto* r = std::get_if<InlineRep>(&storage_);
+        if (!r) { std::get<HeapVec>(storage_).pop_back(); return; }
+        if (mode_ == compression::sorted_delta) {
+            size_type pos = 0;
+            for (size_type i = 0; i + 1 < r->size; ++i) read_varint_(r->bytes(), pos);
+            r->nbytes = static_cast<std::uint32_t>(pos);
+            r->last -= static_cast<T>(read_varint_(r->bytes(), pos));
+        }
+        --r->size;
+    }
+
+    /** @brief Removes all values and returns to the empty inline representation. */
+    void clear() noexcept { storage_.template emplace<InlineRep>(); }
+
+    /** @brief Re-compresses heap contents back inline if they now fit; otherwise shrinks the heap buffer. */
+    void shrink_to_fit() {
+        auto* vec = std::get_if<HeapVec>(&storage_);
+        if (!vec) return;
+        InlineRep r;
+        for (T v : *vec) {
+            if (!push_inline_(r, v)) { vec->shrink_to_fit(); return; }
+        }
+        storage_ = r;
+    }
+
+    friend bool operator==(const CompressedInlinedVector& a, const CompressedInlinedVector& b) noexcept {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+    friend bool operator!=(const CompressedInlinedVector& a, const CompressedInlinedVector& b) noexcept {
+        return !(a == b);
+    }
+};
+
+// ============================================================================
+// InlinedVectorInterner: hash-consing of equal vectors behind 32-bit handles
+// ============================================================================
+
+namespace detail {
+/** @brief splitmix64 finalizer: full avalanche of a 64-bit word. */
+inline std::uint64_t hash_fmix64(std::uint64_t x) noexcept {
+    x ^= x >> 30; x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27; x *= 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/** @brief Hashes `len` bytes eight at a time. Not cryptographic; fine for hash tables. */
+inline std::uint64_t hash_bytes(const void* data, std::size_t len, std::uint64_t seed = 0) noexcept {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    std::uint64_t h = seed ^ (len * 0x9E3779B97F4A7C15ull);
+    for (; len >= 8; p += 8, len -= 8) {
+        std::uint64_t w; std::memcpy(&w, p, 8);
+        h = (h ^ hash_fmix64(w)) * 0x9E3779B97F4A7C15ull;
+    }
+    if (len) {
+        std::uint64_t w = 0; std::memcpy(&w, p, len);
+        h = (h ^ hash_fmix64(w)) * 0x9E3779B97F4A7C15ull;
+    }
+    return hash_fmix64(h);
+}
+} // namespace detail
+
+/** @brief Memory and traffic counters of an `InlinedVectorInterner`. */
+struct interner_stats {
+    std::size_t distinct = 0;     ///< Values stored (one per distinct content)
+    std::size_t lookups = 0;      ///< `intern` calls, counting each `intern_batch` element
+    std::size_t value_bytes = 0;  ///< `memory_usage()` of the stored values
+    std::size_t index_bytes = 0;  ///< Hash tables (including outgrown ones) and unused value slots
+};
+
+/**
+ * @brief Stores each distinct `InlinedVector<T, N>` content once and names it by
+ * a stable 32-bit handle.
+ *
+ * `intern(v)` returns the handle of the stored copy of `v`, adding one on the
+ * first call for that content. Equal contents always get the same handle, so
+ * equality becomes a handle compare. `operator[]` returns a reference to the
+ * stored vector that stays valid for the interner's lifetime; nothing is ever
+ * removed. Values live in segments that double in size, so growth never moves
+ * one.
+ *
+ * The index is split into 64 shards by hash. Each shard is a linear-probing
+ * table of (32-bit hash tag, handle) words. Lookups that hit take no lock: they
+ * probe the shard's current table with acquire loads and write only a lookup
+ * counter striped per thread, never the shard's line. Misses lock the shard,
+ * probe again and insert. A shard that outgrows its table publishes a copy twice
+ * the size and keeps the old one until destruction, so a concurrent lock-free
+ * probe never reads freed memory. When `T` is trivially copyable with unique
+ * object representations (integers, for example), hashing and comparison work
+ * on the contiguous element bytes; otherwise they use `Hash` and `operator==`
+ * per element.
+ *
+ * `intern_batch` hashes a block of inputs and prefetches their table slots
+ * before probing any of them, which overlaps the cache misses of a large batch.
+ * All member functions are thread-safe.
+ *
+ * @tparam T Element type.
+ * @tparam N Inline capacity of the stored vectors.
+ * @tparam Hash Element hash, used when `T` cannot be hashed as bytes.
+ * @tparam Alloc Allocator for the stored vectors.
+ */
+template<typename T, std::size_t N, typename Hash = std::hash<T>, typename Alloc = std::allocator<T>>
+class InlinedVectorInterner {
+public:
+    using vector_type = InlinedVector<T, N, Alloc>;
+    using handle = std::uint32_t;
+    using size_type = std::size_t;
+
+    /** @brief Handles are indices into the value store, in interning order. */
+    static constexpr handle max_handles = std::numeric_limits<handle>::max();
+
+private:
+    static constexpr bool bytewise_ = std::is_trivially_copyable_v<T> && std::has_unique_object_representations_v<T>;
+    static constexpr unsigned kShardBits = 6;
+    static constexpr std::size_t kShards = std::size_t{1} << kShardBits;
+    static constexpr unsigned kFirstSegmentBits = 6; // Segment k holds 64 << k values
+    static constexpr unsigned kSegments = 32 - kFirstSegmentBits + 1;
+    static constexpr std::size_t kBatchBlock = 32;
+    static constexpr std::size_t kLookupStripes = 16;
+
+    using ValueAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<vector_type>;
+    using ValueTraits = std::allocator_traits<ValueAlloc>;
+
+    /** @brief One shard's open-addressing table. A slot is `tag << 32 | (handle + 1)`; 0 is empty. */
+    struct Table {
+        std::size_t mask;
+        std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+        explicit Table(std::size_t cap) : mask(cap - 1), slots(new std::atomic<std::uint64_t>[cap]) {
+            for (std::size_t i = 0; i < cap; ++i) slots[i].store(0, std::memory_order_relaxed);
+        }
+    };
+
+    struct alignas(detail::spsc_cache_line) Shard {
+        std::atomic<Table*> table{nullptr};
+        std::mutex mu;                                  // Serializes inserts and growth
+        std::size_t count = 0;
+        std::vector<std::unique_ptr<Table>> tables;     // Current one last; outgrown ones kept for probes in flight
+    };
+
+    /** @brief A lookup counter on its own line, so hits never write a shard's line. */
+    struct alignas(detail::spsc_cache_line) LookupStripe {
+        std::atomic<std::size_t> n{0};
+    };
+
+    Shard shards_[kShards];
+    LookupStripe lookups_[kLookupStripes];             // Summed by stats()
+    std::atomic<vector_type*> segments_[kSegments] = {};
+    std::atomic<std::size_t> size_{0};
+    mutable std::mutex values_mu_;                     // Serializes appends to the value store
+    std::size_t value_bytes_ = 0;                      // Guarded by values_mu_
+    LLOYAL_NO_UNIQUE_ADDRESS ValueAlloc value_alloc_;
+    LLOYAL_NO_UNIQUE_ADDRESS Hash hash_;
+
+    static std::size_t segment_size_(unsigned seg) noexcept { return std::size_t{1} << (seg + kFirstSegmentBits); }
+
+    const vector_type& value_(handle h) const noexcept {
+        const std::uint64_t idx = std::uint64_t{h} + (std::uint64_t{1} << kFirstSegmentBits);
+        const unsigned seg = detail::bit_width_u64(idx) - 1 - kFirstSegmentBits;
+        return segments_[seg].load(std::memory_order_acquire)[idx - segment_size_(seg)];
+    }
+
+    std::uint64_t hash_of_(const T* p, size_type n) const {
+        if constexpr (bytewise_) {
+            return detail::hash_bytes(p, n * sizeof(T));
+        } else {
+            std::uint64_t h = n * 0x9E3779B97F4A7C15ull;
+            for (size_type i = 0; i < n; ++i) h = (h ^ detail::hash_fmix64(static_cast<std::uint64_t>(hash_(p[i])))) * 0x9E3779B97F4A7C15ull;
+            return detail::hash_fmix64(h);
+        }
+    }
+    static bool equal_(const vector_type& v, const T* p, size_type n) {
+        if (v.size() != n) return false;
+        if constexpr (bytewise_) return n == 0 || std::memcmp(v.data(), p, n * sizeof(T)) == 0;
+        else return std::equal(v.begin(), v.end(), p);
+    }
+    Shard& shard_of_(std::uint64_t h) noexcept { return shards_[h >> (64 - kShardBits)]; }
+
+    /** @brief Counts `k` lookups on the calling thread's stripe, assigned round-robin on first use. */
+    void count_lookups_(std::size_t k) noexcept {
+        static std::atomic<std::size_t> next_stripe{0};
+        thread_local const std::size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed) % kLookupStripes;
+        lookups_[stripe].n.fetch_add(k, std::memory_order_relaxed);
+    }
+
+    /** @brief Probes `t` for the content; returns its handle + 1, or 0. Safe without the shard lock. */
+    std::uint64_t probe_(const Table& t, std::uint64_t h, const T* p, size_type n) const {
+        const std::uint32_t tag = static_cast<std::uint32_t>(h);
+        for (std::size_t i = tag & t.mask;; i = (i + 1) & t.mask) {
+            const std::uint64_t e = t.slots[i].load(std::memory_order_acquire);
+            if (e == 0) return 0;
+            if (static_cast<std::uint32_t>(e >> 32) == tag && equal_(value_(static_cast<handle>(e) - 1), p, n)) {
+                return static_cast<std::uint32_t>(e);
+            }
+        }
+    }
+
+    static void place_(Table& t, std::uint64_t entry) noexcept {
+        std::size_t i = static_cast<std::uint32_t>(entry >> 32) & t.mask;
+        while (t.slots[i].load(std::memory_order_relaxed) != 0) i = (i + 1) & t.mask;
+        t.slots[i].store(entry, std::memory_order_release);
+    }
+
+    /** @brief Appends a copy of the content to the value store and returns its handle. */
+    handle append_(const T* p, size_type n) {
+        std::lock_guard<std::mutex> lock(values_mu_);
+        const std::size_t idx = size_.load(std::memory_order_relaxed);
+        if (idx >= max_handles) throw std::length_error("InlinedVectorInterner: handle space exhausted");
+        const std::uint64_t slot = std::uint64_t{idx} + (std::uint64_t{1} << kFirstSegmentBits);
+        const unsigned seg = detail::bit_width_u64(slot) - 1 - kFirstSegmentBits;
+        vector_type* base = segments_[seg].load(std::memory_order_relaxed);
+        if (!base) {
+            base = ValueTraits::allocate(value_alloc_, segment_size_(seg));
+            segments_[seg].store(base, std::memory_order_release);
+        }
+        vector_type* v = base + (slot - segment_size_(seg));
+        ValueTraits::construct(value_alloc_, v, Alloc(value_alloc_));
+        try {
+            v->reserve(n);
+            for (size_type i = 0; i < n; ++i) v->push_back(p[i]);
+        } catch (...) { ValueTraits::destroy(value_alloc_, v); throw; }
+        value_bytes_ += v->memory_usage();
+        size_.store(idx + 1, std::memory_order_release);
+        return static_cast<handle>(idx);
+    }
+
+    /** @brief The locked miss path: probe the current table again, then insert. */
+    handle insert_slow_(Shard& s, std::uint64_t h, const T* p, size_type n) {
+        std::lock_guard<std::mutex> lock(s.mu);
+        Table* t = s.table.load(std::memory_order_relaxed);
+        if (!t) {
+            s.tables.push_back(std::make_unique<Table>(16));
+            t = s.tables.back().get();
+            s.table.store(t, std::memory_order_release);
+        } else if (const std::uint64_t found = probe_(*t, h, p, n)) {
+            return static_cast<handle>(found - 1);
+        }
+        // Grow before storing the value: a throw here must not leave it unindexed
+        if ((s.count + 1) * 2 > t->mask + 1) { // Keep the load factor at most 1/2
+            auto grown = std::make_unique<Table>((t->mask + 1) * 2);
+            for (std::size_t i = 0; i <= t->mask; ++i) {
+                if (const std::uint64_t e = t->slots[i].load(std::memory_order_relaxed)) place_(*grown, e);
+            }
+            t = grown.get();
+            s.tables.push_back(std::move(grown));
+            s.table.store(t, std::memory_order_release);
+        }
+        const handle id = append_(p, n);
+        place_(*t, (std::uint64_t{static_cast<std::uint32_t>(h)} << 32) | (std::uint64_t{id} + 1));
+        ++s.count;
+        return id;
+    }
+
+public:
+    explicit InlinedVectorInterner(const Alloc& alloc = Alloc{}, const Hash& hash = Hash{})
+        : value_alloc_(alloc), hash_(hash) {}
+    InlinedVectorInterner(const InlinedVectorInterner&) = delete;
+    InlinedVectorInterner& operator=(const InlinedVectorInterner&) = delete;
+
+    ~InlinedVectorInterner() {
+        const std::size_t n = size_.load(std::memory_order_relaxed);
+        for (unsigned seg = 0; seg < kSegments; ++seg) {
+            vector_type* base = segments_[seg].load(std::memory_order_relaxed);
+            if (!base) break;
+            const std::size_t first = segment_size_(seg) - segment_size_(0);
+            const std::size_t used = n > first ? std::min(n - first, segment_size_(seg)) : 0;
+            for (std::size_t i = 0; i < used; ++i) ValueTraits::destroy(value_alloc_, base + i);
+            ValueTraits::deallocate(value_alloc_, base, segment_size_(seg));
+        }
+    }
+
+    /** @brief Handle of the stored copy of `[p, p + n)`, storing one on first sight. Lock-free when present. */
+    handle intern(const T* p, size_type n) {
+        const std::uint64_t h = hash_of_(p, n);
+        Shard& s = shard_of_(h);
+        count_lookups_(1);
+        if (const Table* t = s.table.load(std::memory_order_acquire)) {
+            if (const std::uint64_t found = probe_(*t, h, p, n)) return static_cast<handle>(found - 1);
+        }
+        return insert_slow_(s, h, p, n);
+    }
+    /** @brief Interns any contiguous container with `data()` and `size()`. */
+    template<class Container>
+    handle intern(const Container& c) { return intern(std::data(c), std::size(c)); }
+    handle intern(std::initializer_list<T> il) { return intern(il.begin(), il.size()); }
+
+    /**
+     * @brief Interns every container in `[first, last)`, writing handles to `out`.
+     * Hashes and prefetches blocks of 32 inputs before probing them.
+     */
+    template<class InputIt, class OutputIt>
+    OutputIt intern_batch(InputIt first, InputIt last, OutputIt out) {
+        std::uint64_t hashes[kBatchBlock];
+        const T* ptrs[kBatchBlock];
+        size_type sizes[kBatchBlock];
+        while (first != last) {
+            std::size_t k = 0;
+            for (; k < kBatchBlock && first != last; ++k, ++first) {
+                ptrs[k] = std::data(*first); sizes[k] = std::size(*first);
+                hashes[k] = hash_of_(ptrs[k], sizes[k]);
+#if defined(__GNUC__) || defined(__clang__)
+                if (const Table* t = shard_of_(hashes[k]).table.load(std::memory_order_acquire)) {
+                    __builtin_prefetch(&t->slots[static_cast<std::uint32_t>(hashes[k]) & t->mask]);
+                }
+#endif
+            }
+            count_lookups_(k);
+            for (std::size_t i = 0; i < k; ++i) {
+                Shard& s = shard_of_(hashes[i]);
+                std::uint64_t found = 0;
+                if (const Table* t = s.table.load(std::memory_order_acquire)) found = probe_(*t, hashes[i], ptrs[i], sizes[i]);
+                *out++ = found ? static_cast<handle>(found - 1) : insert_slow_(s, hashes[i], ptrs[i], sizes[i]);
+            }
+        }
+        return out;
+    }
+
+    /** @brief The stored vector for `h`. Valid for the interner's lifetime. */
+    const vector_type& operator[](handle h) const noexcept {
+        assert(h < size_.load(std::memory_order_acquire));
+        return value_(h);
+    }
+
+    /** @brief Number of distinct values stored. */
+    [[nodiscard]] size_type size() const noexcept { return size_.load(std::memory_order_acquire); }
+
+    /** @brief Snapshot of the counters. Briefly locks each shard. */
+    [[nodiscard]] interner_stats stats() {
+        interner_stats st;
+        for (Shard& s : shards_) {
+            std::lock_guard<std::mutex> lock(s.mu);
+            for (const auto& t : s.tables) st.index_bytes += (t->mask + 1) * sizeof(std::uint64_t) + sizeof(Table);
+        }
+        for (const LookupStripe& l : lookups_) st.lookups += l.n.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(values_mu_);
+        st.distinct = size_.load(std::memory_order_relaxed);
+        st.value_bytes = value_bytes_;
+        std::size_t reserved = 0;
+        for (unsigned seg = 0; seg < kSegments && segments_[seg].load(std::memory_order_relaxed); ++seg) reserved += segment_size_(seg);
+        st.index_bytes += (reserved - st.distinct) * sizeof(vector_type) + sizeof(*this);
+        return st;
+    }
+};
+
+// ============================================================================
+// Numeric expressions: fused element-wise arithmetic and reductions
+// ============================================================================
+
+namespace detail {
+#if defined(__AVX__)
+inline constexpr std::size_t simd_bytes = 32;
+#else
+inline constexpr std::size_t simd_bytes = 16; // SSE2 / NEON
+#endif
+
+template<typename T>
+inline constexpr bool simd_lane_supported_v =
+    (std::is_floating_point_v<T> && !std::is_same_v<T, long double>) ||
+    (std::is_integral_v<T> && !std::is_same_v<T, bool>);
+
+/**
+ * @brief One SIMD register of `T`: a GCC/Clang vector-extension type, so the
+ * arithmetic lowers to the target's vector instructions without intrinsics.
+ * Elsewhere, and for unsupported `T`, a lane is one scalar.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+template<typename T, bool = simd_lane_supported_v<T>>
+struct simd_lane {
+    typedef T type __attribute__((vector_size(simd_bytes)));
+    static constexpr std::size_t width = simd_bytes / sizeof(T);
+};
+#else
+template<typename T, bool = false>
+struct simd_lane { using type = T; static constexpr std::size_t width = 1; };
+#endif
+template<typename T>
+struct simd_lane<T, false> { using type = T; static constexpr std::size_t width = 1; };
+
+template<typename T> using lane_t = typename simd_lane<T>::type;
+
+template<typename T>
+inline lane_t<T> lane_load(const T* p) noexcept {
+    lane_t<T> v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+template<typename T>
+inline void lane_store(T* p, const lane_t<T>& v) noexcept { std::memcpy(p, &v, sizeof(v)); }
+template<typename T>
+inline lane_t<T> lane_broadcast(T s) noexcept {
+    if constexpr (simd_lane<T>::width == 1) {
+        return s;
+    } else {
+        lane_t<T> v;
+        for (std::size_t i = 0; i < simd_lane<T>::width; ++i) v[i] = s;
+        return v;
+    }
+}
+template<typename T>
+inline T lane_sum(const lane_t<T>& v) noexcept {
+    if constexpr (simd_lane<T>::width == 1) {
+        return v;
+    } else {
+        T s = v[0];
+        for (std::size_t i = 1; i < simd_lane<T>::width; ++i) s += v[i];
+        return s;
+    }
+}
+
+struct num_add { template<class A, class B> auto operator()(const A& a, const B& b) const noexcept { return a + b; } };
+struct num_sub { template<class A, class B> auto operator()(const A& a, const B& b) const noexcept { return a - b; } };
+struct num_mul { template<class A, class B> auto operator()(const A& a, const B& b) const noexcept { return a * b; } };
+struct num_div { template<class A, class B> auto operator()(const A& a, const B& b) const noexcept { return a / b; } };
+
+/** @brief Tag base of every numeric expression node. */
+struct num_expr_base {};
+template<typename E>
+inline constexpr bool is_num_expr_v = std::is_base_of_v<num_expr_base, std::decay_t<E>>;
+
+/** @brief Leaf over contiguous elements. `Fixed` is the inline capacity of the source vector. */
+template<typename T, std::size_t Fixed>
+struct num_leaf : num_expr_base {
+    using value_type = T;
+    static constexpr std::size_t fixed = Fixed;
+    const T* p; std::size_t n;
+    std::size_t size() const noexcept { return n; }
+    T operator[](std::size_t i) const noexcept { return p[i]; }
+    lane_t<T> lane(std::size_t i) const noexcept { return lane_load(p + i); }
+};
+
+/** @brief A scalar broadcast to every index. */
+template<typename T>
+struct num_scalar : num_expr_base {
+    using value_type = T;
+    static constexpr std::size_t fixed = 0;
+    T v;
+    std::size_t size() const noexcept { return std::numeric_limits<std::size_t>::max(); }
+    T operator[](std::size_t) const noexcept { return v; }
+    lane_t<T> lane(std::size_t) const noexcept { return lane_broadcast(v); }
+};
+
+template<typename Op, typename L, typename R>
+struct num_binary : num_expr_base {
+    using value_type = typename L::value_type;
+    static_assert(std::is_same_v<value_type, typename R::value_type>, "numeric expressions need one element type");
+    // The compile-time size comes from whichever operand is a vector
+    static constexpr std::size_t fixed = L::fixed ? L::fixed : R::fixed;
+    L l; R r;
+    std::size_t size() const noexcept { return l.size() < r.size() ? l.size() : r.size(); }
+    value_type operator[](std::size_t i) const noexcept { return static_cast<value_type>(Op{}(l[i], r[i])); }
+    lane_t<value_type> lane(std::size_t i) const noexcept { return Op{}(l.lane(i), r.lane(i)); }
+};
+
+/**
+ * @brief Stores an operand by value: views are sliced to their `num_leaf`, other
+ * expressions are kept as is, and arithmetic scalars broadcast as `T`.
+ */
+template<typename T, typename E>
+auto num_operand(const E& e) noexcept {
+    if constexpr (!is_num_expr_v<E>) {
+        static_assert(std::is_arithmetic_v<E>, "numeric expressions combine views, expressions and scalars");
+        return num_scalar<T>{{}, static_cast<T>(e)};
+    } else if constexpr (std::is_base_of_v<num_leaf<T, E::fixed>, E>) {
+        return num_leaf<T, E::fixed>(e);
+    } else {
+        return e;
+    }
+}
+
+template<typename Op, typename L, typename R>
+auto num_make(const L& l, const R& r) noexcept {
+    using T = typename std::conditional_t<is_num_expr_v<L>, L, R>::value_type;
+    using LO = decltype(num_operand<T>(l));
+    using RO = decltype(num_operand<T>(r));
+    if constexpr (is_num_expr_v<L> && is_num_expr_v<R>) assert(l.size() == r.size());
+    return num_binary<Op, LO, RO>{{}, num_operand<T>(l), num_operand<T>(r)};
+}
+
+// Operators live beside the nodes so argument-dependent lookup finds them.
+template<typename L, typename R, std::enable_if_t<is_num_expr_v<L> || is_num_expr_v<R>, int> = 0>
+auto operator+(const L& l, const R& r) noexcept { return num_make<num_add>(l, r); }
+template<typename L, typename R, std::enable_if_t<is_num_expr_v<L> || is_num_expr_v<R>, int> = 0>
+auto operator-(const L& l, const R& r) noexcept { return num_make<num_sub>(l, r); }
+template<typename L, typename R, std::enable_if_t<is_num_expr_v<L> || is_num_expr_v<R>, int> = 0>
+auto operator*(const L& l, const R& r) noexcept { return num_make<num_mul>(l, r); }
+template<typename L, typename R, std::enable_if_t<is_num_expr_v<L> || is_num_expr_v<R>, int> = 0>
+auto operator/(const L& l, const R& r) noexcept { return num_make<num_div>(l, r); }
+
+/**
+ * @brief Runs `body(i)` on whole lanes, then the scalar `tail(i)` on the rest.
+ * When `n == Fixed` the trip counts are compile-time constants: the lane loop
+ * unrolls and the tail vanishes when the lane width divides `Fixed`.
+ */
+template<typename T, std::size_t Fixed, typename Body, typename Tail>
+inline void num_for_each(std::size_t n, Body&& body, Tail&& tail) {
+    constexpr std::size_t W = simd_lane<T>::width;
+    if constexpr (Fixed > 0) {
+        if (n == Fixed) {
+            constexpr std::size_t full = Fixed / W * W;
+            for (std::size_t i = 0; i < full; i += W) body(i);
+            for (std::size_t i = full; i < Fixed; ++i) tail(i);
+            return;
+        }
+    }
+    std::size_t i = 0;
+    for (; i + W <= n; i += W) body(i);
+    for (; i < n; ++i) tail(i);
+}
+
+/** @brief Evaluates `e` into `out[0, e.size())`. Each index reads only its own operands, so `out` may alias a leaf. */
+template<typename E>
+inline void num_eval(typename E::value_type* out, const E& e) {
+    using T = typename E::value_type;
+    num_for_each<T, E::fixed>(e.size(),
+        [&](std::size_t i) { lane_store(out + i, e.lane(i)); },
+        [&](std::size_t i) { out[i] = e[i]; });
+}
+
+template<typename E>
+inline typename E::value_type num_reduce_sum(const E& e) {
+    using T = typename E::value_type;
+    lane_t<T> acc = lane_broadcast(T{});
+    T tail{};
+    num_for_each<T, E::fixed>(e.size(),
+        [&](std::size_t i) { acc = acc + e.lane(i); },
+        [&](std::size_t i) { tail += e[i]; });
+    return static_cast<T>(lane_sum<T>(acc) + tail);
+}
+
+template<typename T, std::size_t N, typename Alloc, std::size_t Align, std::enable_if_t<std::is_arithmetic_v<T>, int> = 0>
+LLOYAL_ALWAYS_INLINE num_leaf<T, N> num_leaf_of(const InlinedVector<T, N, Alloc, Align>& v) noexcept { return {{}, v.data(), v.size()}; }
+template<typename E, std::enable_if_t<is_num_expr_v<E>, int> = 0>
+auto num_leaf_of(const E& e) noexcept { return num_operand<typename E::value_type>(e); }
+
+template<typename E, typename = void>
+struct is_num_operand : std::false_type {};
+template<typename E>
+struct is_num_operand<E, std::void_t<decltype(num_leaf_of(std::declval<const E&>()))>> : std::true_type {};
+template<typename E>
+inline constexpr bool is_num_operand_v = is_num_operand<E>::value;
+} // namespace detail
+
+/**
+ * @brief Mutable numeric view of an `InlinedVector` of arithmetic `T`: the
+ * target of fused element-wise assignments.
+ *
+ * `num(v)` opts a vector into numeric expressions. Applying `+ - * /` to views,
+ * expressions and scalars builds an expression template, and nothing is computed
+ * until the result is assigned:
+ *
+ *     num(out) = num(a) + num(b) * num(c);   // one pass, no temporaries
+ *     num(a) *= 0.5f;
+ *     float d = dot(a, b), l = norm(a);
+ *
+ * Evaluation runs on SIMD lanes (`vector_size` types on GCC and Clang, 16 or 32
+ * bytes). When the size equals the inline capacity `N`, the loop has a
+ * compile-time trip count, with no remainder when the lane width divides `N`.
+ * Other sizes, spilled vectors included, take the runtime loop with a scalar
+ * tail. Reductions keep one accumulator per lane, so float results can differ
+ * from a sequential loop in the last bits. Operands must have equal sizes;
+ * assigning an expression of a different size resizes the target.
+ */
+template<typename T, std::size_t N, typename Alloc, std::size_t Align>
+class num_ref : public detail::num_leaf<T, N> {
+    static_assert(std::is_arithmetic_v<T>, "numeric expressions need an arithmetic element type");
+    InlinedVector<T, N, Alloc, Align>* v_;
+
+public:
+    // Reads go through the const accessors: non-const data() also repairs a
+    // valueless vector, which keeps it out of line and costs a call per operand.
+    explicit num_ref(InlinedVector<T, N, Alloc, Align>& v) noexcept : detail::num_leaf<T, N>(detail::num_leaf_of(std::as_const(v))), v_(&v) {}
+
+    template<typename E, std::enable_if_t<detail::is_num_expr_v<E>, int> = 0>
+    num_ref& operator=(const E& e) {
+        const std::size_t n = e.size();
+        if (n == this->n) {
+            // In place: element i depends only on operand elements i. Empty vectors write nothing.
+            detail::num_eval(const_cast<T*>(this->p), e);
+        } else {
+            InlinedVector<T, N, Alloc, Align> out(v_->get_allocator());
+            out.resize(n);
+            detail::num_eval(out.data(), e);
+            *v_ = std::move(out);
+            static_cast<detail::num_leaf<T, N>&>(*this) = detail::num_leaf_of(std::as_const(*v_));
+        }
+        return *this;
+    }
+    num_ref& operator=(const num_ref& other) { return operator=(static_cast<const detail::num_leaf<T, N>&>(other)); }
+
+    template<typename E> num_ref& operator+=(const E& e) { return *this = *this + e; }
+    template<typename E> num_ref& operator-=(const E& e) { return *this = *this - e; }
+    template<typename E> num_ref& operator*=(const E& e) { return *this = *this * e; }
+    template<typename E> num_ref& operator/=(const E& e) { return *this = *this / e; }
+};
+
+/** @brief Numeric view of `v` for fused element-wise expressions. */
+template<typename T, std::size_t N, typename Alloc, std::size_t Align>
+num_ref<T, N, Alloc, Align> num(InlinedVector<T, N, Alloc, Align>& v) noexcept { return num_ref<T, N, Alloc, Align>(v); }
+/** @brief Read-only numeric view of `v`. */
+template<typename T, std::size_t N, typename Alloc, std::size_t Align>
+detail::num_leaf<T, N> num(const InlinedVector<T, N, Alloc, Align>& v) noexcept { return detail::num_leaf_of(v); }
+
+/** @brief Sum of the elements of a vector or expression. */
+template<typename E, std::enable_if_t<detail::is_num_operand_v<E>, int> = 0>
+auto sum(const E& e) { return detail::num_reduce_sum(detail::num_leaf_of(e)); }
+
+/** @brief Dot product, fused: no product vector is materialized. */
+template<typename A, typename B,
+         std::enable_if_t<detail::is_num_operand_v<A> && detail::is_num_operand_v<B>, int> = 0>
+auto dot(const A& a, const B& b) {
+    const auto la = detail::num_leaf_of(a);
+    const auto lb = detail::num_leaf_of(b);
+    assert(la.size() == lb.size());
+    return detail::num_reduce_sum(detail::num_make<detail::num_mul>(la, lb));
+}
+
+/** @brief Euclidean norm, `sqrt(dot(a, a))`, for floating-point elements. */
+template<typename A, std::enable_if_t<detail::is_num_operand_v<A>, int> = 0>
+auto norm(const A& a) { return std::sqrt(dot(a, a)); }
+
+// ============================================================================
+// InlinedMatrix: row-major 2D storage, inline up to Rows x Cols
+// ============================================================================
+
+/**
+ * @brief A one-dimensional view of `size()` elements spaced `stride()` apart:
+ * a matrix row (stride 1) or column (stride = row pitch).
+ */
+template<typename T>
+class strided_span {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    /** @brief Random-access iterator stepping `stride` elements at a time. */
+    class iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::remove_cv_t<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        iterator() noexcept = default;
+        iterator(T* p, difference_type stride) noexcept : p_(p), stride_(stride) {}
+
+        reference operator*() const noexcept { return *p_; }
+        pointer operator->() const noexcept { return p_; }
+        reference operator[](difference_type n) const noexcept { return p_[n * stride_]; }
+        iterator& operator++() noexcept { p_ += stride_; return *this; }
+        iterator operator++(int) noexcept { iterator t = *this; p_ += stride_; return t; }
+        iterator& operator--() noexcept { p_ -= stride_; return *this; }
+        iterator operator--(int) noexcept { iterator t = *this; p_ -= stride_; return t; }
+        iterator& operator+=(difference_type n) noexcept { p_ += n * stride_; return *this; }
+        iterator& operator-=(difference_type n) noexcept { p_ -= n * stride_; return *this; }
+        friend iterator operator+(iterator it, difference_type n) noexcept { return it += n; }
+        friend iterator operator+(difference_type n, iterator it) noexcept { return it += n; }
+        friend iterator operator-(iterator it, difference_type n) noexcept { return it -= n; }
+        friend difference_type operator-(const iterator& a, const iterator& b) noexcept { return (a.p_ - b.p_) / a.stride_; }
+        friend bool operator==(const iterator& a, const iterator& b) noexcept { return a.p_ == b.p_; }
+        friend bool operator!=(const iterator& a, const iterator& b) noexcept { return a.p_ != b.p_; }
+        friend bool operator<(const iterator& a, const iterator& b) noexcept { return a.stride_ > 0 ? a.p_ < b.p_ : a.p_ > b.p_; }
+        friend bool operator>(const iterator& a, const iterator& b) noexcept { return b < a; }
+        friend bool operator<=(const iterator& a, const iterator& b) noexcept { return !(b < a); }
+        friend bool operator>=(const iterator& a, const iterator& b) noexcept { return !(a < b); }
+
+    private:
+        T* p_ = nullptr;
+        difference_type stride_ = 1;
+    };
+
+    strided_span() noexcept = default;
+    strided_span(T* data, size_type size, difference_type stride = 1) noexcept : data_(data), size_(size), stride_(stride) {}
+    /** @brief A row of a mutable matrix converts to a row of a const one. */
+    template<typename U, std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>, int> = 0>
+    strided_span(const strided_span<U>& other) noexcept : data_(other.data()), size_(other.size()), stride_(other.stride()) {}
+
+    pointer data() const noexcept { return data_; }
+    size_type size() const noexcept { return size_; }
+    difference_type stride() const noexcept { return stride_; }
+    bool empty() const noexcept { return size_ == 0; }
+    /** @brief True when the elements are adjacent, so `data()` can be used as an array. */
+    bool contiguous() const noexcept { return stride_ == 1 || size_ <= 1; }
+    reference operator[](size_type i) const noexcept { assert(i < size_); return data_[static_cast<difference_type>(i) * stride_]; }
+    reference front() const noexcept { return (*this)[0]; }
+    reference back() const noexcept { return (*this)[size_ - 1]; }
+    iterator begin() const noexcept { return iterator(data_, stride_); }
+    iterator end() const noexcept { return iterator(data_ + static_cast<difference_type>(size_) * stride_, stride_); }
+
+private:
+    T* data_ = nullptr;
+    size_type size_ = 0;
+    difference_type stride_ = 1;
+};
+
+/**
+ * @brief Non-owning two-dimensional view with `std::mdspan`-style accessors:
+ * `extent(r)`, `stride(r)`, `data_handle()` and `operator()(i, j)`. Element
+ * `(i, j)` lives at `data_handle()[i * stride(0) + j * stride(1)]`, so
+ * `transposed()` only swaps extents and strides.
+ */
+template<typename T>
+class matrix_view {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using size_type = std::size_t;
+    using index_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using data_handle_type = T*;
+
+    matrix_view() noexcept = default;
+    /** @brief Row-major view of `rows x cols` elements starting at `data`. */
+    matrix_view(T* data, size_type rows, size_type cols) noexcept
+        : data_(data), extents_{rows, cols}, strides_{static_cast<difference_type>(cols), 1} {}
+    matrix_view(T* data, size_type rows, size_type cols, difference_type row_stride, difference_type col_stride) noexcept
+        : data_(data), extents_{rows, cols}, strides_{row_stride, col_stride} {}
+    template<typename U, std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>, int> = 0>
+    matrix_view(const matrix_view<U>& other) noexcept
+        : data_(other.data_handle()), extents_{other.extent(0), other.extent(1)}, strides_{other.stride(0), other.stride(1)} {}
+
+    static constexpr std::size_t rank() noexcept { return 2; }
+    size_type extent(std::size_t r) const noexcept { assert(r < 2); return extents_[r]; }
+    difference_type stride(std::size_t r) const noexcept { assert(r < 2); return strides_[r]; }
+    size_type rows() const noexcept { return extents_[0]; }
+    size_type cols() const noexcept { return extents_[1]; }
+    size_type size() const noexcept { return extents_[0] * extents_[1]; }
+    bool empty() const noexcept { return size() == 0; }
+    data_handle_type data_handle() const noexcept { return data_; }
+    /** @brief True for a row-major view with no padding between rows. */
+    bool is_exhaustive() const noexcept { return strides_[1] == 1 && strides_[0] == static_cast<difference_type>(extents_[1]); }
+
+    reference operator()(index_type i, index_type j) const noexcept {
+        assert(i < extents_[0] && j < extents_[1]);
+        return data_[static_cast<difference_type>(i) * strides_[0] + static_cast<difference_type>(j) * strides_[1]];
+    }
+    strided_span<T> row(index_type i) const noexcept { assert(i < extents_[0]); return {&(*this)(i, 0), extents_[1], strides_[1]}; }
+    strided_span<T> column(index_type j) const noexcept { assert(j < extents_[1]); return {&(*this)(0, j), extents_[0], strides_[0]}; }
+    /** @brief The same elements with rows and columns exchanged. Nothing moves. */
+    matrix_view transposed() const noexcept { return {data_, extents_[1], extents_[0], strides_[1], strides_[0]}; }
+    /** @brief Rows `[row, row + rows)` and columns `[col, col + cols)`. */
+    matrix_view submatrix(index_type row, index_type col, size_type rows, size_type cols) const noexcept {
+        assert(row + rows <= extents_[0] && col + cols <= extents_[1]);
+        return {rows && cols ? &(*this)(row, col) : data_, rows, cols, strides_[0], strides_[1]};
+    }
+
+#if LLOYAL_HAS_MDSPAN
+    /** @brief The equivalent `std::mdspan` with `layout_stride`. */
+    std::mdspan<T, std::dextents<std::size_t, 2>, std::layout_stride> to_mdspan() const noexcept {
+        using extents_type = std::dextents<std::size_t, 2>;
+        const std::array<std::size_t, 2> strides{static_cast<std::size_t>(strides_[0]), static_cast<std::size_t>(strides_[1])};
+        return {data_, std::layout_stride::mapping<extents_type>(extents_type(extents_[0], extents_[1]), strides)};
+    }
+#endif
+
+private:
+    T* data_ = nullptr;
+    std::array<size_type, 2> extents_{0, 0};
+    std::array<difference_type, 2> strides_{0, 1};
+};
+
+/**
+ * @brief A row-major `rows() x cols()` matrix that stores up to `Rows * Cols`
+ * elements inline and spills to a single heap block beyond that.
+ *
+ * It replaces nested `InlinedVector<InlinedVector<T, Cols>, Rows>`, which
+ * carries one header per row, scatters the rows, and allocates once per spilled
+ * row. The shape is dynamic. `Rows` and `Cols` only size the inline block, so
+ * any shape with `rows * cols <= Rows * Cols` (for example 8x4 in a 4x8 matrix)
+ * stays inline. Storage is an `InlinedVector<T, Rows * Cols, Alloc>`, so
+ * allocator support, alignment and spill behaviour are the same.
+ *
+ * `row(i)` is contiguous, `column(j)` is strided, and `view()` gives a
+ * `matrix_view` with `std::mdspan`-style accessors (and `to_mdspan()` where the
+ * standard library has `<mdspan>`). `resize(rows, cols)` keeps element
+ * `(i, j)` for every index inside both shapes. See `resize` for what it moves.
+ */
+template<typename T, std::size_t Rows, std::size_t Cols, typename Alloc = std::allocator<T>>
+class InlinedMatrix {
+public:
+    // --- Member Types ---
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using storage_type = InlinedVector<T, Rows * Cols, Alloc>;
+    using row_type = strided_span<T>;
+    using const_row_type = strided_span<const T>;
+    using view_type = matrix_view<T>;
+    using const_view_type = matrix_view<const T>;
+
+    static_assert(Rows > 0 && Cols > 0, "InlinedMatrix requires non-zero inline dimensions");
+
+    /** @brief Number of elements stored without heap allocation. */
+    static constexpr size_type inline_capacity = Rows * Cols;
+
+private:
+    storage_type data_;
+    size_type rows_ = 0;
+    size_type cols_ = 0;
+
+    /**
+     * @brief Changes shape, filling new elements with copies of `fill()`.
+     * Three strategies, each moving every kept element at most once:
+     * - Same width: rows are appended or dropped at the end. Nothing moves.
+     * - Must reallocate: kept elements move straight to their new positions in
+     *   the new block.
+     * - Otherwise in place: a wider shape moves rows back to front, and a
+     *   narrower one moves them front to back. Row 0 never moves.
+     */
+    template<typename Fill>
+    void reshape_(size_type rows, size_type cols, Fill&& fill) {
+        const size_type old_rows = rows_, old_cols = cols_;
+        const size_type total = rows * cols;
+        if (cols == old_cols || old_rows * old_cols == 0 || total == 0) {
+            if (cols != old_cols) data_.clear();
+            data_.resize(total, fill());
+        } else if (total > data_.capacity()) {
+            storage_type out(data_.get_allocator());
+            out.reserve(total);
+            const size_type keep_rows = std::min(rows, old_rows), keep_cols = std::min(cols, old_cols);
+            pointer p = data_.data();
+            for (size_type i = 0; i < keep_rows; ++i) {
+                for (size_type j = 0; j < keep_cols; ++j) out.push_back(std::move_if_noexcept(p[i * old_cols + j]));
+                for (size_type j = keep_cols; j < cols; ++j) out.push_back(fill());
+            }
+            out.resize(total, fill());
+            data_ = std::move(out);
+        } else if (cols > old_cols) {
+            const size_type keep_rows = std::min(rows, old_rows);
+            if (total > data_.size()) data_.resize(total, fill());
+            pointer p = data_.data();
+            for (size_type i = keep_rows; i-- > 1;) {
+                std::move_backward(p + i * old_cols, p + i * old_cols + old_cols, p + i * cols + old_cols);
+            }
+            for (size_type i = 0; i < keep_rows; ++i) std::fill(p + i * cols + old_cols, p + i * cols + cols, fill());
+            data_.resize(total, fill());
+        } else {
+            const size_type keep_rows = std::min(rows, old_rows);
+            pointer p = data_.data();
+            for (size_type i = 1; i < keep_rows; ++i) std::move(p + i * old_cols, p + i * old_cols + cols, p + i * cols);
+            data_.resize(keep_rows * cols, fill()); // Drops stale elements past the kept rows
+            data_.resize(total, fill());
+        }
+        rows_ = rows; cols_ = cols;
+    }
+
+public:
+    // ========================================================================
+    // Constructors
+    // ========================================================================
+
+    /** @brief Constructs an empty 0x0 matrix. */
+    explicit InlinedMatrix(const Alloc& alloc = Alloc{}) noexcept : data_(alloc) {}
+    /** @brief Constructs a `rows x cols` matrix of value-initialized elements. */
+    InlinedMatrix(size_type rows, size_type cols, const Alloc& alloc = Alloc{}) : data_(alloc) { resize(rows, cols); }
+    /** @brief Constructs a `rows x cols` matrix of copies of `value`. */
+    InlinedMatrix(size_type rows, size_type cols, const T& value, const Alloc& alloc = Alloc{}) : data_(alloc) { resize(rows, cols, value); }
+
+    InlinedMatrix(const InlinedMatrix&) = default;
+    InlinedMatrix(InlinedMatrix&& other) noexcept(std::is_nothrow_move_constructible_v<storage_type>)
+        : data_(std::move(other.data_)), rows_(std::exchange(other.rows_, 0)), cols_(std::exchange(other.cols_, 0)) {}
+    InlinedMatrix& operator=(const InlinedMatrix&) = default;
+    InlinedMatrix& operator=(InlinedMatrix&& other) noexcept(std::is_nothrow_move_assignable_v<storage_type>) {
+        if (this != &other) {
+            data_ = std::move(other.data_);
+            rows_ = std::exchange(other.rows_, 0); cols_ = std::exchange(other.cols_, 0);
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const noexcept { return data_.get_allocator(); }
+
+    // ========================================================================
+    // Shape and Capacity
+    // ========================================================================
+
+    size_type rows() const noexcept { return rows_; }
+    size_type cols() const noexcept { return cols_; }
+    /** @brief `rows() * cols()`. */
+    size_type size() const noexcept { return rows_ * cols_; }
+    bool empty() const noexcept { return size() == 0; }
+    size_type capacity() const noexcept { return data_.capacity(); }
+    /** @brief Reserves room for `count` elements. Beyond `inline_capacity` this spills to one heap block. */
+    void reserve(size_type count) { data_.reserve(count); }
+    void shrink_to_fit() { data_.shrink_to_fit(); }
+
+    /**
+     * @brief Changes the shape to `rows x cols`. Element `(i, j)` keeps its value
+     * for `i < min(rows, rows())` and `j < min(cols, cols())`; new elements are
+     * value-initialized. Changing only the row count moves nothing, and a change
+     * of width moves each kept element at most once (row 0 never).
+     */
+    template<typename U = T, std::enable_if_t<std::is_default_constructible_v<U>, int> = 0>
+    void resize(size_type rows, size_type cols) { reshape_(rows, cols, [] { return T(); }); }
+    /** @brief As `resize(rows, cols)`, filling new elements with copies of `value`. */
+    void resize(size_type rows, size_type cols, const T& value) {
+        const T fill(value); // May alias an element that moves
+        reshape_(rows, cols, [&]() -> const T& { return fill; });
+    }
+
+    /** @brief Removes all elements; the shape becomes 0x0. Capacity is kept. */
+    void clear() noexcept { data_.clear(); rows_ = 0; cols_ = 0; }
+
+    // ========================================================================
+    // Element Access and Views
+    // ========================================================================
+
+    reference operator()(size_type i, size_type j) noexcept { assert(i < rows_ && j < cols_); return data_.data()[i * cols_ + j]; }
+    const_reference operator()(size_type i, size_type j) const noexcept { assert(i < rows_ && j < cols_); return data_.data()[i * cols_ + j]; }
+    reference at(size_type i, size_type j) { if (i >= rows_ || j >= cols_) throw std::out_of_range("InlinedMatrix::at"); return (*this)(i, j); }
+    const_reference at(size_type i, size_type j) const { if (i >= rows_ || j >= cols_) throw std::out_of_range("InlinedMatrix::at"); return (*this)(i, j); }
+
+    /** @brief The row-major elements, `size()` of them. */
+    pointer data() noexcept { return data_.data(); }
+    const_pointer data() const noexcept { return data_.data(); }
+
+    /** @brief Row `i`: `cols()` contiguous elements. */
+    row_type row(size_type i) noexcept { assert(i < rows_); return {data_.data() + i * cols_, cols_, 1}; }
+    const_row_type row(size_type i) const noexcept { assert(i < rows_); return {data_.data() + i * cols_, cols_, 1}; }
+    /** @brief Column `j`: `rows()` elements, `cols()` apart. */
+    row_type column(size_type j) noexcept { assert(j < cols_); return {data_.data() + j, rows_, static_cast<difference_type>(cols_)}; }
+    const_row_type column(size_type j) const noexcept { assert(j < cols_); return {data_.data() + j, rows_, static_cast<difference_type>(cols_)}; }
+
+    /** @brief Row-major `matrix_view` of the whole matrix. Invalidated by reshaping or spilling. */
+    view_type view() noexcept { return {data_.data(), rows_, cols_}; }
+    const_view_type view() const noexcept { return {data_.data(), rows_, cols_}; }
+
+    /** @brief Sets every element to `value`. */
+    void fill(const T& value) { std::fill(data_.begin(), data_.end(), value); }
+
+    void swap(InlinedMatrix& other) noexcept(noexcept(std::declval<storage_type&>().swap(std::declval<storage_type&>()))) {
+        data_.swap(other.data_);
+        std::swap(rows_, other.rows_); std::swap(cols_, other.cols_);
+    }
+
+    friend bool operator==(const InlinedMatrix& a, const InlinedMatrix& b) {
+        return a.rows_ == b.rows_ && a.cols_ == b.cols_ && a.data_ == b.data_;
+    }
+    friend bool operator!=(const InlinedMatrix& a, const InlinedMatrix& b) { return !(a == b); }
+};
+
+template<typename T, std::size_t Rows, std::size_t Cols, typename Alloc>
+void swap(InlinedMatrix<T, Rows, Cols, Alloc>& a, InlinedMatrix<T, Rows, Cols, Alloc>& b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
+
+/**
+ * @brief Returns the transpose as a new matrix with the inline dimensions
+ * exchanged. The copy walks 8x8 tiles, so on large matrices both the reads and
+ * the strided writes stay within a few cache lines. For a transposed view that
+ * copies nothing, use `view().transposed()`.
+ */
+template<typename T, std::size_t Rows, std::size_t Cols, typename Alloc>
+InlinedMatrix<T, Cols, Rows, Alloc> transpose(const InlinedMatrix<T, Rows, Cols, Alloc>& m) {
+    constexpr std::size_t tile = 8;
+    const std::size_t rows = m.rows(), cols = m.cols();
+    InlinedMatrix<T, Cols, Rows, Alloc> out(cols, rows, m.get_allocator());
+    const T* src = m.data();
+    T* dst = out.data();
+    for (std::size_t ib = 0; ib < rows; ib += tile) {
+        const std::size_t ie = std::min(ib + tile, rows);
+        for (std::size_t jb = 0; jb < cols; jb += tile) {
+            const std::size_t je = std::min(jb + tile, cols);
+            for (std::size_t i = ib; i < ie; ++i) {
+                for (std::size_t j = jb; j < je; ++j) dst[j * rows + i] = src[i * cols + j];
+            }
+        }
+    }
+    return out;
+}
+
+// ============================================================================
+// AdaptiveInlinedVector: first-spill capacity learned per construction site
+// ============================================================================
+
+namespace detail {
+/**
+ * @brief Decaying histogram of the final sizes of one construction site's
+ * spilled vectors. Buckets are half-octaves: 1, 2, 3, 4-5, 6-7, 8-11, 12-15, ...
+ */
+struct spill_site_stats {
+    static constexpr unsigned kBuckets = 48;          // Sizes up to 2^24; larger ones share the last bucket
+    static constexpr std::uint32_t kMinSamples = 8;   // Below this, keep the default growth policy
+    static constexpr std::uint32_t kDecayAt = 256;    // Halve every count when the total reaches this
+
+    std::uint64_t key = 0;
+    std::uint32_t total = 0;
+    std::uint16_t counts[kBuckets] = {};
+
+    static unsigned bucket(std::size_t size) noexcept {
+        if (size <= 1) return 0;
+        const unsigned b = bit_width_u64(size) - 1;
+        const unsigned idx = 2 * b - 1 + static_cast<unsigned>((size >> (b - 1)) & 1);
+        return idx < kBuckets ? idx : kBuckets - 1;
+    }
+    static std::size_t upper_bound(unsigned idx) noexcept {
+        if (idx == 0) return 1;
+        const unsigned b = (idx + 1) / 2, h = (idx + 1) & 1;
+        return (std::size_t{1} << b) + (std::size_t{h + 1} << (b - 1)) - 1;
+    }
+
+    std::size_t cached_p90 = 0; // Refreshed every kMinSamples records; spills only read it
+
+    void record(std::size_t size) noexcept {
+        ++counts[bucket(size)];
+        if (++total >= kDecayAt) { // Old samples fade so a workload shift takes over quickly
+            total = 0;
+            for (auto& c : counts) { c >>= 1; total += c; }
+        }
+        if (total % kMinSamples == 0) cached_p90 = p90();
+    }
+
+    /** @brief Upper bound of the bucket holding the 90th percentile, or 0 with too few samples. */
+    std::size_t p90() const noexcept {
+        if (total < kMinSamples) return 0;
+        const std::uint32_t target = total - total / 10;
+        std::uint32_t seen = 0;
+        for (unsigned i = 0; i < kBuckets; ++i) {
+            seen += counts[i];
+            if (seen >= target) return upper_bound(i);
+        }
+        return upper_bound(kBuckets - 1);
+    }
+};
+
+/**
+ * @brief The calling thread's record for `key`. The table is direct-mapped, so
+ * two sites that collide evict each other and fall back to the default policy
+ * until they relearn.
+ */
+inline spill_site_stats& spill_stats_for(std::uint64_t key) noexcept {
+    static thread_local spill_site_stats table[64];
+    spill_site_stats& s = table[(key ^ (key >> 17) ^ (key >> 41)) & 63];
+    if (s.key != key) { s = spill_site_stats{}; s.key = key; }
+    return s;
+}
+
+template<typename Tag> inline const char spill_tag_anchor = 0;
+
+/** @brief Placeholder for the site parameter when the site is a tag type. */
+struct tag_site { static constexpr tag_site current() noexcept { return {}; } };
+
+/** @brief Site key taken from a tag type: a per-tag constant, no storage. */
+template<typename Site>
+struct spill_site_key {
+    using site_type = tag_site;
+    constexpr spill_site_key(tag_site = {}) noexcept {}
+    static std::uint64_t site_key() noexcept { return reinterpret_cast<std::uintptr_t>(&spill_tag_anchor<Site>); }
+};
+
+#if LLOYAL_HAS_SOURCE_LOCATION
+/** @brief Site key taken from the `std::source_location` of the construction. */
+template<>
+struct spill_site_key<void> {
+    using site_type = std::source_location;
+    std::uint64_t key_;
+    spill_site_key(const std::source_location& loc) noexcept
+        : key_((reinterpret_cast<std::uintptr_t>(loc.file_name()) * 0x9E3779B97F4A7C15ull)
+               ^ (std::uint64_t{loc.line()} << 20) ^ loc.column()) {}
+    std::uint64_t site_key() const noexcept { return key_; }
+};
+#endif
+
+/**
+ * @brief Spill-feedback allocator: `Base` plus the site key, so that
+ * `InlinedVector` reads and feeds that site's statistics on its spill and
+ * destruction paths only. Equality and assignment ignore the key, so each
+ * vector keeps its own site.
+ */
+template<typename Base, typename Site>
+class adaptive_spill_allocator : public Base, public spill_site_key<Site> {
+    using BaseTraits = std::allocator_traits<Base>;
+    using Key = spill_site_key<Site>;
+
+public:
+    template<typename U>
+    struct rebind { using other = adaptive_spill_allocator<typename BaseTraits::template rebind_alloc<U>, Site>; };
+
+    adaptive_spill_allocator(const Base& base, typename Key::site_type site) noexcept : Base(base), Key(site) {}
+    adaptive_spill_allocator(const adaptive_spill_allocator&) noexcept = default;
+    template<typename B>
+    adaptive_spill_allocator(const adaptive_spill_allocator<B, Site>& other) noexcept
+        : Base(static_cast<const B&>(other)), Key(static_cast<const Key&>(other)) {}
+
+    adaptive_spill_allocator& operator=(const adaptive_spill_allocator& other) noexcept {
+        Base::operator=(static_cast<const Base&>(other)); return *this;
+    }
+
+    std::size_t spill_capacity_hint() const noexcept { return spill_stats_for(this->site_key()).cached_p90; }
+    void record_spilled_size(std::size_t size) const noexcept { spill_stats_for(this->site_key()).record(size); }
+
+    adaptive_spill_allocator select_on_container_copy_construction() const {
+        return adaptive_spill_allocator(BaseTraits::select_on_container_copy_construction(*this), *this);
+    }
+
+    friend bool operator==(const adaptive_spill_allocator& a, const adaptive_spill_allocator& b) noexcept {
+        return static_cast<const Base&>(a) == static_cast<const Base&>(b);
+    }
+    friend bool operator!=(const adaptive_spill_allocator& a, const adaptive_spill_allocator& b) noexcept {
+        return !(a == b);
+    }
+
+private:
+    adaptive_spill_allocator(const Base& base, const Key& key) noexcept : Base(base), Key(key) {}
+};
+} // namespace detail
+
+/**
+ * @brief An `InlinedVector` that sizes its first heap allocation from the sizes
+ * that vectors built at the same site reached before.
+ *
+ * The default first spill is `max(2N, 1.5 * size + 1)`. A site whose vectors
+ * usually end at 500 elements then pays about ten reallocations. A site whose
+ * vectors stop at N+1 wastes N-1 slots. When this vector spills, it looks up a
+ * per-thread, per-site histogram of the final sizes of earlier spilled vectors.
+ * It reserves the 90th percentile, rounded up to a half-octave and refreshed
+ * every 8 samples. Spilled vectors record their size when destroyed. Counts halve every 256 samples, so a
+ * changed workload takes over within a few hundred vectors. Until a site has 8
+ * samples, or after its slot is evicted, the default policy applies.
+ *
+ * The site is either a tag type (`Site`), which adds no storage, or, when
+ * `Site` is `void`, the `std::source_location` of the construction (C++20),
+ * hashed into 8 bytes. It rides in the allocator (see `has_spill_feedback`),
+ * so `push_back` and friends run the plain `InlinedVector` code: only the
+ * spill, `resize` past `N` and the destruction of a spilled vector touch the
+ * statistics. `reserve` keeps its exact sizing. Copies inherit the source's
+ * site; assignment and swap keep each vector's own.
+ *
+ * @tparam T Element type.
+ * @tparam N Inline capacity.
+ * @tparam Site Tag type naming the site, or `void` for `std::source_location`.
+ * @tparam Alloc Allocator.
+ */
+template<typename T, std::size_t N, typename Site = void, typename Alloc = std::allocator<T>>
+class AdaptiveInlinedVector : public InlinedVector<T, N, detail::adaptive_spill_allocator<Alloc, Site>> {
+    using SpillAlloc = detail::adaptive_spill_allocator<Alloc, Site>;
+    using Base = InlinedVector<T, N, SpillAlloc>;
+#if !LLOYAL_HAS_SOURCE_LOCATION
+    static_assert(!std::is_void_v<Site>, "AdaptiveInlinedVector without std::source_location (C++20) needs a tag type for Site");
+#endif
+
+public:
+    using typename Base::size_type;
+    using site_type = typename detail::spill_site_key<Site>::site_type;
+
+    AdaptiveInlinedVector(site_type site = site_type::current()) noexcept : Base(SpillAlloc(Alloc{}, site)) {}
+    explicit AdaptiveInlinedVector(const Alloc& alloc, site_type site = site_type::current()) noexcept
+        : Base(SpillAlloc(alloc, site)) {}
+    AdaptiveInlinedVector(std::initializer_list<T> init, const Alloc& alloc = Alloc{}, site_type site = site_type::current())
+        : Base(init, SpillAlloc(alloc, site)) {}
+
+    /** @brief The capacity the next spill at this site would reserve (0: default policy). */
+    [[nodiscard]] size_type learned_spill_capacity() const noexcept {
+        return this->get_allocator().spill_capacity_hint();
+    }
+};
+
+} // namespace lloyal
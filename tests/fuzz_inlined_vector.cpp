@@ -72,6 +72,17 @@ template <typename T> struct TestAllocatorPOCS {
     friend bool operator==(const TestAllocatorPOCS& a, const TestAllocatorPOCS& b) { return a.id == b.id; } friend bool operator!=(const TestAllocatorPOCS& a, const TestAllocatorPOCS& b) { return a.id != b.id; }
 };
 
+// Counting Allocator (always equal, tracks allocations for budget checks)
+template <typename T> struct CountingAllocator {
+    using value_type = T; static inline std::atomic<int> allocations{0};
+    CountingAllocator() noexcept = default;
+    template <typename U> CountingAllocator(const CountingAllocator<U>&) noexcept {}
+    T* allocate(std::size_t n) { allocations++; return std::allocator<T>{}.allocate(n); }
+    void deallocate(T* p, std::size_t n) { std::allocator<T>{}.deallocate(p, n); }
+    using is_always_equal = std::true_type;
+    friend bool operator==(const CountingAllocator&, const CountingAllocator&) { return true; } friend bool operator!=(const CountingAllocator&, const CountingAllocator&) { return false; }
+};
+
 // --- FuzzTest Domain Factory Functions ---
 
 // Domain for generating MyType instances from ints
@@ -94,6 +105,11 @@ auto TestAllocatorPOCSDomainMyType() {
     return fuzztest::Map([](int v) { return TestAllocatorPOCS<MyType>(v % 10); }, fuzztest::Arbitrary<int>());
 }
 
+// Domain for generating (opcode, value) operation sequences
+auto OpSequenceDomain() {
+    return fuzztest::VectorOf(fuzztest::PairOf(fuzztest::InRange(0, 10), fuzztest::Arbitrary<int>())).WithMaxSize(200);
+}
+
 // Domain for generating std::vector<int>
 auto IntVectorDomain() {
     // Limit vector size slightly for fuzzing efficiency
@@ -408,4 +424,54 @@ FUZZ_TEST(InlinedVectorFuzzRegressions, RegressionMoveAssignParentRetarget)
     .WithDomains(TestAllocatorDomainMyType(), TestAllocatorDomainMyType(), IntVectorDomain());
 
 
+
+// ============================================================================
+// Allocation Budget Fuzz Tests (differential against std::vector<int>)
+// ============================================================================
+
+using CountingAllocInt = CountingAllocator<int>;
+using InlinedVectorIntCounting = lloyal::InlinedVector<int, FUZZ_INLINE_CAP, CountingAllocInt>;
+
+// Applies `ops` to a pair of vectors and their std::vector shadows. Every operation must
+// allocate at most once, and only when it has to grow; insert, erase, swap, clear and
+// pop_back within capacity must not allocate. With inline_only, growth is clamped to
+// FUZZ_INLINE_CAP and the whole sequence must allocate nothing.
+void RunAllocationBudget(const std::vector<std::pair<int, int>>& ops, bool inline_only) {
+    InlinedVectorIntCounting a, b;
+    std::vector<int> sa, sb;
+    const int allocs_at_start = CountingAllocInt::allocations;
+    for (const auto& [op, v] : ops) {
+        const size_t old_size = a.size(), old_cap = a.capacity();
+        const bool full = inline_only && old_size >= FUZZ_INLINE_CAP;
+        const unsigned u = static_cast<unsigned>(v);
+        int budget = 0;
+        const int before = CountingAllocInt::allocations;
+        switch (full && (op <= 2 || op == 10) ? 3 : op) {
+            case 0: case 1: budget = old_size < old_cap ? 0 : 1; a.push_back(v); sa.push_back(v); break;
+            case 2: { size_t pos = u % (old_size + 1); budget = old_size < old_cap ? 0 : 1;
+                      a.insert(a.begin() + pos, v); sa.insert(sa.begin() + pos, v); break; }
+            case 3: if (old_size) { a.pop_back(); sa.pop_back(); } break;
+            case 4: if (old_size) { size_t pos = u % old_size; a.erase(a.begin() + pos); sa.erase(sa.begin() + pos); } break;
+            case 5: if (old_size) { size_t f = u % old_size, l = f + (u / 7) % (old_size - f + 1);
+                      a.erase(a.begin() + f, a.begin() + l); sa.erase(sa.begin() + f, sa.begin() + l); } break;
+            case 6: a.clear(); sa.clear(); break;
+            case 7: { size_t req = u % (inline_only ? FUZZ_INLINE_CAP + 1 : 4 * FUZZ_INLINE_CAP); budget = req <= old_cap ? 0 : 1; a.reserve(req); break; }
+            case 8: budget = (old_cap > FUZZ_INLINE_CAP && old_size > FUZZ_INLINE_CAP) ? 1 : 0; a.shrink_to_fit(); break;
+            case 9: a.swap(b); std::swap(sa, sb); break;
+            case 10: budget = b.size() > FUZZ_INLINE_CAP ? 1 : 0; a = b; sa = sb; break;
+        }
+        ASSERT_LE(CountingAllocInt::allocations - before, budget) << "op " << op << " exceeded its allocation budget";
+        ASSERT_TRUE(ContentsMatchInt(a, sa));
+        ASSERT_TRUE(ContentsMatchInt(b, sb));
+    }
+    if (inline_only) ASSERT_EQ(CountingAllocInt::allocations, allocs_at_start) << "inline-only sequence allocated";
+}
+
+void InlineOnlySequencesNeverAllocate(const std::vector<std::pair<int, int>>& ops) { RunAllocationBudget(ops, true); }
+FUZZ_TEST(InlinedVectorFuzzAllocationBudget, InlineOnlySequencesNeverAllocate).WithDomains(OpSequenceDomain());
+
+void HeapSequencesAllocateOncePerGrowth(const std::vector<std::pair<int, int>>& ops) { RunAllocationBudget(ops, false); }
+FUZZ_TEST(InlinedVectorFuzzAllocationBudget, HeapSequencesAllocateOncePerGrowth).WithDomains(OpSequenceDomain());
+
+
 } // namespace
\ No newline at end of file
@@ -29,6 +29,11 @@
 #include <memory>   // For std::allocator
 #include <memory_resource> // For PMR tests (optional but good)
 #include <algorithm> // For std::max, std::min, std::equal, std::lexicographical_compare
+#include <random>    // For allocation-budget differential sequences
+#include <cstdint>   // For std::uintptr_t
+#include <optional>  // For explicit teardown in wink-out tests
+#include <thread>    // For the InlinedSpscRing producer thread
+#include <sstream>   // For single-pass input to merge_insert_sorted
 
 // Include the InlinedVector header
 #include "inlined_vector.hpp"
@@ -108,6 +113,30 @@ struct CopyConstructibleOnly {
 };
 static_assert(std::is_nothrow_move_assignable_v<CopyConstructibleOnly>); static_assert(!std::is_copy_assignable_v<CopyConstructibleOnly>);
 
+// --- Non-Trivial Non-Assignable Type (const member, nothrow move, optionally throwing copy) ---
+struct ConstMember {
+    static inline std::atomic<int> live{0}; static inline int copy_throw_countdown = -1;
+    const int id; std::string payload;
+    ConstMember(int i = 0) : id(i), payload("payload-that-defeats-sso-" + std::to_string(i)) { live++; }
+    ConstMember(const ConstMember& o) : id(o.id), payload(o.payload) { if (copy_throw_countdown > 0 && --copy_throw_countdown == 0) throw std::runtime_error("ConstMember: Copy constructor failed!"); live++; }
+    ConstMember(ConstMember&& o) noexcept : id(o.id), payload(std::move(o.payload)) { live++; }
+    ~ConstMember() { live--; }
+    static void reset() { live = 0; copy_throw_countdown = -1; }
+    bool operator==(const ConstMember& other) const { return id == other.id && payload == other.payload; }
+    bool operator!=(const ConstMember& other) const { return !(*this == other); }
+};
+static_assert(!std::is_move_assignable_v<ConstMember>); static_assert(!std::is_trivially_copyable_v<ConstMember>); static_assert(std::is_nothrow_move_constructible_v<ConstMember>);
+
+// --- Non-Assignable Type with a Throwing Move (no copy) ---
+struct ConstMoveMayThrow {
+    static inline int live = 0; static inline int throw_countdown = -1;
+    const int id;
+    ConstMoveMayThrow(int i) : id(i) { ++live; }
+    ConstMoveMayThrow(ConstMoveMayThrow&& o) noexcept(false) : id(o.id) { if (throw_countdown > 0 && --throw_countdown == 0) throw std::runtime_error("ConstMoveMayThrow: Move constructor failed!"); ++live; }
+    ~ConstMoveMayThrow() { --live; }
+};
+static_assert(!std::is_move_assignable_v<ConstMoveMayThrow>); static_assert(!std::is_nothrow_move_constructible_v<ConstMoveMayThrow>);
+
 
 // --- Test Allocator (POCMA=true, POCS=false) ---
 template <typename T> struct TestAllocator {
@@ -306,6 +335,9 @@ bool test_self_aliasing_insert() {
     MyType::reset(); { lloyal::InlinedVector<MyType, 2> v = {1, 2, 3}; v.insert(v.begin() + 1, std::move(v[0])); CHECK(v.size() == 4); CHECK(v.capacity() > 2); CHECK(v[1].value == 1); CHECK(v[2].value == 2); CHECK(MyType::move_constructions >= 1 || MyType::move_assignments >= 1); std::cout << "    Heap rvalue alias: OK\n"; }
     struct NonDefault { int val; NonDefault(int v) : val(v) {} NonDefault(const NonDefault&) = default; NonDefault(NonDefault&&) = default; NonDefault& operator=(const NonDefault&) = default; NonDefault& operator=(NonDefault&&) = default; bool operator==(const NonDefault& o) const { return val == o.val; } NonDefault() = delete; bool operator!=(const NonDefault& o) const { return !(*this == o); } };
     { lloyal::InlinedVector<NonDefault, 5> v; v.emplace_back(1); v.emplace_back(2); v.emplace_back(3); v.insert(v.begin() + 1, v[0]); CHECK(v.size() == 4); CHECK(v[1].val == 1); CHECK(v[2].val == 2); std::cout << "    Non-default-constructible alias: OK\n"; }
+    std::cout << "  Testing emplace_back of an aliased element at the spill...\n";
+    { const std::string big(40, 'x'); lloyal::InlinedVector<std::string, 2> v = {big, "y"}; v.push_back(v[0]); v.push_back(v[2]); CHECK(v.size() == 4 && v[2] == big && v[3] == big); std::cout << "    Spill lvalue alias: OK\n"; }
+    { const std::string big(40, 'x'); lloyal::InlinedVector<std::string, 2> v = {"y", big}; v.emplace_back(v[1], 0, 20); CHECK(v.size() == 3 && v[2] == big.substr(0, 20) && v[1] == big); std::cout << "    Spill emplace from an element: OK\n"; }
     std::cout << "✅ PASS: Self-aliasing insert handled correctly.\n"; return true;
 }
 
@@ -327,7 +359,7 @@ bool test_trivial_non_assignable_insert() {
 bool test_non_copy_assignable_insert() {
     std::cout << "\n--- TEST 9: Non-Copy-Assignable Insert ---\n"; constexpr size_t INLINE_CAP = 5; using VecType = lloyal::InlinedVector<CopyConstructibleOnly, INLINE_CAP>;
     VecType v = {1, 2, 3}; CopyConstructibleOnly forty_two(42);
-    std::cout << "  Attempting lvalue insert (inline, should fall back to slow path)...\n"; v.insert(v.begin() + 1, forty_two); CHECK(v.capacity() == VecType::inline_capacity); CHECK(check_contents(v, {1, 42, 2, 3})); std::cout << "    Lvalue insert guard OK (inline).\n";
+    std::cout << "  Attempting lvalue insert (inline, should use relocation path)...\n"; v.insert(v.begin() + 1, forty_two); CHECK(v.capacity() == VecType::inline_capacity); CHECK(check_contents(v, {1, 42, 2, 3})); std::cout << "    Lvalue insert guard OK (inline).\n";
     std::cout << "  Attempting rvalue insert (should use move)...\n"; VecType v_move = {10, 20, 30}; CopyConstructibleOnly ninety_nine(99); v_move.insert(v_move.begin() + 1, std::move(ninety_nine)); CHECK(v_move.capacity() == VecType::inline_capacity); CHECK(check_contents(v_move, {10, 99, 20, 30})); /* Removed check ninety_nine.val == -1 */; std::cout << "    Rvalue insert OK (inline).\n";
     std::cout << "  Attempting rvalue insert causing spill...\n"; v_move.insert(v_move.begin(), CopyConstructibleOnly(5)); v_move.insert(v_move.begin(), CopyConstructibleOnly(0)); CHECK(v_move.capacity() > VecType::inline_capacity); CHECK(check_contents(v_move, {0, 5, 10, 99, 20, 30})); std::cout << "    Rvalue insert spill OK.\n";
     std::cout << "✅ PASS: Correct paths chosen for non-copy-assignable type.\n"; return true;
@@ -397,6 +429,24 @@ bool test_allocator_support() {
      CHECK(v5.size() == 3); 
      CHECK(v4.empty()); 
      std::cout << "  Move assign propagates allocator: OK\n";
+
+     // pmr: the spill constructs the new element through the allocator, aliased or not
+     {
+         std::pmr::monotonic_buffer_resource pool;
+         std::pmr::memory_resource* prev = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+         bool ok = true;
+         try {
+             using PmrVec = lloyal::InlinedVector<std::pmr::string, 2, std::pmr::polymorphic_allocator<std::pmr::string>>;
+             const char* big = "a string long enough to leave the small-string buffer";
+             PmrVec a(&pool); a.emplace_back(big); a.emplace_back(big); a.emplace_back(big);
+             PmrVec b(&pool); b.emplace_back(big); b.emplace_back(big); b.push_back(b[0]);
+             ok = a.size() == 3 && b.size() == 3 && b[2] == big &&
+                  a[2].get_allocator().resource() == &pool && b[2].get_allocator().resource() == &pool;
+         } catch (const std::bad_alloc&) { ok = false; }
+         std::pmr::set_default_resource(prev);
+         CHECK(ok);
+     }
+     std::cout << "  pmr spill uses the container's resource: OK\n";
      
      // ** FIX: Removed mid-function reset and redundant v_final scope **
      // The destructors for v1-v5 will run after this return,
@@ -534,6 +584,1728 @@ bool test_regression_parent_retarget_move() {
     return true; // Leak check will be done by main runner
 }
 
+// ============================================================================
+// TEST 16: Relocation-Based Insert/Erase for Non-Assignable Types
+// ============================================================================
+bool test_relocation_non_assignable() {
+    std::cout << "\n--- TEST 16: Relocation-Based Insert/Erase (Non-Assignable) ---\n";
+    using Alloc = TestAllocator<ConstMember>;
+    using VecType = lloyal::InlinedVector<ConstMember, 4, Alloc>;
+    Alloc::reset(); ConstMember::reset();
+    {
+        VecType v;
+        for (int i = 0; i < 3; ++i) v.emplace_back(i);
+        v.insert(v.begin() + 1, ConstMember(10)); v.erase(v.begin());
+        CHECK(v.capacity() == VecType::inline_capacity); CHECK(Alloc::allocations == 0);
+        CHECK(check_contents(v, {10, 1, 2}));
+        std::cout << "  Inline insert/erase without rebuild: OK\n";
+
+        v.clear(); Alloc::reset();
+        for (int i = 0; i < 8; ++i) v.emplace_back(i);
+        v.reserve(32);
+        const int allocs = Alloc::allocations;
+        ConstMember lvalue(100);
+        v.insert(v.begin(), ConstMember(99)); v.insert(v.begin() + 4, lvalue); v.insert(v.end(), ConstMember(101));
+        v.erase(v.begin() + 2); v.erase(v.begin() + 5, v.begin() + 7);
+        CHECK(Alloc::allocations == allocs); CHECK(v.capacity() == 32);
+        CHECK(check_contents(v, {99, 0, 2, 100, 3, 6, 7, 101}));
+        std::cout << "  Heap insert/erase with spare capacity allocates nothing: OK\n";
+
+        v.insert(v.begin() + 1, v[5]); // Self-aliasing lvalue on heap
+        CHECK(check_contents(v, {99, 6, 0, 2, 100, 3, 6, 7, 101}));
+        ConstMember::copy_throw_countdown = 1;
+        try { v.insert(v.begin() + 2, lvalue); std::cerr << "  ❌ FAIL: Copy exception not thrown!\n"; return false; }
+        catch (const std::runtime_error&) {}
+        CHECK(check_contents(v, {99, 6, 0, 2, 100, 3, 6, 7, 101}));
+        std::cout << "  Heap insert rolls back on throwing copy (strong guarantee): OK\n";
+    }
+    CHECK(ConstMember::live == 0);
+    std::cout << "✅ PASS: Non-assignable insert/erase relocate in place.\n"; return true;
+}
+
+// ============================================================================
+// TEST 17: memory_usage() Accounting
+// ============================================================================
+bool test_memory_usage() {
+    std::cout << "\n--- TEST 17: memory_usage() Accounting ---\n";
+    using IntVec = lloyal::InlinedVector<int, 4>;
+    IntVec ints = {1, 2, 3};
+    CHECK(ints.memory_usage() == sizeof(IntVec));
+    for (int i = 0; i < 10; ++i) ints.push_back(i);
+    CHECK(ints.memory_usage() == sizeof(IntVec) + ints.capacity() * sizeof(int));
+    ints.resize(2); ints.shrink_to_fit();
+    CHECK(ints.memory_usage() == sizeof(IntVec));
+    std::cout << "  Trivial T (inline, heap, back to inline): OK\n";
+
+    using StrVec = lloyal::InlinedVector<std::string, 2>;
+    StrVec strs; strs.emplace_back("sso"); strs.emplace_back(200, 'x');
+    const std::size_t long_bytes = (strs[1].capacity() + 1) * sizeof(char);
+    CHECK(strs.memory_usage() == sizeof(StrVec) + long_bytes);
+    std::cout << "  Strings (SSO vs heap): OK\n";
+
+    using Nested = lloyal::InlinedVector<IntVec, 2>;
+    Nested nested; nested.emplace_back(); nested.emplace_back();
+    for (int i = 0; i < 10; ++i) nested[1].push_back(i);
+    CHECK(nested.memory_usage() == sizeof(Nested) + nested[1].capacity() * sizeof(int));
+    nested.emplace_back();
+    CHECK(nested.memory_usage() == sizeof(Nested) + nested.capacity() * sizeof(IntVec) + nested[1].capacity() * sizeof(int));
+    std::cout << "  Nested InlinedVector (inline and spilled outer): OK\n";
+
+    using BitsVec = lloyal::InlinedVector<std::vector<bool>, 2>;
+    BitsVec bits; bits.emplace_back(1000, true); bits.emplace_back();
+    CHECK(bits[0].capacity() >= 1000);
+    CHECK(bits.memory_usage() == sizeof(BitsVec) + (bits[0].capacity() + CHAR_BIT - 1) / CHAR_BIT);
+    std::cout << "  std::vector<bool> counts packed bytes: OK\n";
+
+    std::cout << "✅ PASS: memory_usage() reports owned bytes.\n"; return true;
+}
+
+// ============================================================================
+// TEST 18: Allocation Budget (Differential Random Sequences)
+// ============================================================================
+inline int budget_key(int v) { return v; }
+inline int budget_key(const ConstMember& v) { return v.id; }
+
+template<typename VecType>
+bool budget_matches(const VecType& vec, const std::vector<int>& shadow) {
+    if (vec.size() != shadow.size()) return false;
+    for (size_t i = 0; i < shadow.size(); ++i) if (budget_key(vec[i]) != shadow[i]) return false;
+    return true;
+}
+
+// Runs `ops` random operations on a pair of vectors, mirrored on std::vector<int> shadows.
+// inline_only: growth is clamped to N and the whole sequence must allocate nothing.
+// Otherwise: every operation allocates at most once, and only when it must grow
+// (or shrink/copy onto the heap); insert, erase, swap, clear and pop_back never allocate.
+template<typename T, size_t N>
+bool run_allocation_budget(std::mt19937& rng, int ops, bool inline_only) {
+    using Alloc = TestAllocator<T>;
+    using VecType = lloyal::InlinedVector<T, N, Alloc>;
+    VecType a, b; std::vector<int> sa, sb;
+    const int allocs_at_start = Alloc::allocations;
+    for (int step = 0; step < ops; ++step) {
+        const int op = static_cast<int>(rng() % 11);
+        const int v = static_cast<int>(rng() % 1000);
+        const size_t old_size = a.size(), old_cap = a.capacity();
+        const bool full = inline_only && old_size >= N;
+        int budget = 0;
+        const int before = Alloc::allocations;
+        switch (full && (op <= 2 || op == 10) ? 3 : op) {
+            case 0: case 1: budget = old_size < old_cap ? 0 : 1; a.push_back(T(v)); sa.push_back(v); break;
+            case 2: { size_t pos = old_size ? rng() % (old_size + 1) : 0; budget = old_size < old_cap ? 0 : 1;
+                      a.insert(a.begin() + pos, T(v)); sa.insert(sa.begin() + pos, v); break; }
+            case 3: if (old_size) { a.pop_back(); sa.pop_back(); } break;
+            case 4: if (old_size) { size_t pos = rng() % old_size; a.erase(a.begin() + pos); sa.erase(sa.begin() + pos); } break;
+            case 5: if (old_size) { size_t f = rng() % old_size, l = f + rng() % (old_size - f + 1);
+                      a.erase(a.begin() + f, a.begin() + l); sa.erase(sa.begin() + f, sa.begin() + l); } break;
+            case 6: if (rng() % 4 == 0) { a.clear(); sa.clear(); } break;
+            case 7: { size_t req = inline_only ? rng() % (N + 1) : rng() % (3 * N); budget = req <= old_cap ? 0 : 1; a.reserve(req); break; }
+            case 8: budget = (old_cap > N && old_size > N) ? 1 : 0; a.shrink_to_fit(); break;
+            case 9: a.swap(b); std::swap(sa, sb); break;
+            case 10: budget = b.size() > N ? 1 : 0; a = b; sa = sb; break;
+        }
+        const int spent = Alloc::allocations - before;
+        if (spent > budget) { std::cerr << "  Op " << op << " at step " << step << " allocated " << spent << " (budget " << budget << ")\n"; return false; }
+        if (!budget_matches(a, sa) || !budget_matches(b, sb)) { std::cerr << "  Shadow mismatch after op " << op << " at step " << step << "\n"; return false; }
+    }
+    if (inline_only && Alloc::allocations != allocs_at_start) { std::cerr << "  Inline-only sequence allocated\n"; return false; }
+    return true;
+}
+
+bool test_allocation_budget() {
+    std::cout << "\n--- TEST 18: Allocation Budget (Differential) ---\n";
+    std::mt19937 rng(0x5eed);
+    ConstMember::reset();
+    for (int seq = 0; seq < 200; ++seq) {
+        CHECK((run_allocation_budget<int, 8>(rng, 200, true)));
+        CHECK((run_allocation_budget<ConstMember, 8>(rng, 200, true)));
+    }
+    std::cout << "  Inline-only sequences: zero allocations: OK\n";
+    for (int seq = 0; seq < 200; ++seq) {
+        CHECK((run_allocation_budget<int, 8>(rng, 200, false)));
+        CHECK((run_allocation_budget<ConstMember, 8>(rng, 200, false)));
+    }
+    std::cout << "  Heap sequences: at most one allocation per growth: OK\n";
+    CHECK(ConstMember::live == 0);
+    std::cout << "✅ PASS: Allocation budget holds for random operation sequences.\n"; return true;
+}
+
+// ============================================================================
+// TEST 19: Align Parameter (Inline and Heap Storage)
+// ============================================================================
+template<typename VecType>
+bool is_aligned_to(const VecType& vec) {
+    return reinterpret_cast<std::uintptr_t>(vec.data()) % VecType::alignment == 0;
+}
+
+bool test_alignment() {
+    std::cout << "\n--- TEST 19: Align Parameter ---\n";
+    static_assert(lloyal::InlinedVector<float, 16>::alignment == alignof(float));
+    using Aligned = lloyal::InlinedVector<float, 16, std::allocator<float>, 64>;
+    static_assert(Aligned::alignment == 64);
+    static_assert(alignof(Aligned) >= 64);
+
+    Aligned v;
+    CHECK(is_aligned_to(v)); // Empty sentinel
+    for (int i = 0; i < 10; ++i) v.push_back(float(i));
+    CHECK(is_aligned_to(v)); // Inline
+    for (int i = 10; i < 100; ++i) { v.push_back(float(i)); CHECK(is_aligned_to(v)); }
+    Aligned copy(v); CHECK(is_aligned_to(copy)); CHECK(copy == v);
+    v.resize(8); v.shrink_to_fit(); CHECK(is_aligned_to(v)); CHECK(v.capacity() == 16);
+    v.reserve(1000); CHECK(is_aligned_to(v)); CHECK(v[7] == 7.0f);
+    // memory_usage() counts the adaptor's slack and back-pointer on the heap block
+    static_assert(lloyal::aligned_allocator_adaptor<std::allocator<float>, 64>::overhead == 63 + sizeof(void*));
+    CHECK(v.memory_usage() == sizeof(v) + v.capacity() * sizeof(float) + 63 + sizeof(void*));
+    v.resize(4); v.shrink_to_fit(); CHECK(v.capacity() == 16 && v.memory_usage() == sizeof(v));
+    v.reserve(1000);
+    std::cout << "  float, Align=64: inline, heap growth, copy, shrink, reserve, memory_usage: OK\n";
+
+    // std::allocator already aligns to __STDCPP_DEFAULT_NEW_ALIGNMENT__: no adaptor, no overhead
+    {
+        lloyal::InlinedVector<float, 4, std::allocator<float>, __STDCPP_DEFAULT_NEW_ALIGNMENT__> d;
+        for (int i = 0; i < 50; ++i) { d.push_back(float(i)); CHECK(is_aligned_to(d)); }
+        CHECK(d.memory_usage() == sizeof(d) + d.capacity() * sizeof(float));
+    }
+    std::cout << "  float, std::allocator, Align=__STDCPP_DEFAULT_NEW_ALIGNMENT__: plain heap blocks: OK\n";
+
+    // Stateful allocator: adaptor forwards construct/destroy and balances allocations
+    TestAllocator<std::byte>::reset(); MyType::reset();
+    {
+        using Vec = lloyal::InlinedVector<MyType, 2, TestAllocator<MyType>, 32>;
+        Vec a(TestAllocator<MyType>(7));
+        for (int i = 0; i < 20; ++i) { a.emplace_back(i); CHECK(is_aligned_to(a)); }
+        a.insert(a.begin(), MyType(-1)); a.erase(a.begin() + 3);
+        CHECK(a.get_allocator().id == 7); CHECK(is_aligned_to(a));
+        CHECK(a.front().value == -1 && a[3].value == 3);
+    }
+    CHECK(TestAllocator<std::byte>::allocations > 0);
+    CHECK(TestAllocator<std::byte>::allocations == TestAllocator<std::byte>::deallocations);
+    CHECK(MyType::constructions == MyType::destructions);
+    std::cout << "  MyType, TestAllocator, Align=32: balanced: OK\n";
+
+    // PMR: over-aligned blocks carved from a monotonic resource
+    std::pmr::monotonic_buffer_resource pool;
+    lloyal::InlinedVector<double, 4, std::pmr::polymorphic_allocator<double>, 64> pv(&pool);
+    for (int i = 0; i < 50; ++i) { pv.push_back(i); CHECK(is_aligned_to(pv)); }
+    std::cout << "  pmr, Align=64: OK\n";
+
+    std::cout << "✅ PASS: data() honors Align in inline and heap modes.\n"; return true;
+}
+
+// ============================================================================
+// TEST 20: lloyal::sort (Sorting Networks + Fallback)
+// ============================================================================
+bool test_sort_network() {
+    std::cout << "\n--- TEST 20: lloyal::sort ---\n";
+    // 0-1 principle: a network sorts every input iff it sorts every 0/1 input
+    for (size_t n = 0; n <= 16; ++n) {
+        for (uint32_t bits = 0; bits < (1u << n); ++bits) {
+            lloyal::InlinedVector<int, 16> v; int ones = 0;
+            for (size_t i = 0; i < n; ++i) { v.push_back((bits >> i) & 1); ones += v.back(); }
+            lloyal::sort(v);
+            CHECK(std::is_sorted(v.begin(), v.end()));
+            CHECK(std::accumulate(v.begin(), v.end(), 0) == ones);
+        }
+    }
+    std::cout << "  Networks for n <= 16 (exhaustive 0/1 inputs): OK\n";
+
+    std::mt19937 rng(42);
+    for (size_t n = 0; n <= 80; ++n) {
+        lloyal::InlinedVector<float, 64> v; std::vector<float> expected;
+        for (size_t i = 0; i < n; ++i) { const float f = float(rng() % 50) - 25.0f; v.push_back(f); expected.push_back(f); }
+        std::sort(expected.begin(), expected.end());
+        lloyal::sort(v);
+        CHECK(check_contents(v, expected));
+    }
+    std::cout << "  float, N=64: networks up to 64, std::sort beyond: OK\n";
+
+    lloyal::InlinedVector<std::string, 4> strs = {"d", "b", "c", "a"};
+    lloyal::sort(strs);
+    CHECK(check_contents(strs, std::vector<std::string>{"a", "b", "c", "d"}));
+    std::cout << "  Non-arithmetic T uses std::sort: OK\n";
+
+    std::cout << "✅ PASS: lloyal::sort matches std::sort.\n"; return true;
+}
+
+// ============================================================================
+// TEST 21: Relocation-Based sort / stable_sort / rotate (Non-Assignable)
+// ============================================================================
+template<typename VecType>
+std::vector<int> ids_of(const VecType& vec) {
+    std::vector<int> ids; for (const auto& e : vec) ids.push_back(e.id); return ids;
+}
+
+template<size_t N>
+bool check_relocation_algorithms(std::mt19937& rng, size_t n) {
+    using Alloc = TestAllocator<ConstMember>;
+    using VecType = lloyal::InlinedVector<ConstMember, N, Alloc>;
+    VecType v; std::vector<int> shadow;
+    for (size_t i = 0; i < n; ++i) { const int id = int(rng() % 1000) * 100 + int(i); v.emplace_back(id); shadow.push_back(id); }
+    const int allocs = Alloc::allocations;
+
+    auto by_bucket = [](int a, int b) { return a % 7 < b % 7; };
+    lloyal::stable_sort(v, [&](const ConstMember& a, const ConstMember& b) { return by_bucket(a.id, b.id); });
+    std::stable_sort(shadow.begin(), shadow.end(), by_bucket);
+    CHECK(ids_of(v) == shadow);
+
+    lloyal::sort(v, [](const ConstMember& a, const ConstMember& b) { return a.id < b.id; });
+    std::sort(shadow.begin(), shadow.end());
+    CHECK(ids_of(v) == shadow);
+
+    for (size_t k = 0; k <= n; k += (n / 5) + 1) {
+        auto it = lloyal::rotate(v, v.cbegin() + k);
+        auto sit = std::rotate(shadow.begin(), shadow.begin() + k, shadow.end());
+        CHECK(it - v.begin() == sit - shadow.begin());
+        CHECK(ids_of(v) == shadow);
+    }
+    for (size_t i = 0; i < v.size(); ++i) CHECK(v[i].payload == "payload-that-defeats-sso-" + std::to_string(v[i].id));
+    CHECK(Alloc::allocations == allocs); // Elements never leave their buffer
+    return true;
+}
+
+bool test_relocation_algorithms() {
+    std::cout << "\n--- TEST 21: Relocation sort/stable_sort/rotate ---\n";
+    ConstMember::reset();
+    std::mt19937 rng(7);
+    for (size_t n : {0, 1, 2, 5, 8}) CHECK(check_relocation_algorithms<8>(rng, n));
+    std::cout << "  Inline (N=8): OK\n";
+    for (size_t n : {9, 17, 64, 300}) CHECK(check_relocation_algorithms<8>(rng, n));
+    std::cout << "  Heap (n > N, incl. scratch index buffer): OK\n";
+    CHECK(ConstMember::live == 0);
+
+    // A throwing comparator leaves the elements in their original order
+    lloyal::InlinedVector<ConstMember, 8> v;
+    for (int i = 5; i > 0; --i) v.emplace_back(i);
+    int calls = 0;
+    try {
+        lloyal::sort(v, [&](const ConstMember& a, const ConstMember& b) {
+            if (++calls == 4) throw std::runtime_error("comparator");
+            return a.id < b.id;
+        });
+        CHECK(false);
+    } catch (const std::runtime_error&) {}
+    CHECK((ids_of(v) == std::vector<int>{5, 4, 3, 2, 1}));
+    std::cout << "  Strong guarantee on throwing comparator: OK\n";
+
+    // Assignable types still go through std algorithms
+    lloyal::InlinedVector<int, 4> ints = {1, 2, 3, 4, 5, 6};
+    CHECK(*lloyal::rotate(ints, ints.cbegin() + 2) == 1);
+    CHECK(check_contents(ints, {3, 4, 5, 6, 1, 2}));
+    lloyal::stable_sort(ints); CHECK(check_contents(ints, {1, 2, 3, 4, 5, 6}));
+
+    std::cout << "✅ PASS: Non-assignable types sort and rotate by relocation.\n"; return true;
+}
+
+// ============================================================================
+// TEST 22: CompressedInlinedVector (Differential vs std::vector)
+// ============================================================================
+template<typename T, size_t Bytes>
+bool same_values(const lloyal::CompressedInlinedVector<T, Bytes>& c, const std::vector<T>& ref) {
+    if (c.size() != ref.size()) return false;
+    if (!std::equal(c.begin(), c.end(), ref.begin(), ref.end())) return false;
+    std::vector<T> out(c.size());
+    c.unpack(out.data());
+    if (out != ref) return false;
+    for (size_t i = 0; i < ref.size(); i += 7) if (c[i] != ref[i]) return false;
+    return ref.empty() || c.back() == ref.back();
+}
+
+bool test_compressed() {
+    std::cout << "\n--- TEST 22: CompressedInlinedVector ---\n";
+    using lloyal::compression;
+
+    // Packed: widens in place, then spills once the widest value no longer fits
+    lloyal::CompressedInlinedVector<uint32_t, 64> p;
+    std::vector<uint32_t> ref;
+    for (uint32_t v : {0u, 1u, 3u, 2u}) { p.push_back(v); ref.push_back(v); }
+    CHECK(p.is_inline() && p.bit_width() == 2 && same_values(p, ref));
+    for (uint32_t i = 0; i < 20; ++i) { p.push_back(i % 7); ref.push_back(i % 7); }
+    CHECK(p.is_inline() && p.bit_width() == 3 && same_values(p, ref));
+    p.push_back(1000); ref.push_back(1000);
+    CHECK(p.is_inline() && p.bit_width() == 10 && same_values(p, ref));
+    std::cout << "  Packed widening (2 -> 3 -> 10 bits): OK\n";
+    for (uint32_t v : {5u, 0xFFFFFFFFu, 9u}) { p.push_back(v); ref.push_back(v); }
+    CHECK(!p.is_inline() && p.bit_width() == 0 && same_values(p, ref));
+    std::cout << "  Packed spill to heap: OK\n";
+
+    // Differential random check across widths and both modes
+    std::mt19937_64 rng(22);
+    for (int round = 0; round < 200; ++round) {
+        const unsigned bits = 1 + rng() % 64;
+        const auto mode = (round % 2) ? compression::sorted_delta : compression::packed;
+        lloyal::CompressedInlinedVector<uint64_t, 32> c(mode);
+        std::vector<uint64_t> r;
+        uint64_t acc = 0;
+        const size_t n = rng() % 80;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t v = rng() & (bits == 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1);
+            if (mode == compression::sorted_delta) {
+                v = (rng() % 16 == 0) ? v : acc + (v >> 40);  // mostly sorted; an occasional drop spills
+                acc = v;
+            }
+            c.push_back(v); r.push_back(v);
+            if (!same_values(c, r)) { std::cerr << "round " << round << " i " << i << "\n"; return false; }
+        }
+    }
+    std::cout << "  Random differential (packed + sorted_delta): OK\n";
+
+    // Sorted delta: posting list of small gaps stays inline far beyond 64 / sizeof(T)
+    lloyal::CompressedInlinedVector<uint32_t, 64> post(compression::sorted_delta);
+    ref.clear();
+    for (uint32_t i = 0, id = 100000; i < 60; ++i, id += 1 + i % 5) { post.push_back(id); ref.push_back(id); }
+    CHECK(post.is_inline() && same_values(post, ref));
+    post.push_back(5); ref.push_back(5);  // out of order
+    CHECK(!post.is_inline() && same_values(post, ref));
+    std::cout << "  Sorted delta posting list + unsorted spill: OK\n";
+
+    // pop_back + shrink_to_fit re-compress inline once the contents fit again
+    for (auto mode : {compression::packed, compression::sorted_delta}) {
+        lloyal::CompressedInlinedVector<uint32_t, 16> c(mode);
+        ref.clear();
+        for (uint32_t i = 0; i < 40; ++i) { c.push_back(i * 3); ref.push_back(i * 3); }
+        CHECK(!c.is_inline() && c.memory_usage() > sizeof(c));
+        auto copy = c;
+        CHECK(copy == c);
+        while (c.size() > 10) { c.pop_back(); ref.pop_back(); }
+        CHECK(copy != c);
+        c.shrink_to_fit();
+        CHECK(c.is_inline() && c.memory_usage() == sizeof(c) && same_values(c, ref));
+        c.pop_back(); ref.pop_back(); c.push_back(7); ref.push_back(7);
+        CHECK(c.is_inline() == (mode == compression::packed) && same_values(c, ref));
+        c.clear(); CHECK(c.is_inline() && c.empty());
+    }
+    std::cout << "  clear / shrink_to_fit / memory_usage: OK\n";
+
+    std::cout << "✅ PASS: CompressedInlinedVector matches std::vector in both modes.\n"; return true;
+}
+
+// ============================================================================
+// TEST 23: InlinedVectorRef (Caller-Provided Buffer)
+// ============================================================================
+// Random ops against a std::vector<int> shadow; element ids are checked after every step
+template<typename T>
+bool run_ref_differential(std::mt19937& rng, size_t buffer_cap) {
+    using Alloc = TestAllocator<T>;
+    std::vector<std::byte> arena((buffer_cap + 1) * sizeof(T) + alignof(T));
+    void* slice = arena.data(); std::size_t space = arena.size();
+    slice = std::align(alignof(T), buffer_cap * sizeof(T), slice, space); // Slice of a scratch arena
+    lloyal::InlinedVectorRef<T, Alloc> v(slice, buffer_cap);
+    std::vector<int> shadow;
+    for (int step = 0; step < 300; ++step) {
+        const int val = static_cast<int>(rng() % 1000);
+        const size_t n = shadow.size();
+        switch (rng() % 9) {
+            case 0: case 1: v.emplace_back(val); shadow.push_back(val); break;
+            case 2: { size_t pos = rng() % (n + 1); v.insert(v.begin() + pos, T(val)); shadow.insert(shadow.begin() + pos, val); break; }
+            case 3: if (n) { size_t pos = rng() % n; v.erase(v.begin() + pos); shadow.erase(shadow.begin() + pos); } break;
+            case 4: if (n) { size_t f = rng() % n, l = f + rng() % (n - f + 1);
+                      v.erase(v.begin() + f, v.begin() + l); shadow.erase(shadow.begin() + f, shadow.begin() + l); } break;
+            case 5: if (n) { v.pop_back(); shadow.pop_back(); } break;
+            case 6: v.shrink_to_fit();
+                    if (v.is_inline() != (shadow.size() <= buffer_cap)) return false;
+                    if (v.is_inline() && v.data() != slice) return false;
+                    break;
+            case 7: { size_t pos = rng() % (n + 1), k = rng() % 4;
+                      v.insert(v.begin() + pos, k, T(val)); shadow.insert(shadow.begin() + pos, k, val); break; }
+            case 8: { size_t pos = rng() % (n + 1), k = rng() % 5;
+                      std::vector<T> src; std::vector<int> ids;
+                      for (size_t j = 0; j < k; ++j) { src.emplace_back(val + static_cast<int>(j)); ids.push_back(val + static_cast<int>(j)); }
+                      v.insert(v.begin() + pos, src.begin(), src.end()); shadow.insert(shadow.begin() + pos, ids.begin(), ids.end()); break; }
+        }
+        if (v.size() != shadow.size()) return false;
+        for (size_t i = 0; i < shadow.size(); ++i) if (budget_key(v[i]) != shadow[i]) return false;
+    }
+    return true;
+}
+
+bool test_inlined_vector_ref() {
+    std::cout << "\n--- TEST 23: InlinedVectorRef ---\n";
+    // Stack buffer: stays inline, spills, then returns on shrink_to_fit
+    TestAllocator<MyType>::reset();
+    {
+        lloyal::inline_storage<MyType, 4> storage;
+        lloyal::InlinedVectorRef<MyType, TestAllocator<MyType>> v(storage);
+        CHECK(v.inline_capacity() == 4 && v.capacity() == 4 && v.is_inline());
+        for (int i = 0; i < 4; ++i) v.emplace_back(i);
+        CHECK(v.is_inline() && static_cast<void*>(v.data()) == storage.bytes);
+        CHECK(TestAllocator<MyType>::allocations == 0);
+        CHECK(v.memory_usage() == sizeof(v));
+        v.emplace_back(4); v.insert(v.begin(), MyType(-1));
+        CHECK(!v.is_inline() && TestAllocator<MyType>::allocations == 1);
+        CHECK(v.memory_usage() == sizeof(v) + v.capacity() * sizeof(MyType));
+        CHECK(v.front().value == -1 && v.back().value == 4);
+        v.erase(v.begin(), v.begin() + 3);
+        v.shrink_to_fit();
+        CHECK(v.is_inline() && v.size() == 3 && v[0].value == 2 && v[2].value == 4);
+        CHECK(TestAllocator<MyType>::allocations == TestAllocator<MyType>::deallocations);
+        v.push_back(v[0]); // Aliasing push at capacity boundary
+        v.resize(6, v[1]); // Aliasing resize that spills
+        CHECK(v.size() == 6 && v[3].value == 2 && v[5].value == 3);
+    }
+    CHECK(TestAllocator<MyType>::allocations == TestAllocator<MyType>::deallocations);
+    std::cout << "  Stack buffer: inline, spill, shrink back to buffer: OK\n";
+
+    // Differential: runtime capacities, assignable and non-assignable T
+    std::mt19937 rng(63);
+    ConstMember::reset();
+    for (size_t cap : {0, 1, 3, 8, 33}) {
+        for (int round = 0; round < 10; ++round) {
+            CHECK(run_ref_differential<int>(rng, cap));
+            CHECK(run_ref_differential<ConstMember>(rng, cap));
+        }
+    }
+    CHECK(ConstMember::live == 0);
+    CHECK(TestAllocator<ConstMember>::allocations == TestAllocator<ConstMember>::deallocations);
+    std::cout << "  Random ops vs std::vector (cap 0..33, int + ConstMember): OK\n";
+
+    // Non-assignable T whose move may throw: insert/erase with spare room stay in the buffer
+    {
+        using Alloc = TestAllocator<ConstMoveMayThrow>;
+        Alloc::reset();
+        {
+            lloyal::inline_storage<ConstMoveMayThrow, 8> storage;
+            lloyal::InlinedVectorRef<ConstMoveMayThrow, Alloc> v(storage);
+            for (int i = 1; i <= 5; ++i) v.emplace_back(i * 10);
+            v.emplace(v.begin(), 0);
+            v.emplace(v.begin() + 3, 25);
+            v.erase(v.begin() + 1, v.begin() + 3);
+            CHECK(v.is_inline() && static_cast<void*>(v.data()) == storage.bytes && Alloc::allocations == 0);
+            const int expect[] = {0, 25, 30, 40, 50};
+            CHECK(v.size() == 5);
+            for (size_t i = 0; i < v.size(); ++i) CHECK(v[i].id == expect[i]);
+
+            ConstMoveMayThrow::throw_countdown = 3; // Fails while shifting the tail
+            bool threw = false;
+            try { v.emplace(v.begin() + 1, 5); } catch (const std::runtime_error&) { threw = true; }
+            ConstMoveMayThrow::throw_countdown = -1;
+            CHECK(threw && v.is_inline() && v.size() <= 5 && v[0].id == 0);
+            CHECK(ConstMoveMayThrow::live == static_cast<int>(v.size()));
+        }
+        CHECK(ConstMoveMayThrow::live == 0 && Alloc::allocations == 0);
+    }
+    std::cout << "  Throwing-move non-assignable T relocates in the buffer: OK\n";
+
+    // insert overloads, swap and ordering
+    {
+        lloyal::inline_storage<int, 6> sa, sb;
+        lloyal::InlinedVectorRef<int> a(sa), b(sb);
+        a.insert(a.end(), {1, 2, 6});
+        a.insert(a.begin() + 2, {3, 4, 5});
+        CHECK(a.size() == 6 && a.is_inline() && std::is_sorted(a.begin(), a.end()) && a.back() == 6);
+        a.insert(a.begin(), 2, a[5]); // Aliasing count insert that spills
+        CHECK(!a.is_inline() && a.size() == 8 && a[0] == 6 && a[1] == 6 && a[2] == 1);
+        std::istringstream in("7 8 9");
+        b.insert(b.begin(), std::istream_iterator<int>(in), std::istream_iterator<int>()); // Single pass
+        CHECK(b.size() == 3 && b[0] == 7 && b[2] == 9 && b.is_inline());
+
+        a.swap(b); // Heap <-> buffer
+        CHECK(a.size() == 3 && a[0] == 7 && a.is_inline() && a.data() == static_cast<void*>(sa.bytes));
+        CHECK(b.size() == 8 && b[0] == 6 && !b.is_inline());
+        b.erase(b.begin(), b.begin() + 4);
+        b.shrink_to_fit();
+        swap(a, b); // Both buffered
+        CHECK(a.size() == 4 && a[0] == 3 && a.data() == static_cast<void*>(sa.bytes));
+        CHECK(b.size() == 3 && b[2] == 9 && b.data() == static_cast<void*>(sb.bytes));
+
+        CHECK(b > a && a < b && a <= b && b >= a && a <= a && a >= a && !(a > a));
+    }
+    {
+        // Buffers of different capacities, non-swappable T
+        ConstMember::reset();
+        lloyal::inline_storage<ConstMember, 2> small;
+        lloyal::inline_storage<ConstMember, 8> large;
+        lloyal::InlinedVectorRef<ConstMember> s(small), l(large);
+        s.emplace_back(1);
+        for (int i = 10; i < 15; ++i) l.emplace_back(i);
+        s.swap(l); // l's 5 elements exceed s's buffer: they move through l's heap block
+        CHECK(s.size() == 5 && s[0].id == 10 && s[4].id == 14 && !s.is_inline());
+        CHECK(l.size() == 1 && l[0].id == 1 && l.is_inline() && l.data() == static_cast<void*>(large.bytes));
+        s.erase(s.begin() + 2, s.end());
+        s.shrink_to_fit();
+        s.swap(l); // Both buffered and fitting: swapped in place by relocation
+        CHECK(s.size() == 1 && s[0].id == 1 && s.data() == static_cast<void*>(small.bytes));
+        CHECK(l.size() == 2 && l[1].id == 11 && l.data() == static_cast<void*>(large.bytes));
+        s.insert(s.begin(), {ConstMember(0)});
+        CHECK(s.size() == 2 && s[0].id == 0 && s.is_inline());
+    }
+    CHECK(ConstMember::live == 0);
+    {
+        // Range insert of a throwing-move non-assignable T also stays in the buffer
+        lloyal::inline_storage<ConstMoveMayThrow, 8> storage;
+        lloyal::InlinedVectorRef<ConstMoveMayThrow> v(storage);
+        for (int i = 0; i < 3; ++i) v.emplace_back(i);
+        const int ids[] = {7, 8, 9};
+        v.insert(v.begin() + 1, std::begin(ids), std::end(ids));
+        CHECK(v.is_inline() && v.size() == 6 && v[0].id == 0 && v[1].id == 7 && v[3].id == 9 && v[5].id == 2);
+    }
+    CHECK(ConstMoveMayThrow::live == 0);
+    std::cout << "  insert(count/range/ilist), swap and ordering: OK\n";
+
+    // Assignment: copy into own buffer; move steals heap blocks only
+    lloyal::inline_storage<std::string, 2> sa, sb;
+    lloyal::InlinedVectorRef<std::string> a(sa), b(sb);
+    a.assign({"x", "y"});
+    b = a;
+    CHECK(b == a && b.is_inline() && static_cast<void*>(b.data()) == sb.bytes);
+    a.assign(5, std::string(40, 'z'));
+    const std::string* heap = a.data();
+    b = std::move(a);
+    CHECK(b.data() == heap && b.size() == 5 && a.empty() && a.is_inline());
+    a = std::move(b); // Steals back
+    CHECK(a.data() == heap && b.empty() && b.is_inline());
+    CHECK(a.at(4) == std::string(40, 'z'));
+    bool threw = false;
+    try { (void)a.at(5); } catch (const std::out_of_range&) { threw = true; }
+    CHECK(threw);
+    std::cout << "  Copy/move assignment (steal heap, keep buffers): OK\n";
+
+    // POCMA: the allocator propagates even when the source is still in its buffer
+    TestAllocator<MyType>::reset();
+    {
+        lloyal::inline_storage<MyType, 2> sc, sd;
+        lloyal::InlinedVectorRef<MyType, TestAllocator<MyType>> c(sc, TestAllocator<MyType>(1)), d(sd, TestAllocator<MyType>(2));
+        for (int i = 0; i < 5; ++i) c.emplace_back(i); // c on the heap of allocator 1
+        d.emplace_back(7);
+        c = std::move(d);
+        CHECK(c.get_allocator().id == 2 && c.size() == 1 && c[0].value == 7 && c.is_inline());
+        CHECK(TestAllocator<MyType>::allocations == TestAllocator<MyType>::deallocations); // Old heap block returned
+        for (int i = 0; i < 4; ++i) c.emplace_back(i); // Spills through allocator 2
+        CHECK(!c.is_inline() && c.get_allocator().id == 2);
+    }
+    CHECK(TestAllocator<MyType>::allocations == TestAllocator<MyType>::deallocations);
+    std::cout << "  Move assignment propagates the allocator from a buffered source: OK\n";
+
+    // pmr: the staged element of a middle emplace is built through the allocator
+    {
+        std::pmr::monotonic_buffer_resource pool;
+        std::pmr::memory_resource* prev = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+        bool ok = true;
+        try {
+            const char* big = "a string long enough to leave the small-string buffer";
+            lloyal::inline_storage<std::pmr::string, 4> sp;
+            lloyal::InlinedVectorRef<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>> p(sp, &pool);
+            p.emplace_back(big); p.emplace_back("tail");
+            p.emplace(p.begin(), big);
+            p.insert(p.begin() + 1, p[2]); // Aliased, still in the buffer
+            ok = p.is_inline() && p.size() == 4 && p[0] == big && p[1] == "tail" && p[3] == "tail" &&
+                 p[0].get_allocator().resource() == &pool;
+        } catch (const std::bad_alloc&) { ok = false; }
+        std::pmr::set_default_resource(prev);
+        CHECK(ok);
+    }
+    std::cout << "  pmr emplace in the buffer uses the container's resource: OK\n";
+
+    std::cout << "✅ PASS: InlinedVectorRef behaves like InlinedVector over a borrowed buffer.\n"; return true;
+}
+
+// ============================================================================
+// TEST 24: Wink-Out Allocators (Arena Teardown)
+// ============================================================================
+// Arena allocator: memory is reclaimed with the resource, deallocate is never needed
+template <typename T> struct WinkOutArena {
+    using value_type = T; using is_wink_out = std::true_type;
+    static inline std::atomic<int> deallocations{0}; static inline std::atomic<int> destroys{0};
+    std::pmr::memory_resource* res;
+    WinkOutArena(std::pmr::memory_resource* r) noexcept : res(r) {}
+    template <typename U> WinkOutArena(const WinkOutArena<U>& o) noexcept : res(o.res) {}
+    T* allocate(std::size_t n) { return static_cast<T*>(res->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T*, std::size_t) noexcept { deallocations++; }
+    template <class U> void destroy(U* p) { destroys++; p->~U(); }
+    friend bool operator==(const WinkOutArena& a, const WinkOutArena& b) { return a.res == b.res; }
+    friend bool operator!=(const WinkOutArena& a, const WinkOutArena& b) { return a.res != b.res; }
+    static void reset() { deallocations = 0; destroys = 0; }
+};
+
+template<typename VecType>
+bool check_wink_out_teardown(std::pmr::memory_resource* arena, int n, int expected_destroys) {
+    using Alloc = typename VecType::allocator_type;
+    Alloc::reset();
+    std::optional<VecType> v(std::in_place, Alloc(arena));
+    for (int i = 0; i < n; ++i) {
+        if constexpr (std::is_same_v<typename VecType::value_type, std::string>) v->push_back(std::string(30, char('a' + i % 26)));
+        else v->push_back(i);
+    }
+    VecType copy(*v);
+    copy.erase(copy.begin());
+    CHECK(copy.size() == static_cast<size_t>(n - 1));
+    const int destroys_before = Alloc::destroys;
+    v.reset();
+    CHECK(Alloc::destroys - destroys_before == expected_destroys);
+    CHECK(Alloc::deallocations == 0);
+    return true;
+}
+
+bool test_wink_out() {
+    std::cout << "\n--- TEST 24: Wink-Out Allocators ---\n";
+    static_assert(lloyal::is_wink_out_allocator_v<WinkOutArena<int>>);
+    static_assert(!lloyal::is_wink_out_allocator_v<std::allocator<int>>);
+    static_assert(!lloyal::is_wink_out_allocator_v<std::pmr::polymorphic_allocator<int>>);
+    std::pmr::monotonic_buffer_resource arena;
+
+    CHECK((check_wink_out_teardown<lloyal::InlinedVector<int, 4, WinkOutArena<int>>>(&arena, 3, 0)));
+    CHECK((check_wink_out_teardown<lloyal::InlinedVector<int, 4, WinkOutArena<int>>>(&arena, 100, 0)));
+    CHECK((check_wink_out_teardown<lloyal::InlinedVector<int, 4, WinkOutArena<int>, 64>>(&arena, 100, 0)));
+    std::cout << "  Trivial T: no destroy, no deallocate (inline, heap, Align=64): OK\n";
+
+    using StrVec = lloyal::InlinedVector<std::string, 2, WinkOutArena<std::string>>;
+    CHECK((check_wink_out_teardown<StrVec>(&arena, 2, 2)));
+    CHECK((check_wink_out_teardown<StrVec>(&arena, 50, 50)));
+    std::cout << "  Non-trivial T: elements destroyed, storage never deallocated: OK\n";
+
+    WinkOutArena<int>::reset();
+    {
+        lloyal::inline_storage<int, 4> buf;
+        lloyal::InlinedVectorRef<int, WinkOutArena<int>> r(buf, WinkOutArena<int>(&arena));
+        for (int i = 0; i < 40; ++i) r.push_back(i);
+        r.resize(3); r.shrink_to_fit();
+        CHECK(r.is_inline() && r[2] == 2);
+        for (int i = 0; i < 40; ++i) r.push_back(i);
+    }
+    CHECK(WinkOutArena<int>::deallocations == 0);
+    std::cout << "  InlinedVectorRef: growth and shrink never deallocate: OK\n";
+
+    std::cout << "✅ PASS: Wink-out allocators tear down without per-element or per-block work.\n"; return true;
+}
+
+// ============================================================================
+// TEST 25: PolyInlinedVector (Heterogeneous Inline Objects)
+// ============================================================================
+struct Handler {
+    static inline int live = 0;
+    Handler() { ++live; }
+    Handler(const Handler&) noexcept { ++live; }
+    ~Handler() { --live; } // Non-virtual: elements are destroyed as their own type
+    virtual int run(int x) const = 0;
+};
+struct AddHandler : Handler {
+    int k;
+    explicit AddHandler(int k_) : k(k_) {}
+    int run(int x) const override { return x + k; }
+};
+struct NamedHandler : Handler {
+    std::string name; double scale;
+    NamedHandler(std::string n, double s) : name(std::move(n)), scale(s) {}
+    NamedHandler(NamedHandler&&) noexcept = default;
+    int run(int x) const override { return static_cast<int>(x * scale) + static_cast<int>(name.size()); }
+};
+struct Tagged { long long tag = 7; virtual ~Tagged() = default; };
+struct MixinHandler : Tagged, Handler { // Handler is not the first base: non-zero base offset
+    int mul;
+    explicit MixinHandler(int m) : mul(m) {}
+    int run(int x) const override { return x * mul + static_cast<int>(tag); }
+};
+struct ThrowingHandler : Handler {
+    explicit ThrowingHandler(bool t) { if (t) throw std::runtime_error("ThrowingHandler"); }
+    int run(int x) const override { return x; }
+};
+
+template<size_t Bytes>
+std::vector<int> run_all(const lloyal::PolyInlinedVector<Handler, Bytes>& v, int x) {
+    std::vector<int> out;
+    for (const Handler& h : v) out.push_back(h.run(x));
+    return out;
+}
+
+bool test_poly_inlined_vector() {
+    std::cout << "\n--- TEST 25: PolyInlinedVector ---\n";
+    Handler::live = 0;
+    {
+        lloyal::PolyInlinedVector<Handler, 128> v;
+        v.emplace_back<AddHandler>(1);
+        v.emplace_back<NamedHandler>("payload-that-defeats-sso", 2.0);
+        v.push_back(MixinHandler(3));
+        CHECK(v.size() == 3 && v.is_inline());
+        CHECK((run_all(v, 10) == std::vector<int>{11, 44, 37}));
+        std::cout << "  Mixed sizes inline, virtual dispatch, non-zero base offset: OK\n";
+
+        for (int i = 0; i < 20; ++i) v.emplace_back<AddHandler>(i);
+        CHECK(!v.is_inline() && v.size() == 23);
+        CHECK((run_all(v, 10)[1] == 44 && run_all(v, 10)[2] == 37 && v.back().run(0) == 19));
+        std::cout << "  Spill to heap region with relocation: OK\n";
+
+        // Strong guarantee: a throwing constructor during growth leaves the region untouched
+        const size_t cap = v.capacity_bytes();
+        for (size_t i = 0; v.bytes_used() + sizeof(ThrowingHandler) <= cap; ++i) v.emplace_back<AddHandler>(0);
+        const auto before = run_all(v, 1);
+        try { v.emplace_back<ThrowingHandler>(true); CHECK(false); } catch (const std::runtime_error&) {}
+        CHECK(run_all(v, 1) == before && v.capacity_bytes() == cap);
+        std::cout << "  Strong guarantee on throwing spill: OK\n";
+
+        while (v.size() > 3) v.pop_back();
+        v.erase(v.begin()); // Later objects relocate down (or stay, if they would overlap)
+        CHECK((run_all(v, 10) == std::vector<int>{44, 37}));
+        v.shrink_to_fit();
+        CHECK(v.is_inline() && (run_all(v, 10) == std::vector<int>{44, 37}));
+        std::cout << "  pop_back / erase / shrink_to_fit back inline: OK\n";
+
+        lloyal::PolyInlinedVector<Handler, 128> moved(std::move(v));
+        CHECK(v.empty() && moved.is_inline() && (run_all(moved, 10) == std::vector<int>{44, 37}));
+        for (int i = 0; i < 20; ++i) moved.emplace_back<AddHandler>(i);
+        v = std::move(moved);
+        CHECK(moved.empty() && !v.is_inline() && v.size() == 22 && v[2].run(0) == 0);
+        std::cout << "  Move construction (inline) and assignment (heap steal): OK\n";
+        CHECK(Handler::live == 22);
+    }
+    CHECK(Handler::live == 0);
+
+    // Random erase/push against a shadow of expected results
+    std::mt19937 rng(65);
+    lloyal::PolyInlinedVector<Handler, 64> r;
+    std::vector<int> shadow;
+    for (int step = 0; step < 500; ++step) {
+        const int k = static_cast<int>(rng() % 100);
+        switch (rng() % 4) {
+            case 0: r.emplace_back<AddHandler>(k); shadow.push_back(1 + k); break;
+            case 1: r.emplace_back<NamedHandler>(std::string(k % 40, 'n'), 1.0); shadow.push_back(1 + k % 40); break;
+            case 2: if (!shadow.empty()) { size_t i = rng() % shadow.size(); r.erase(r.begin() + i); shadow.erase(shadow.begin() + i); } break;
+            case 3: if (rng() % 8 == 0) r.shrink_to_fit(); break;
+        }
+        if (run_all(r, 1) != shadow) { std::cerr << "  Mismatch at step " << step << "\n"; return false; }
+    }
+    r.clear(); CHECK(Handler::live == 0 && r.bytes_used() == 0);
+    std::cout << "  Random push/erase/shrink vs shadow: OK\n";
+
+    std::cout << "✅ PASS: PolyInlinedVector stores heterogeneous objects without per-element allocation.\n"; return true;
+}
+
+// ============================================================================
+// TEST 26: InlinedByteBuffer (Zero-Copy I/O Buffer)
+// ============================================================================
+struct FakeIovec { void* iov_base; size_t iov_len; }; // Layout of POSIX struct iovec
+
+bool test_inlined_byte_buffer() {
+    std::cout << "\n--- TEST 26: InlinedByteBuffer ---\n";
+    auto bytes_eq = [](const lloyal::InlinedByteBuffer<64>& b, const std::string& s) {
+        return b.size() == s.size() && std::memcmp(b.data(), s.data(), s.size()) == 0;
+    };
+
+    lloyal::InlinedByteBuffer<64> b;
+    std::byte* p = b.prepare(16);
+    CHECK(b.is_inline() && b.spare() >= 16 && b.empty());
+    std::memcpy(p, "hello world", 11);
+    b.commit(11);
+    CHECK(bytes_eq(b, "hello world"));
+    std::cout << "  prepare/commit into inline spare capacity: OK\n";
+
+    const std::byte* before = b.data();
+    b.consume(6);
+    CHECK(bytes_eq(b, "world") && b.data() == before + 6); // Cursor moves, bytes stay
+    b.append("!!", 2);
+    CHECK(bytes_eq(b, "world!!"));
+    std::cout << "  consume advances the read cursor without shifting: OK\n";
+
+    // 6 consumed + 7 readable leave 51 spare; asking for 55 fits only after compaction
+    b.prepare(55);
+    CHECK(b.is_inline() && b.capacity() == 64 && bytes_eq(b, "world!!") && b.spare() == 57);
+    std::cout << "  prepare compacts before growing: OK\n";
+
+    std::string big(100, 'x');
+    b.append(big.data(), big.size());
+    CHECK(!b.is_inline() && bytes_eq(b, "world!!" + big));
+    CHECK(b.memory_usage() == sizeof(b) + b.capacity());
+    b.consume(b.size());
+    CHECK(b.empty() && b.spare() == b.capacity()); // Fully drained: cursors rewind
+    b.append("tail", 4);
+    b.shrink_to_fit();
+    CHECK(b.is_inline() && bytes_eq(b, "tail") && b.memory_usage() == sizeof(b));
+    std::cout << "  Spill to heap, drain rewind, shrink_to_fit back inline: OK\n";
+
+    // iovec export: gather two buffers, scatter into spare capacity
+    lloyal::InlinedByteBuffer<64> head, body, sink;
+    head.append("HDR:", 4);
+    body.append("payload", 7);
+    FakeIovec iov[4];
+    size_t cnt = head.data_iovecs(iov, 4);
+    cnt += body.data_iovecs(iov + cnt, 4 - cnt);
+    cnt += sink.data_iovecs(iov + cnt, 4 - cnt); // Empty buffers contribute nothing
+    CHECK(cnt == 2 && iov[0].iov_len == 4 && iov[1].iov_len == 7);
+    FakeIovec w[1];
+    CHECK(sink.prepare_iovecs(w, 11) == 1 && w[0].iov_len >= 11);
+    size_t off = 0; // Emulate writev -> readv
+    for (size_t i = 0; i < cnt; ++i) { std::memcpy(static_cast<std::byte*>(w[0].iov_base) + off, iov[i].iov_base, iov[i].iov_len); off += iov[i].iov_len; }
+    sink.commit(off);
+    CHECK(bytes_eq(sink, "HDR:payload"));
+    std::cout << "  data_iovecs gather / prepare_iovecs scatter: OK\n";
+
+    // Copy and move, inline and heap
+    sink.append(big.data(), big.size());
+    sink.consume(4);
+    lloyal::InlinedByteBuffer<64> copy(sink);
+    CHECK(bytes_eq(copy, "payload" + big));
+    lloyal::InlinedByteBuffer<64> moved(std::move(sink));
+    CHECK(sink.empty() && sink.is_inline() && bytes_eq(moved, "payload" + big));
+    head = std::move(moved);
+    CHECK(!head.is_inline() && bytes_eq(head, "payload" + big));
+    copy = lloyal::InlinedByteBuffer<64>();
+    CHECK(copy.empty());
+    std::cout << "  Copy / move construction and assignment: OK\n";
+
+    // Random framed traffic against a std::string shadow
+    std::mt19937 rng(66);
+    lloyal::InlinedByteBuffer<64> r;
+    std::string shadow;
+    for (int step = 0; step < 2000; ++step) {
+        if (rng() % 2) {
+            const size_t n = rng() % 90;
+            std::byte* dst = r.prepare(n);
+            for (size_t i = 0; i < n; ++i) { dst[i] = std::byte(step + i); shadow.push_back(static_cast<char>(step + i)); }
+            r.commit(n);
+        } else {
+            const size_t n = shadow.empty() ? 0 : rng() % (shadow.size() + 1);
+            r.consume(n); shadow.erase(0, n);
+        }
+        if (rng() % 64 == 0) r.shrink_to_fit();
+        if (r.size() != shadow.size() || std::memcmp(r.data(), shadow.data(), shadow.size()) != 0) {
+            std::cerr << "  Mismatch at step " << step << "\n"; return false;
+        }
+    }
+    std::cout << "  Random prepare/commit/consume vs shadow: OK\n";
+
+    std::cout << "✅ PASS: InlinedByteBuffer reads and writes in place without shifting consumed bytes.\n"; return true;
+}
+
+// ============================================================================
+// TEST 27: InlinedSpscRing (Lock-Free Inter-Thread Handoff)
+// ============================================================================
+template<lloyal::ring_overflow Overflow>
+bool run_spsc_stress(int total) {
+    lloyal::InlinedSpscRing<ConstMember, 8, Overflow> ring;
+    std::thread producer([&] {
+        std::mt19937 rng(67);
+        std::vector<ConstMember> batch;
+        for (int next = 0; next < total;) {
+            batch.clear();
+            const int n = std::min<int>(1 + static_cast<int>(rng() % 12), total - next);
+            for (int i = 0; i < n; ++i) batch.emplace_back(next + i);
+            size_t sent = 0;
+            while (sent < batch.size()) {
+                sent += ring.push_n(std::make_move_iterator(batch.begin() + sent), batch.size() - sent);
+                if (sent < batch.size()) std::this_thread::yield();
+            }
+            next += n;
+        }
+    });
+    bool ordered = true;
+    int expect = 0;
+    std::vector<ConstMember> got;
+    while (expect < total) {
+        got.clear();
+        if (expect % 3 == 0) {
+            if (auto v = ring.try_pop()) got.push_back(std::move(*v));
+        } else {
+            ring.pop_n(std::back_inserter(got), 1 + expect % 10);
+        }
+        if (got.empty()) { std::this_thread::yield(); continue; }
+        for (const ConstMember& m : got) ordered &= (m.id == expect++);
+    }
+    producer.join();
+    return ordered && ring.empty();
+}
+
+bool test_spsc_ring() {
+    std::cout << "\n--- TEST 27: InlinedSpscRing ---\n";
+    ConstMember::reset();
+    {
+        lloyal::InlinedSpscRing<ConstMember, 4> ring;
+        CHECK(ring.empty() && ring.front() == nullptr && !ring.try_pop());
+        for (int i = 0; i < 4; ++i) CHECK(ring.try_emplace(i));
+        CHECK(!ring.try_push(ConstMember(99)));
+        CHECK(ConstMember::live == 4);
+        CHECK(ring.front()->id == 0);
+        ring.pop();
+        CHECK(ring.try_pop()->id == 1);
+        CHECK(ConstMember::live == 2);
+        std::cout << "  try_emplace / full rejection / front / pop / try_pop: OK\n";
+
+        // Batches wrap around the slot array
+        std::vector<ConstMember> in;
+        for (int i = 4; i < 10; ++i) in.emplace_back(i);
+        CHECK(ring.push_n(in.begin(), in.size()) == 2); // Only two slots free
+        std::vector<ConstMember> out;
+        CHECK(ring.pop_n(std::back_inserter(out), 3) == 3 && ring.push_n(in.begin() + 2, 4) == 3);
+        CHECK(ring.pop_n(std::back_inserter(out), 10) == 4 && ring.empty());
+        std::vector<int> ids;
+        for (const auto& m : out) ids.push_back(m.id);
+        CHECK((ids == std::vector<int>{2, 3, 4, 5, 6, 7, 8}));
+        std::cout << "  push_n / pop_n partial batches across wrap-around: OK\n";
+        CHECK(ring.try_emplace(42) && ring.try_emplace(43));
+    }
+    CHECK(ConstMember::live == 0); // The destructor destroyed the two left in the ring
+    {
+        // Overflow: pushes never fail; heap segments are freed as they drain
+        TestAllocator<ConstMember>::reset();
+        lloyal::InlinedSpscRing<ConstMember, 4, lloyal::ring_overflow::heap, TestAllocator<ConstMember>> ring;
+        for (int i = 0; i < 20; ++i) CHECK(ring.try_emplace(i)); // 4 inline + 8 + 16 heap slots
+        std::vector<ConstMember> out;
+        CHECK(ring.pop_n(std::back_inserter(out), 100) == 20);
+        for (int i = 0; i < 20; ++i) CHECK(out[i].id == i);
+        CHECK(ring.empty());
+        // The inline segment was drained and unlinked: the next overflow reuses it
+        const int allocs = TestAllocator<ConstMember>::allocations;
+        for (int i = 0; i < 16; ++i) CHECK(ring.try_emplace(i)); // Fills the 16-slot heap segment
+        CHECK(ring.try_emplace(16) && TestAllocator<ConstMember>::allocations == allocs);
+        CHECK(ring.pop_n(std::back_inserter(out), 100) == 17 && out.back().id == 16);
+        for (int i = 0; i < 10; ++i) CHECK(ring.try_emplace(100 + i)); // Leave some behind
+    }
+    CHECK(TestAllocator<ConstMember>::allocations == TestAllocator<ConstMember>::deallocations);
+    std::cout << "  Heap overflow keeps FIFO order, reuses the inline segment, frees on drain: OK\n";
+
+    CHECK(run_spsc_stress<lloyal::ring_overflow::reject>(20000));
+    CHECK(run_spsc_stress<lloyal::ring_overflow::heap>(20000));
+    CHECK(ConstMember::live == 0);
+    std::cout << "  Two-thread stress, non-assignable T, both overflow modes: OK\n";
+
+    std::cout << "✅ PASS: InlinedSpscRing hands off batches between threads without locks.\n"; return true;
+}
+
+// ============================================================================
+// TEST 28: IncrementalInlinedVector (De-Amortized Growth)
+// ============================================================================
+struct MigrationProbe {
+    static inline int moves = 0;
+    int v;
+    MigrationProbe(int x) : v(x) {}
+    MigrationProbe(const MigrationProbe& o) : v(o.v) {}
+    MigrationProbe(MigrationProbe&& o) noexcept : v(o.v) { ++moves; }
+};
+
+template<typename Vec, typename T>
+bool same_contents(const Vec& v, const std::vector<T>& shadow) {
+    if (v.size() != shadow.size()) return false;
+    for (size_t i = 0; i < shadow.size(); ++i) if (!(v[i] == shadow[i])) return false;
+    return std::equal(v.begin(), v.end(), shadow.begin());
+}
+
+bool test_incremental_growth() {
+    std::cout << "\n--- TEST 28: IncrementalInlinedVector ---\n";
+    {
+        // No push moves more than Step old elements, at any size
+        lloyal::IncrementalInlinedVector<MigrationProbe, 4> v;
+        int worst = 0;
+        for (int i = 0; i < 5000; ++i) {
+            MigrationProbe::moves = 0;
+            v.emplace_back(i);
+            worst = std::max(worst, MigrationProbe::moves);
+        }
+        CHECK(worst == 2 && v.size() == 5000);
+        for (int i = 0; i < 5000; ++i) CHECK(v[i].v == i);
+        std::cout << "  Worst-case moves per push_back == Step (2) up to 5000 elements: OK\n";
+    }
+    {
+        // Indexing spans both buffers mid-migration; data() finishes it
+        TestAllocator<ConstMember>::reset();
+        ConstMember::reset();
+        lloyal::IncrementalInlinedVector<ConstMember, 4, TestAllocator<ConstMember>> v;
+        std::vector<ConstMember> shadow;
+        for (int i = 0; i < 17; ++i) { v.emplace_back(i); shadow.emplace_back(i); } // 16 -> 32 just happened
+        CHECK(v.is_migrating() && v.capacity() == 32 && same_contents(v, shadow));
+        CHECK(v.memory_usage() == sizeof(v) + (32 + 16) * sizeof(ConstMember));
+        CHECK(v.data()[3] == shadow[3] && !v.is_migrating() && same_contents(v, shadow));
+        std::cout << "  Reads across old and new buffers; data() completes migration: OK\n";
+
+        // Copy and move while migrating from the inline buffer and from a heap buffer
+        lloyal::IncrementalInlinedVector<ConstMember, 4, TestAllocator<ConstMember>> small;
+        for (int i = 0; i < 5; ++i) small.emplace_back(i);
+        CHECK(small.is_migrating() && !small.is_inline());
+        auto small_copy = small;
+        auto small_moved = std::move(small);
+        CHECK(small.empty() && small.is_inline() && small_moved == small_copy && small_moved.size() == 5);
+        for (int i = 17; i < 33; ++i) { v.emplace_back(i); shadow.emplace_back(i); }
+        CHECK(v.is_migrating());
+        auto big_moved = std::move(v);
+        CHECK(v.empty() && big_moved.is_migrating() && same_contents(big_moved, shadow));
+        v = std::move(big_moved);
+        CHECK(same_contents(v, shadow));
+        std::cout << "  Copy / move with a migration in flight: OK\n";
+    }
+    CHECK(ConstMember::live == 0);
+    CHECK(TestAllocator<ConstMember>::allocations == TestAllocator<ConstMember>::deallocations);
+
+    // Random differential against std::vector with a non-assignable type
+    std::mt19937 rng(68);
+    {
+        lloyal::IncrementalInlinedVector<ConstMember, 3, std::allocator<ConstMember>, 1> v;
+        std::vector<ConstMember> shadow;
+        for (int step = 0; step < 4000; ++step) {
+            const unsigned op = rng() % 16;
+            if (op < 10) { v.emplace_back(step); shadow.emplace_back(step); }
+            else if (op < 14) { if (!shadow.empty()) { v.pop_back(); shadow.pop_back(); } }
+            else if (op == 14) { if (rng() % 8 == 0) { v.shrink_to_fit(); } }
+            else if (rng() % 32 == 0) { v.clear(); shadow.clear(); }
+            if (!same_contents(v, shadow)) { std::cerr << "  Mismatch at step " << step << "\n"; return false; }
+        }
+    }
+    CHECK(ConstMember::live == 0);
+    std::cout << "  Random push/pop/shrink/clear vs std::vector (Step = 1): OK\n";
+
+    std::cout << "✅ PASS: IncrementalInlinedVector bounds the work done by any single push_back.\n"; return true;
+}
+
+// ============================================================================
+// TEST 29: AdaptiveInlinedVector (Learned First-Spill Capacity)
+// ============================================================================
+struct SiteLarge {}; struct SiteJustOver {}; struct SiteAlias {};
+
+template<typename Site>
+void train_site(size_t final_size, int count) {
+    for (int i = 0; i < count; ++i) {
+        lloyal::AdaptiveInlinedVector<int, 16, Site> v;
+        for (size_t k = 0; k < final_size; ++k) v.push_back(static_cast<int>(k));
+    }
+}
+
+bool test_adaptive_spill() {
+    std::cout << "\n--- TEST 29: AdaptiveInlinedVector ---\n";
+    using Large = lloyal::AdaptiveInlinedVector<int, 16, SiteLarge, TestAllocator<int>>;
+    {
+        Large v;
+        CHECK(v.learned_spill_capacity() == 0);
+        for (int i = 0; i < 17; ++i) v.push_back(i);
+        CHECK(v.capacity() == 32); // Default policy until the site has samples
+    }
+    std::cout << "  Untrained site uses the default first spill: OK\n";
+
+    train_site<SiteLarge>(500, 20);
+    {
+        TestAllocator<int>::reset();
+        Large v;
+        CHECK(v.learned_spill_capacity() == 511); // p90 bucket [384, 511]
+        for (int i = 0; i < 500; ++i) v.push_back(i);
+        CHECK(v.capacity() == 511 && TestAllocator<int>::allocations == 1);
+        for (int i = 0; i < 500; ++i) CHECK(v[i] == i);
+    }
+    train_site<SiteJustOver>(17, 20);
+    {
+        lloyal::AdaptiveInlinedVector<int, 16, SiteJustOver> v;
+        v.resize(17);
+        CHECK(v.capacity() == 23); // Not the default 32
+    }
+    std::cout << "  Trained sites spill once to their p90 size, independently: OK\n";
+
+    train_site<SiteLarge>(20, 300); // Workload shift
+    CHECK(Large().learned_spill_capacity() == 23);
+    std::cout << "  Decay follows a workload shift: OK\n";
+
+    train_site<SiteAlias>(40, 20);
+    {
+        lloyal::AdaptiveInlinedVector<std::string, 16, SiteAlias> v;
+        for (int i = 0; i < 16; ++i) v.push_back("payload-that-defeats-sso-" + std::to_string(i));
+        v.push_back(v[3]);          // Aliases the inline buffer the reserve would move
+        v.insert(v.begin(), v[5]);
+        CHECK(v.capacity() > 16 && v.size() == 18 && v[17] == v[4] && v[0] == v[6]);
+        auto copy = v;
+        CHECK(copy == v);
+    }
+    std::cout << "  push_back / insert of an aliased element at the spill: OK\n";
+
+    size_t other_thread = 1;
+    std::thread([&] { other_thread = lloyal::AdaptiveInlinedVector<int, 16, SiteLarge>().learned_spill_capacity(); }).join();
+    CHECK(other_thread == 0);
+    std::cout << "  Statistics are per thread: OK\n";
+
+#if LLOYAL_HAS_SOURCE_LOCATION
+    for (int round = 0; round < 20; ++round) {
+        lloyal::AdaptiveInlinedVector<int, 8> a; // One site...
+        lloyal::AdaptiveInlinedVector<int, 8> b; // ...and another
+        for (int i = 0; i < 100; ++i) a.push_back(i);
+        for (int i = 0; i < 9; ++i) b.push_back(i);
+        if (round == 19) {
+            CHECK(a.learned_spill_capacity() == 127 && b.learned_spill_capacity() == 11);
+            a = std::move(b); // Propagates the allocator, but not the site
+            CHECK(a.learned_spill_capacity() == 127);
+        }
+    }
+    std::cout << "  std::source_location distinguishes construction sites: OK\n";
+#endif
+
+    std::cout << "✅ PASS: AdaptiveInlinedVector sizes its first spill from each site's history.\n"; return true;
+}
+
+// ============================================================================
+// TEST 30: CowInlinedVector (Shared Heap Blocks)
+// ============================================================================
+bool test_cow_inlined_vector() {
+    std::cout << "\n--- TEST 30: CowInlinedVector ---\n";
+    using Cow = lloyal::CowInlinedVector<MyType, 4, TestAllocator<MyType>>;
+    {
+        Cow a;
+        for (int i = 0; i < 100; ++i) a.push_back(MyType(i));
+        const int copies = MyType::copy_constructions, live = MyType::live();
+        Cow b(a);
+        Cow c;
+        c = b;
+        CHECK(MyType::copy_constructions == copies && MyType::live() == live);
+        CHECK(a.is_shared() && b.is_shared() && std::as_const(b).data() == std::as_const(a).data());
+        CHECK(std::as_const(c)[57].value == 57 && c.is_shared()); // Const reads keep sharing
+        std::cout << "  Copy and copy-assignment of a spilled vector are O(1): OK\n";
+
+        b.push_back(MyType(100));
+        CHECK(MyType::copy_constructions == copies + 100 && !b.is_shared() && b.size() == 101);
+        CHECK(a.size() == 100 && a.is_shared() && c.is_shared()); // a and c still share
+        b.pop_back();
+        CHECK(b == a);
+        c.erase(c.cbegin());
+        CHECK(!a.is_shared() && a.size() == 100 && c.size() == 99 && std::as_const(c)[0].value == 1);
+        std::cout << "  The first mutation separates; the others keep the old block: OK\n";
+
+        Cow d(a);
+        MyType& first = d[0]; // Separates d and pins its block
+        CHECK(!a.is_shared() && !d.is_shared());
+        Cow e(d);             // Must not share a block with an escaped reference
+        first.value = -7;
+        CHECK(!e.is_shared() && std::as_const(e)[0].value == 0 && std::as_const(d)[0].value == -7);
+        d.clear();
+        for (int i = 0; i < 50; ++i) d.push_back(MyType(i));
+        Cow f(d);             // clear() made the block shareable again
+        CHECK(f.is_shared() && f.size() == 50);
+        std::cout << "  Non-const access pins the block until it is cleared: OK\n";
+
+        Cow g(a);
+        g.push_back(std::as_const(g)[10]); // Aliases the shared block being copied
+        g.insert(g.cbegin(), std::as_const(g)[99]);
+        CHECK(g.size() == 102 && std::as_const(g)[0].value == 99 && std::as_const(g)[101].value == 10);
+        CHECK(std::as_const(g)[1].value == 0 && a.size() == 100);
+        Cow h(a);
+        h.resize(200, std::as_const(h)[5]);
+        CHECK(h.size() == 200 && std::as_const(h)[199].value == 5 && a.size() == 100);
+        std::cout << "  Aliased arguments while separating: OK\n";
+
+        Cow other_alloc(TestAllocator<MyType>(7));
+        other_alloc = a; // Unequal allocators never share a block
+        CHECK(!other_alloc.is_shared() && other_alloc == a && other_alloc.get_allocator().id == 7);
+        Cow moved(std::move(g));
+        CHECK(moved.size() == 102 && g.empty() && g.is_inline());
+    }
+    CHECK(MyType::live() == 0);
+    std::cout << "  Allocator equality and moves: OK\n";
+
+    {
+        lloyal::CowInlinedVector<std::string, 4> v = {"a", "b", "c"};
+        auto w = v;
+        w[0] = "changed";
+        CHECK(v[0] == "a" && w[0] == "changed" && v.is_inline() && w.is_inline());
+        w.shrink_to_fit();
+        CHECK(w.is_inline());
+        for (int i = 0; i < 10; ++i) w.push_back(std::to_string(i));
+        w.erase(w.begin() + 3, w.end());
+        w.shrink_to_fit();
+        CHECK(w.is_inline() && w.size() == 3 && w[0] == "changed");
+    }
+    std::cout << "  Inline contents are copied by value; shrink_to_fit returns inline: OK\n";
+
+    // Snapshots copied and dropped on other threads
+    {
+        lloyal::CowInlinedVector<MyType, 4> table;
+        for (int i = 0; i < 1000; ++i) table.push_back(MyType(i));
+        std::vector<std::thread> readers;
+        std::atomic<long> sum{0};
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([&table, &sum] {
+                for (int k = 0; k < 200; ++k) {
+                    const lloyal::CowInlinedVector<MyType, 4> snapshot(table);
+                    sum += snapshot[999].value;
+                    if (k % 50 == 0) { auto mine = snapshot; mine.push_back(MyType(k)); }
+                }
+            });
+        }
+        for (auto& th : readers) th.join();
+        CHECK(sum == 4L * 200 * 999 && !table.is_shared());
+    }
+    CHECK(MyType::live() == 0);
+    std::cout << "  Concurrent snapshots of one table: OK\n";
+
+    // Random differential against std::vector across a pool of copies
+    std::mt19937 rng(70);
+    {
+        using V = lloyal::CowInlinedVector<int, 3>;
+        std::vector<V> pool(4);
+        std::vector<std::vector<int>> shadow(4);
+        for (int step = 0; step < 6000; ++step) {
+            const size_t i = rng() % 4, j = rng() % 4;
+            switch (rng() % 10) {
+                case 0: pool[i] = pool[j]; shadow[i] = shadow[j]; break;
+                case 1: if (!shadow[i].empty()) { pool[i].pop_back(); shadow[i].pop_back(); } break;
+                case 2: if (!shadow[i].empty()) { const size_t k = rng() % shadow[i].size(); pool[i][k] = step; shadow[i][k] = step; } break;
+                case 3: if (!shadow[i].empty()) { const size_t k = rng() % shadow[i].size(); pool[i].erase(pool[i].cbegin() + k); shadow[i].erase(shadow[i].begin() + k); } break;
+                case 4: { const size_t k = rng() % (shadow[i].size() + 1); pool[i].insert(pool[i].cbegin() + k, step); shadow[i].insert(shadow[i].begin() + k, step); } break;
+                case 5: if (rng() % 16 == 0) { pool[i].clear(); shadow[i].clear(); } else { pool[i].shrink_to_fit(); } break;
+                case 6: { const size_t n = rng() % 40; pool[i].resize(n); shadow[i].resize(n); } break;
+                default: pool[i].push_back(step); shadow[i].push_back(step); break;
+            }
+            for (size_t k = 0; k < 4; ++k) {
+                const V& cv = pool[k];
+                if (cv.size() != shadow[k].size() || !std::equal(cv.begin(), cv.end(), shadow[k].begin())) {
+                    std::cerr << "  Mismatch at step " << step << "\n"; return false;
+                }
+            }
+        }
+    }
+    std::cout << "  Random copy/mutate across a pool vs std::vector: OK\n";
+
+    std::cout << "✅ PASS: CowInlinedVector shares spilled storage until a copy writes.\n"; return true;
+}
+
+// ============================================================================
+// TEST 31: AtomicInlinedVectorSnapshot (RCU Publication)
+// ============================================================================
+bool test_atomic_snapshot() {
+    std::cout << "\n--- TEST 31: AtomicInlinedVectorSnapshot ---\n";
+    using Snap = lloyal::AtomicInlinedVectorSnapshot<MyType, 4>;
+    {
+        Snap snap;
+        CHECK(snap.read()->empty());
+        snap.update([](auto& v) { v.push_back(MyType(1)); v.push_back(MyType(2)); });
+        snap.publish(Snap::vector_type{MyType(7), MyType(8), MyType(9)});
+        CHECK(snap.read()->size() == 3 && (*snap.read())[2].value == 9);
+        CHECK(snap.read([](const auto& v) { return v[0].value; }) == 7);
+        try { snap.update([](auto& v) { v.push_back(MyType(10)); throw std::runtime_error("abort"); }); } catch (const std::runtime_error&) {}
+        CHECK(snap.read()->size() == 3); // A throwing update publishes nothing
+        snap.synchronize();
+        CHECK(snap.retired_count() == 0);
+    }
+    CHECK(MyType::live() == 0);
+    std::cout << "  publish / update / read: OK\n";
+
+    {
+        Snap snap(Snap::vector_type{MyType(1)});
+        {
+            auto pinned = snap.read();
+            {
+                auto nested = snap.read(); // Nested guards keep the outer epoch
+                snap.update([](auto& v) { v.push_back(MyType(2)); });
+            }
+            snap.update([](auto& v) { v.push_back(MyType(3)); });
+            CHECK(snap.retired_count() == 2); // Both old snapshots may still be visible to `pinned`
+            CHECK(pinned->size() == 1 && (*pinned)[0].value == 1);
+            CHECK(snap.read()->size() == 3);
+        }
+        snap.update([](auto& v) { v.push_back(MyType(4)); });
+        CHECK(snap.retired_count() == 0); // The guard is gone, so the write reclaimed everything
+
+        std::atomic<int> stage{0};
+        size_t seen = 0;
+        std::thread reader([&] {
+            auto g = snap.read();
+            stage = 1;
+            while (stage != 2) std::this_thread::yield();
+            seen = g->size(); // Still the pinned snapshot
+        });
+        while (stage != 1) std::this_thread::yield();
+        snap.update([](auto& v) { v.pop_back(); });
+        CHECK(snap.retired_count() == 1); // Held by the other thread's guard
+        stage = 2;
+        reader.join();
+        CHECK(seen == 4);
+        snap.synchronize();
+        CHECK(snap.retired_count() == 0);
+    }
+    CHECK(MyType::live() == 0);
+    std::cout << "  Guards delay reclamation, across threads and when nested: OK\n";
+
+    // Readers validate every snapshot while a writer republishes continuously.
+    // Every element of a snapshot holds the same value: a torn or freed snapshot breaks that.
+    {
+        Snap snap;
+        std::atomic<bool> done{false};
+        std::atomic<int> bad{0};
+        std::atomic<long> reads{0};
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([&] {
+                while (!done.load(std::memory_order_relaxed)) {
+                    auto g = snap.read();
+                    for (const MyType& m : *g) if (m.value != g->front().value) ++bad;
+                    ++reads;
+                }
+            });
+        }
+        for (int k = 1; k <= 2000; ++k) {
+            snap.update([k](auto& v) { for (auto& m : v) m.value = k; v.push_back(MyType(k)); if (v.size() > 40) v.clear(); });
+        }
+        done = true;
+        for (auto& th : readers) th.join();
+        snap.synchronize();
+        CHECK(bad == 0 && reads > 0 && snap.retired_count() == 0);
+    }
+    CHECK(MyType::live() == 0);
+    std::cout << "  4 readers vs 2000 writes: no torn or freed snapshots: OK\n";
+
+    std::cout << "✅ PASS: AtomicInlinedVectorSnapshot publishes snapshots with wait-free reads.\n"; return true;
+}
+
+// ============================================================================
+// TEST 32: InlinedVectorInterner (Hash-Consing)
+// ============================================================================
+bool test_interner() {
+    std::cout << "\n--- TEST 32: InlinedVectorInterner ---\n";
+    {
+        lloyal::InlinedVectorInterner<uint32_t, 6> in;
+        const auto a = in.intern({1u, 2u, 3u});
+        const auto b = in.intern(std::vector<uint32_t>{1, 2, 3});
+        const auto c = in.intern(lloyal::InlinedVector<uint32_t, 6>{1, 2, 4});
+        const auto e = in.intern(static_cast<const uint32_t*>(nullptr), 0);
+        CHECK(a == b && a != c && in.intern({}) == e && in.size() == 3);
+        CHECK(in[a].size() == 3 && in[a][2] == 3 && in[c][2] == 4 && in[e].empty());
+        const auto* stored = &in[a];
+        std::vector<uint32_t> big(10); // Spills the stored vector
+        for (uint32_t i = 0; i < 20000; ++i) { big[0] = i; in.intern(big); }
+        CHECK(&in[a] == stored && in.size() == 20003); // Growth never moves a stored value
+        big[0] = 12345;
+        const auto h = in.intern(big);
+        CHECK(in.size() == 20003 && in[h].size() == 10 && in[h][0] == 12345);
+        const auto st = in.stats();
+        CHECK(st.distinct == 20003 && st.lookups == 20006 && st.value_bytes > 20003 * sizeof(lloyal::InlinedVector<uint32_t, 6>));
+        CHECK(st.index_bytes > 0);
+    }
+    std::cout << "  Equal contents share one handle; stored values never move: OK\n";
+
+    {
+        lloyal::InlinedVectorInterner<std::string, 2> in; // Hashed per element, not as bytes
+        const auto a = in.intern({std::string("alpha"), std::string("beta")});
+        const auto b = in.intern(std::vector<std::string>{"alpha", "beta"});
+        const auto c = in.intern({std::string("alphabeta")});
+        CHECK(a == b && a != c && in[a][1] == "beta");
+    }
+    std::cout << "  Non-bytewise element types: OK\n";
+
+    {
+        lloyal::InlinedVectorInterner<uint32_t, 6> in;
+        std::mt19937 rng(72);
+        std::vector<std::vector<uint32_t>> inputs(5000);
+        for (auto& v : inputs) { v.resize(rng() % 8); for (auto& x : v) x = rng() % 3; }
+        std::vector<uint32_t> batch(inputs.size());
+        in.intern_batch(inputs.begin(), inputs.end(), batch.begin());
+        CHECK(in.stats().lookups == inputs.size()); // One lookup per batch element
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            CHECK(in.intern(inputs[i]) == batch[i]);
+            CHECK(std::equal(in[batch[i]].begin(), in[batch[i]].end(), inputs[i].begin(), inputs[i].end()));
+        }
+        const auto st = in.stats();
+        CHECK(st.lookups == 2 * inputs.size() && st.distinct == in.size());
+    }
+    std::cout << "  intern_batch matches intern and counts its lookups: OK\n";
+
+    {
+        lloyal::InlinedVectorInterner<uint32_t, 6> in;
+        constexpr int kThreads = 4, kDistinct = 3000;
+        std::vector<std::vector<uint32_t>> seen(kThreads, std::vector<uint32_t>(kDistinct));
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t] {
+                for (int rep = 0; rep < 3; ++rep) {
+                    for (int k = 0; k < kDistinct; ++k) {
+                        const int id = (k * 7 + t * 1000) % kDistinct; // Threads race on first sight
+                        const uint32_t label[3] = {uint32_t(id), uint32_t(id % 13), 7u};
+                        seen[t][id] = in.intern(label, 1 + id % 3);
+                    }
+                }
+            });
+        }
+        for (auto& th : threads) th.join();
+        CHECK(in.size() == kDistinct && in.stats().lookups == std::size_t{kThreads} * 3 * kDistinct);
+        for (int t = 1; t < kThreads; ++t) CHECK(seen[t] == seen[0]);
+    }
+    std::cout << "  Concurrent interning agrees on every handle: OK\n";
+
+    std::cout << "✅ PASS: InlinedVectorInterner deduplicates equal vectors behind stable handles.\n"; return true;
+}
+
+// ============================================================================
+// TEST 33: Numeric Expressions (Fused Element-Wise Ops and Reductions)
+// ============================================================================
+bool test_numeric_expressions() {
+    std::cout << "\n--- TEST 33: Numeric Expressions ---\n";
+    using lloyal::num;
+    {
+        // Every size from empty through inline (N == 16, the fixed path) to spilled
+        for (int n = 0; n <= 40; ++n) {
+            lloyal::InlinedVector<int32_t, 16> a, b, c, out(3, -1);
+            for (int i = 0; i < n; ++i) { a.push_back(i); b.push_back(2 * i - 5); c.push_back(i % 7); }
+            num(out) = num(a) + num(b) * num(c) - 3;
+            CHECK(out.size() == size_t(n));
+            int32_t expect_dot = 0, expect_sum = 0;
+            for (int i = 0; i < n; ++i) {
+                CHECK(out[i] == a[i] + b[i] * c[i] - 3);
+                expect_dot += a[i] * b[i];
+                expect_sum += a[i] + 2 * c[i];
+            }
+            CHECK(lloyal::dot(a, b) == expect_dot);
+            CHECK(lloyal::sum(num(a) + 2 * num(c)) == expect_sum);
+        }
+    }
+    std::cout << "  Sizes 0..40 across the inline and heap paths match scalar loops: OK\n";
+
+    {
+        lloyal::InlinedVector<float, 16> a, b;
+        for (int i = 0; i < 16; ++i) { a.push_back(float(i)); b.push_back(1.0f); }
+        num(a) = num(a) * 0.5f + num(a); // Target aliases an operand
+        CHECK(a[4] == 6.0f && a[15] == 22.5f);
+        num(a) -= num(b);
+        num(a) /= 2;
+        CHECK(a[4] == 2.5f && a.size() == 16 && a.capacity() == 16);
+        num(b) = num(a); // View-to-view copy
+        CHECK(b == a);
+    }
+    std::cout << "  Compound assignment and aliasing the target: OK\n";
+
+    {
+        lloyal::InlinedVector<double, 4> v{3.0, 4.0};
+        CHECK(lloyal::norm(v) == 5.0);
+        lloyal::InlinedVector<double, 4> w(100, 0.5); // Spilled
+        CHECK(lloyal::sum(w) == 50.0 && lloyal::dot(w, w) == 25.0 && w.capacity() > 4);
+        const lloyal::InlinedVector<double, 4>& cw = w;
+        lloyal::InlinedVector<double, 4> r;
+        num(r) = num(cw) * num(cw) + 1.0;
+        CHECK(r.size() == 100 && r[99] == 1.25);
+    }
+    std::cout << "  norm, sum and spilled operands: OK\n";
+
+    std::cout << "✅ PASS: Numeric expressions fuse element-wise arithmetic without temporaries.\n"; return true;
+}
+
+// ============================================================================
+// TEST 34: merge_insert_sorted (Batch Sorted-Merge Insert)
+// ============================================================================
+bool test_merge_insert_sorted() {
+    std::cout << "\n--- TEST 34: merge_insert_sorted ---\n";
+    {
+        // Differential against insert(lower_bound) and against set semantics,
+        // across inline, inline->heap, heap with spare capacity and heap growth
+        std::mt19937 rng(74);
+        for (int round = 0; round < 2000; ++round) {
+            const bool unique = round % 2 == 1;
+            lloyal::InlinedVector<int, 8> v;
+            std::vector<int> ref;
+            const int n = static_cast<int>(rng() % 30);
+            for (int i = 0; i < n; ++i) ref.push_back(static_cast<int>(rng() % 40));
+            std::sort(ref.begin(), ref.end());
+            if (unique) ref.erase(std::unique(ref.begin(), ref.end()), ref.end());
+            for (int x : ref) v.push_back(x);
+            const std::vector<int> base(ref);
+            if (round % 5 == 0) v.reserve(64); // Heap with room: merges in place
+            std::vector<int> keys(rng() % 20);
+            for (auto& k : keys) k = static_cast<int>(rng() % 40);
+            std::sort(keys.begin(), keys.end());
+            size_t expect_inserted = 0;
+            for (int k : keys) {
+                const auto pos = std::lower_bound(ref.begin(), ref.end(), k);
+                if (unique && pos != ref.end() && *pos == k) continue;
+                ref.insert(pos, k); ++expect_inserted;
+            }
+            const size_t inserted = v.merge_insert_sorted(keys.begin(), keys.end(), std::less<>{},
+                unique ? lloyal::merge_duplicates::skip : lloyal::merge_duplicates::keep);
+            CHECK(inserted == expect_inserted);
+            CHECK(std::equal(v.begin(), v.end(), ref.begin(), ref.end()));
+
+            // Same batch with non-trivial elements: relocation loops instead of memmove
+            auto to_key = [](int x) { return "key-beyond-small-string-" + std::to_string(100 + x); };
+            lloyal::InlinedVector<std::string, 8> s;
+            for (int x : base) s.push_back(to_key(x));
+            if (round % 5 == 0) s.reserve(64);
+            std::vector<std::string> skeys;
+            for (int k : keys) skeys.push_back(to_key(k));
+            CHECK(s.merge_insert_sorted(skeys.begin(), skeys.end(), std::less<>{},
+                unique ? lloyal::merge_duplicates::skip : lloyal::merge_duplicates::keep) == expect_inserted);
+            CHECK(s.size() == ref.size());
+            for (size_t i = 0; i < ref.size(); ++i) CHECK(s[i] == to_key(ref[i]));
+        }
+    }
+    std::cout << "  2000 random batches match insert(lower_bound) and set semantics: OK\n";
+
+    {
+        lloyal::InlinedVector<int, 8> v{10, 20, 30, 40, 50, 60};
+        v.reserve(32);
+        const int* before = v.data();
+        const int keys[] = {5, 25, 25, 70};
+        CHECK(v.merge_insert_sorted(std::begin(keys), std::end(keys)) == 4);
+        CHECK(v.data() == before); // Fits capacity: no reallocation
+        CHECK((v == lloyal::InlinedVector<int, 8>{5, 10, 20, 25, 25, 30, 40, 50, 60, 70}));
+        std::istringstream in("1 1 35 36");
+        CHECK(v.merge_insert_sorted(std::istream_iterator<int>(in), std::istream_iterator<int>(),
+                                    std::less<>{}, lloyal::merge_duplicates::skip) == 3); // Single-pass input
+        CHECK(v.size() == 13 && v[0] == 1 && v[1] == 5 && v[8] == 36 && v[9] == 40);
+    }
+    std::cout << "  In-place heap merge, single-pass input: OK\n";
+
+    {
+        // Non-assignable elements, heap and inline
+        ConstMember::reset();
+        {
+            auto by_id = [](const ConstMember& a, const ConstMember& b) { return a.id < b.id; };
+            lloyal::InlinedVector<ConstMember, 4> v;
+            for (int id : {2, 4, 6}) v.emplace_back(id);
+            std::vector<ConstMember> keys;
+            for (int id : {1, 3, 4, 7}) keys.emplace_back(id);
+            CHECK(v.merge_insert_sorted(keys.begin(), keys.end(), by_id, lloyal::merge_duplicates::skip) == 3); // Spills: staged copies
+            CHECK(v.size() == 6 && v[0].id == 1 && v[2].id == 3 && v[5].id == 7 && v[5].payload == keys[3].payload);
+            v.reserve(32);
+            std::vector<ConstMember> more;
+            for (int id : {0, 5, 8}) more.emplace_back(id);
+            CHECK(v.merge_insert_sorted(std::make_move_iterator(more.begin()), std::make_move_iterator(more.end()), by_id) == 3);
+            CHECK(v.size() == 9);
+            for (size_t i = 0; i < v.size(); ++i) CHECK(v[i].id == static_cast<int>(i) && v[i].payload == ConstMember(v[i].id).payload);
+        }
+        CHECK(ConstMember::live == 0);
+    }
+    std::cout << "  Non-assignable elements merge by relocation: OK\n";
+
+    {
+        // Throwing moves take the rebuild path; a throwing copy leaves the vector unchanged
+        ThrowOnMoveCtor::reset();
+        auto by_v = [](const ThrowOnMoveCtor& a, const ThrowOnMoveCtor& b) { return a.v < b.v; };
+        lloyal::InlinedVector<ThrowOnMoveCtor, 4> v;
+        for (int x : {1, 3, 5}) v.emplace_back(x);
+        std::vector<ThrowOnMoveCtor> keys{2, 4, 6};
+        CHECK(v.merge_insert_sorted(keys.begin(), keys.end(), by_v) == 3);
+        CHECK(v.size() == 6 && v[1].v == 2 && v[5].v == 6);
+
+        ConstMember::reset();
+        {
+            auto by_id = [](const ConstMember& a, const ConstMember& b) { return a.id < b.id; };
+            lloyal::InlinedVector<ConstMember, 8> w;
+            for (int id : {10, 20}) w.emplace_back(id);
+            std::vector<ConstMember> batch;
+            for (int id : {5, 15, 25}) batch.emplace_back(id);
+            ConstMember::copy_throw_countdown = 2;
+            bool threw = false;
+            try { w.merge_insert_sorted(batch.begin(), batch.end(), by_id); } catch (const std::runtime_error&) { threw = true; }
+            CHECK(threw && w.size() == 2 && w[0].id == 10 && w[1].id == 20);
+            ConstMember::copy_throw_countdown = -1;
+        }
+        CHECK(ConstMember::live == 0);
+    }
+    std::cout << "  Throwing moves and throwing copies: OK\n";
+
+    std::cout << "✅ PASS: merge_insert_sorted merges sorted batches in one pass.\n"; return true;
+}
+
+// ============================================================================
+// TEST 35: InlinedMatrix (Row-Major 2D Storage with Row/Column Views)
+// ============================================================================
+bool test_inlined_matrix() {
+    std::cout << "\n--- TEST 35: InlinedMatrix ---\n";
+    {
+        // Shape, element access, inline vs. spilled storage
+        lloyal::InlinedMatrix<int, 4, 8> m(3, 5);
+        CHECK(m.rows() == 3 && m.cols() == 5 && m.size() == 15 && m.capacity() == 32);
+        for (size_t i = 0; i < 3; ++i) for (size_t j = 0; j < 5; ++j) m(i, j) = static_cast<int>(i * 10 + j);
+        CHECK(m.data()[7] == 12);
+        CHECK(m.at(2, 4) == 24);
+        bool threw = false;
+        try { (void)m.at(3, 0); } catch (const std::out_of_range&) { threw = true; }
+        CHECK(threw);
+
+        lloyal::InlinedMatrix<int, 4, 8> same(8, 4, 7); // Same element count, different shape: still inline
+        CHECK(same.capacity() == 32 && same(7, 3) == 7);
+        lloyal::InlinedMatrix<int, 4, 8> big(16, 16, 1);
+        CHECK(big.capacity() >= 256 && big(15, 15) == 1);
+    }
+    std::cout << "  Shape, access and spill: OK\n";
+
+    {
+        // Row and column spans, matrix_view accessors and transposed views
+        lloyal::InlinedMatrix<int, 4, 4> m(3, 4);
+        for (size_t i = 0; i < 3; ++i) for (size_t j = 0; j < 4; ++j) m(i, j) = static_cast<int>(i * 4 + j);
+        auto r1 = m.row(1);
+        CHECK(r1.size() == 4 && r1.contiguous() && r1[0] == 4 && r1.back() == 7);
+        CHECK(std::accumulate(r1.begin(), r1.end(), 0) == 4 + 5 + 6 + 7);
+        auto c2 = m.column(2);
+        CHECK(c2.size() == 3 && c2.stride() == 4 && !c2.contiguous());
+        CHECK(std::vector<int>(c2.begin(), c2.end()) == (std::vector<int>{2, 6, 10}));
+        CHECK(c2.end() - c2.begin() == 3 && c2.begin()[2] == 10);
+        for (int& x : c2) x = -x;
+        CHECK(m(1, 2) == -6);
+        std::sort(c2.begin(), c2.end()); // Strided iterators are random access
+        CHECK(m(0, 2) == -10 && m(2, 2) == -2);
+
+        const auto& cm = m;
+        lloyal::strided_span<const int> cr = m.row(0); // Mutable span converts to const
+        CHECK(cr.data() == cm.row(0).data());
+
+        auto v = m.view();
+        CHECK(v.rank() == 2 && v.extent(0) == 3 && v.extent(1) == 4 && v.stride(0) == 4 && v.stride(1) == 1);
+        CHECK(v.is_exhaustive() && v.data_handle() == m.data());
+        auto t = v.transposed();
+        CHECK(t.rows() == 4 && t.cols() == 3 && !t.is_exhaustive());
+        for (size_t i = 0; i < 3; ++i) for (size_t j = 0; j < 4; ++j) CHECK(t(j, i) == m(i, j));
+        CHECK(t.row(1).stride() == 4 && t.row(1)[2] == m(2, 1));
+        auto sub = v.submatrix(1, 1, 2, 2);
+        CHECK(sub(0, 0) == m(1, 1) && sub(1, 1) == m(2, 2) && sub.stride(0) == 4);
+        lloyal::matrix_view<const int> cv = cm.view();
+        CHECK(cv(2, 3) == 11);
+#if LLOYAL_HAS_MDSPAN
+        auto md = v.to_mdspan();
+        CHECK(md.extent(0) == 3 && md.extent(1) == 4 && md[1, 3] == m(1, 3));
+#endif
+    }
+    std::cout << "  Row/column spans and views: OK\n";
+
+    {
+        // resize(rows, cols) keeps the overlapping block and fills the rest,
+        // across same-width, widen/narrow in place and reallocation, against a reference
+        std::mt19937 rng(75);
+        for (int round = 0; round < 1000; ++round) {
+            lloyal::InlinedMatrix<std::string, 3, 4> m;
+            std::vector<std::vector<std::string>> ref;
+            for (int step = 0; step < 6; ++step) {
+                const size_t r = rng() % 7, c = rng() % 7;
+                const std::string fill = "f" + std::to_string(step);
+                if (round % 3 == 0 && step == 2) m.reserve(64); // Heap with room: reshapes in place
+                m.resize(r, c, fill);
+                std::vector<std::vector<std::string>> next(r, std::vector<std::string>(c, fill));
+                for (size_t i = 0; i < std::min(r, ref.size()); ++i)
+                    for (size_t j = 0; j < std::min(c, ref[i].size()); ++j) next[i][j] = ref[i][j];
+                ref = std::move(next);
+                CHECK(m.rows() == r && m.cols() == c);
+                for (size_t i = 0; i < r; ++i) {
+                    for (size_t j = 0; j < c; ++j) {
+                        CHECK(m(i, j) == ref[i][j]);
+                        m(i, j) = std::to_string(round) + ":" + std::to_string(i) + "," + std::to_string(j) + std::string(20, 'x');
+                        ref[i][j] = m(i, j);
+                    }
+                }
+            }
+        }
+
+        // Filling from an element of the matrix itself
+        lloyal::InlinedMatrix<std::string, 2, 2> m(2, 2, "a");
+        m(0, 0) = std::string(30, 'z');
+        m.resize(3, 3, m(0, 0));
+        CHECK(m(0, 0) == std::string(30, 'z') && m(2, 2) == std::string(30, 'z') && m(1, 1) == "a");
+
+        m.resize(1, 4);
+        CHECK(m.rows() == 1 && m(0, 3).empty() && m(0, 1) == "a");
+        m.clear();
+        CHECK(m.empty() && m.rows() == 0 && m.cols() == 0);
+    }
+    std::cout << "  resize(rows, cols) against a reference: OK\n";
+
+    {
+        // transpose() across inline and spilled sizes, including partial tiles
+        for (size_t r : {0u, 1u, 3u, 8u, 13u, 40u}) {
+            for (size_t c : {0u, 1u, 5u, 8u, 17u}) {
+                lloyal::InlinedMatrix<int, 4, 8> m(r, c);
+                for (size_t i = 0; i < r; ++i) for (size_t j = 0; j < c; ++j) m(i, j) = static_cast<int>(i * 100 + j);
+                lloyal::InlinedMatrix<int, 8, 4> t = lloyal::transpose(m);
+                CHECK(t.rows() == c && t.cols() == r);
+                for (size_t i = 0; i < r; ++i) for (size_t j = 0; j < c; ++j) CHECK(t(j, i) == m(i, j));
+                CHECK(lloyal::transpose(t) == m);
+            }
+        }
+
+        lloyal::InlinedMatrix<int, 2, 2> a(2, 2, 1), b(20, 20, 2);
+        lloyal::InlinedMatrix<int, 2, 2> a2 = a;
+        swap(a, b);
+        CHECK(a.rows() == 20 && b == a2 && a != b);
+        lloyal::InlinedMatrix<int, 2, 2> moved(std::move(a));
+        CHECK(moved.rows() == 20 && moved(19, 19) == 2 && a.empty());
+        moved.fill(5);
+        CHECK(std::all_of(moved.data(), moved.data() + moved.size(), [](int x) { return x == 5; }));
+    }
+    std::cout << "  transpose, swap, move and fill: OK\n";
+
+    std::cout << "✅ PASS: InlinedMatrix stores row-major blocks inline with row/column views.\n"; return true;
+}
 
 // ============================================================================
 // Main Test Runner
@@ -592,6 +2364,26 @@ int main() {
     run_test(test_regression_inline_swap_allocator, "Regression: InlineBuf::swap Allocator");
     run_test(test_regression_parent_retarget_swap, "Regression: parent_ Retargeting (Swap)");
     run_test(test_regression_parent_retarget_move, "Regression: parent_ Retargeting (Move)");
+    run_test(test_relocation_non_assignable, "Relocation Insert/Erase (Non-Assignable)");
+    run_test(test_memory_usage, "memory_usage() Accounting");
+    run_test(test_allocation_budget, "Allocation Budget (Differential)");
+    run_test(test_alignment, "Align Parameter");
+    run_test(test_sort_network, "lloyal::sort (Sorting Networks)");
+    run_test(test_relocation_algorithms, "Relocation sort/stable_sort/rotate");
+    run_test(test_compressed, "CompressedInlinedVector");
+    run_test(test_inlined_vector_ref, "InlinedVectorRef (Borrowed Buffer)");
+    run_test(test_wink_out, "Wink-Out Allocators");
+    run_test(test_poly_inlined_vector, "PolyInlinedVector");
+    run_test(test_inlined_byte_buffer, "InlinedByteBuffer");
+    run_test(test_spsc_ring, "InlinedSpscRing");
+    run_test(test_incremental_growth, "IncrementalInlinedVector");
+    run_test(test_adaptive_spill, "AdaptiveInlinedVector");
+    run_test(test_cow_inlined_vector, "CowInlinedVector");
+    run_test(test_atomic_snapshot, "AtomicInlinedVectorSnapshot");
+    run_test(test_interner, "InlinedVectorInterner");
+    run_test(test_numeric_expressions, "Numeric Expressions");
+    run_test(test_merge_insert_sorted, "merge_insert_sorted");
+    run_test(test_inlined_matrix, "InlinedMatrix");
 
 
     std::cout << "\n"; std::cout << "========================================\n"; std::cout << "            Test Summary\n"; std::cout << "========================================\n"; std::cout << "  Passed: " << passed << "/" << total << "\n";